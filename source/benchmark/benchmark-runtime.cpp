@@ -0,0 +1,156 @@
+// Copyright (c) 2021 Michael Fabian Dirks <info@xaymar.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "benchmark-runtime.hpp"
+#include <cstdarg>
+#include <cstdio>
+#include <stdexcept>
+
+extern "C" {
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable : 4201)
+#endif
+#include <obs-module.h>
+#include <util/base.h>
+#ifdef __linux__
+#include <obs-nix-platform.h>
+#endif
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+}
+
+#ifdef _WIN32
+#include <Windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+#ifdef __linux__
+#include <X11/Xlib.h>
+#endif
+
+namespace {
+	int _log_level = LOG_WARNING;
+
+	void log_handler(int level, const char* format, va_list args, void*)
+	{
+		if (level > _log_level) {
+			return;
+		}
+		vfprintf(stderr, format, args);
+		fprintf(stderr, "\n");
+	}
+} // namespace
+
+streamfx::benchmark::runtime::runtime(std::string const& module_path, std::string const& data_path, uint32_t width,
+									  uint32_t height, uint32_t fps_num, uint32_t fps_den)
+	: _display(nullptr), _module(nullptr)
+{
+	base_set_log_handler(log_handler, nullptr);
+
+#ifdef __linux__
+	_display = XOpenDisplay(nullptr);
+	if (!_display) {
+		throw std::runtime_error("Failed to open an X display, try running with xvfb-run.");
+	}
+	obs_set_nix_platform(OBS_NIX_PLATFORM_X11_GLX);
+	obs_set_nix_platform_display(_display);
+#endif
+
+	try {
+		if (!obs_startup("en-US", nullptr, nullptr)) {
+			throw std::runtime_error("Failed to start libOBS.");
+		}
+
+		obs_video_info ovi = {};
+		ovi.graphics_module = "libobs-opengl";
+		ovi.fps_num         = fps_num;
+		ovi.fps_den         = fps_den;
+		ovi.base_width      = width;
+		ovi.base_height     = height;
+		ovi.output_width    = width;
+		ovi.output_height   = height;
+		ovi.output_format   = VIDEO_FORMAT_NV12;
+		ovi.colorspace      = VIDEO_CS_709;
+		ovi.range           = VIDEO_RANGE_PARTIAL;
+		ovi.gpu_conversion  = true;
+		ovi.scale_type      = OBS_SCALE_BILINEAR;
+		if (obs_reset_video(&ovi) != OBS_VIDEO_SUCCESS) {
+			throw std::runtime_error("Failed to initialize the OpenGL backend.");
+		}
+
+		if (obs_open_module(&_module, module_path.c_str(), data_path.c_str()) != MODULE_SUCCESS) {
+			throw std::runtime_error("Failed to open '" + module_path + "'.");
+		}
+		if (!obs_init_module(_module)) {
+			throw std::runtime_error("Failed to load '" + module_path + "'.");
+		}
+	} catch (...) {
+		obs_shutdown();
+#ifdef __linux__
+		XCloseDisplay(reinterpret_cast<Display*>(_display));
+#endif
+		throw;
+	}
+}
+
+streamfx::benchmark::runtime::~runtime()
+{
+	// Also unloads the module.
+	obs_shutdown();
+
+#ifdef __linux__
+	XCloseDisplay(reinterpret_cast<Display*>(_display));
+#endif
+}
+
+obs_module_t* streamfx::benchmark::runtime::module()
+{
+	return _module;
+}
+
+void streamfx::benchmark::runtime::set_log_level(int level)
+{
+	_log_level = level;
+}
+
+uint64_t streamfx::benchmark::peak_memory_usage()
+{
+#ifdef _WIN32
+	PROCESS_MEMORY_COUNTERS pmc = {};
+	if (GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) {
+		return pmc.PeakWorkingSetSize;
+	}
+	return 0;
+#else
+	rusage usage = {};
+	if (getrusage(RUSAGE_SELF, &usage) != 0) {
+		return 0;
+	}
+#ifdef __APPLE__
+	return static_cast<uint64_t>(usage.ru_maxrss); // Bytes on MacOS.
+#else
+	return static_cast<uint64_t>(usage.ru_maxrss) * 1024; // Kilobytes everywhere else.
+#endif
+#endif
+}
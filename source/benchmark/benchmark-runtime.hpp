@@ -0,0 +1,61 @@
+// Copyright (c) 2021 Michael Fabian Dirks <info@xaymar.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+#include <cinttypes>
+#include <string>
+
+extern "C" {
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable : 4201)
+#endif
+#include <obs.h>
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+}
+
+namespace streamfx::benchmark {
+	/** libOBS with the OpenGL backend and the StreamFX module loaded into it.
+	 *
+	 * Only one may exist at a time. If any step fails, everything set up so far is torn down again and a
+	 * std::runtime_error is thrown. On Linux this needs an X display, which Xvfb provides on machines without one.
+	 */
+	class runtime {
+		void*         _display;
+		obs_module_t* _module;
+
+		public:
+		runtime(std::string const& module_path, std::string const& data_path, uint32_t width, uint32_t height,
+				uint32_t fps_num, uint32_t fps_den);
+		~runtime();
+
+		/** The loaded StreamFX module. */
+		obs_module_t* module();
+
+		public:
+		/** Messages with a level above this are not written to stderr. Defaults to LOG_WARNING. */
+		static void set_log_level(int level);
+	};
+
+	/** Highest amount of memory this process has had resident so far, in bytes. */
+	uint64_t peak_memory_usage();
+} // namespace streamfx::benchmark
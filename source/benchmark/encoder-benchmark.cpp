@@ -0,0 +1,537 @@
+// Copyright (c) 2021 Michael Fabian Dirks <info@xaymar.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Offline benchmark for the encoders of StreamFX.
+//
+// Feeds frames from a Y4M or raw YUV file to one of the encoders as fast as it accepts them, through a video output
+// that is not tied to rendering. The result is written to stdout as a single line of JSON, which includes the per-stage
+// timings that the encoder recorded. The encoders also log those to stderr when they are destroyed.
+//
+// Example:
+//   xvfb-run -a ./StreamFX-EncoderBenchmark --input input.y4m --encoder streamfx-aom-av1 > result.json
+
+#include "benchmark-runtime.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+extern "C" {
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable : 4201)
+#endif
+#include <obs.h>
+#include <util/platform.h>
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+}
+
+#define ST_OUTPUT_ID "streamfx-benchmark-output"
+#define ST_CACHE_SIZE 16
+
+namespace {
+	struct plane {
+		std::size_t width; // in bytes
+		std::size_t height;
+	};
+
+	class input {
+		std::ifstream _stream;
+		bool          _y4m;
+
+		public:
+		video_format       format;
+		uint32_t           width;
+		uint32_t           height;
+		uint32_t           fps_num;
+		uint32_t           fps_den;
+		std::vector<plane> planes;
+
+		public:
+		input(std::string const& path, std::string const& raw_format, uint32_t raw_width, uint32_t raw_height,
+			  uint32_t raw_fps_num, uint32_t raw_fps_den)
+			: _stream(path, std::ios::binary), _y4m(false), format(VIDEO_FORMAT_I420), width(raw_width),
+			  height(raw_height), fps_num(raw_fps_num), fps_den(raw_fps_den)
+		{
+			if (!_stream) {
+				throw std::runtime_error("Failed to open '" + path + "'.");
+			}
+
+			// Y4M files start with a single line of space separated parameters.
+			std::string chroma = raw_format;
+			if (path.size() > 4 && path.substr(path.size() - 4) == ".y4m") {
+				_y4m = true;
+				chroma = "420";
+
+				std::string header;
+				std::getline(_stream, header);
+				if (header.compare(0, 9, "YUV4MPEG2") != 0) {
+					throw std::runtime_error("'" + path + "' is not a Y4M file.");
+				}
+				std::size_t pos = 9;
+				while (pos < header.size()) {
+					std::size_t end   = header.find(' ', pos + 1);
+					std::string token = header.substr(pos + 1, end - pos - 1);
+					if (!token.empty()) {
+						if (token[0] == 'W') {
+							width = static_cast<uint32_t>(std::strtoul(token.c_str() + 1, nullptr, 10));
+						} else if (token[0] == 'H') {
+							height = static_cast<uint32_t>(std::strtoul(token.c_str() + 1, nullptr, 10));
+						} else if (token[0] == 'F') {
+							sscanf(token.c_str() + 1, "%" SCNu32 ":%" SCNu32, &fps_num, &fps_den);
+						} else if (token[0] == 'C') {
+							chroma = token.substr(1, 3);
+							if (token.find("p10") != std::string::npos || token.find("p12") != std::string::npos) {
+								throw std::runtime_error("High bit depth Y4M files are not supported.");
+							}
+						}
+					}
+					pos = end;
+				}
+			}
+
+			if ((chroma == "420") || (chroma == "i420")) {
+				format = VIDEO_FORMAT_I420;
+			} else if (chroma == "nv12") {
+				format = VIDEO_FORMAT_NV12;
+			} else if ((chroma == "422") || (chroma == "i422")) {
+				format = VIDEO_FORMAT_I422;
+			} else if ((chroma == "444") || (chroma == "i444")) {
+				format = VIDEO_FORMAT_I444;
+			} else {
+				throw std::runtime_error("Unsupported pixel format '" + chroma + "'.");
+			}
+			if ((width == 0) || (height == 0) || (fps_num == 0) || (fps_den == 0)) {
+				throw std::runtime_error("Size and frame rate are required for raw input.");
+			}
+
+			std::size_t half_width  = (width + 1) / 2;
+			std::size_t half_height = (height + 1) / 2;
+			planes.push_back({width, height});
+			switch (format) {
+			case VIDEO_FORMAT_I420:
+				planes.push_back({half_width, half_height});
+				planes.push_back({half_width, half_height});
+				break;
+			case VIDEO_FORMAT_NV12:
+				planes.push_back({half_width * 2, half_height});
+				break;
+			case VIDEO_FORMAT_I422:
+				planes.push_back({half_width, height});
+				planes.push_back({half_width, height});
+				break;
+			default:
+				planes.push_back({width, height});
+				planes.push_back({width, height});
+				break;
+			}
+		}
+
+		std::size_t frame_size()
+		{
+			std::size_t size = 0;
+			for (auto& p : planes) {
+				size += p.width * p.height;
+			}
+			return size;
+		}
+
+		bool read(std::vector<uint8_t>& buffer)
+		{
+			if (_y4m) {
+				std::string header;
+				if (!std::getline(_stream, header) || (header.compare(0, 5, "FRAME") != 0)) {
+					return false;
+				}
+			}
+			buffer.resize(frame_size());
+			_stream.read(reinterpret_cast<char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+			return static_cast<std::size_t>(_stream.gcount()) == buffer.size();
+		}
+	};
+
+	// Counters shared with the benchmark output and the raw video callback, which run on other threads.
+	struct counters {
+		std::atomic<uint64_t> processed{0};
+		std::atomic<uint64_t> packets{0};
+		std::atomic<uint64_t> keyframes{0};
+		std::atomic<uint64_t> bytes{0};
+		std::atomic<int64_t>  last_packet{0}; // Nanoseconds since the first frame was submitted.
+
+		std::chrono::high_resolution_clock::time_point start;
+
+		int64_t elapsed()
+		{
+			return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::high_resolution_clock::now()
+																		 - start)
+				.count();
+		}
+	} _counters;
+
+	// Minimal encoded output, which only counts what the encoder produces.
+	void register_output()
+	{
+		obs_output_info info = {};
+		info.id              = ST_OUTPUT_ID;
+		info.flags           = OBS_OUTPUT_VIDEO | OBS_OUTPUT_ENCODED;
+		info.get_name        = [](void*) { return "Benchmark Output"; };
+		info.create          = [](obs_data_t*, obs_output_t* output) -> void* { return output; };
+		info.destroy         = [](void*) {};
+		info.start = [](void* data) { return obs_output_begin_data_capture(static_cast<obs_output_t*>(data), 0); };
+		info.stop  = [](void* data, uint64_t) { obs_output_end_data_capture(static_cast<obs_output_t*>(data)); };
+		info.encoded_packet = [](void*, encoder_packet* packet) {
+			if (!packet) {
+				return;
+			}
+			_counters.packets++;
+			_counters.bytes += packet->size;
+			if (packet->keyframe) {
+				_counters.keyframes++;
+			}
+			_counters.last_packet = _counters.elapsed();
+		};
+		obs_register_output(&info);
+	}
+
+	// Per-stage timings of the encoder, in microseconds.
+	struct stage {
+		std::string name;
+		uint64_t    count;
+		double      average;
+		double      p50;
+		double      p95;
+		double      p99;
+		double      p999;
+	};
+
+	typedef void (*profiler_callback_t)(void* data, const char* name, uint64_t count, double average_us,
+										double p50_us, double p95_us, double p99_us, double p999_us);
+	typedef void (*enumerate_profilers_t)(profiler_callback_t callback, void* data);
+
+	// Encoders publish their timings when they are destroyed, and the module exports a hook to read them.
+	std::vector<stage> read_stages(obs_module_t* module)
+	{
+		std::vector<stage> stages;
+		void*              symbol = os_dlsym(obs_get_module_lib(module), "streamfx_enumerate_profilers");
+		if (auto enumerate = reinterpret_cast<enumerate_profilers_t>(symbol); enumerate) {
+			enumerate(
+				[](void* data, const char* name, uint64_t count, double average, double p50, double p95, double p99,
+				   double p999) {
+					static_cast<std::vector<stage>*>(data)->push_back({name, count, average, p50, p95, p99, p999});
+				},
+				&stages);
+		}
+		return stages;
+	}
+
+	std::string stages_to_json(std::vector<stage> const& stages)
+	{
+		std::string json = "{";
+		for (auto const& s : stages) {
+			char buffer[256];
+			snprintf(buffer, sizeof(buffer),
+					 "%s\"%s\":{\"count\":%" PRIu64 ",\"mean_us\":%.1f,\"p50_us\":%.1f,\"p95_us\":%.1f,"
+					 "\"p99_us\":%.1f,\"p999_us\":%.1f}",
+					 (json.size() > 1) ? "," : "", s.name.c_str(), s.count, s.average, s.p50, s.p95, s.p99, s.p999);
+			json += buffer;
+		}
+		return json + "}";
+	}
+
+	void on_raw_frame(void*, video_data*)
+	{
+		_counters.processed++;
+	}
+
+	void copy_frame(input& in, std::vector<uint8_t> const& buffer, video_frame& frame)
+	{
+		const uint8_t* ptr = buffer.data();
+		for (std::size_t idx = 0; idx < in.planes.size(); idx++) {
+			auto const& p = in.planes[idx];
+			for (std::size_t row = 0; row < p.height; row++) {
+				std::memcpy(frame.data[idx] + row * frame.linesize[idx], ptr, p.width);
+				ptr += p.width;
+			}
+		}
+	}
+
+	double percentile(std::vector<double> values, double p)
+	{
+		if (values.empty()) {
+			return 0.;
+		}
+		std::sort(values.begin(), values.end());
+		std::size_t idx = static_cast<std::size_t>(p * static_cast<double>(values.size() - 1) + 0.5);
+		return values[std::min(idx, values.size() - 1)];
+	}
+
+	void usage(const char* self)
+	{
+		fprintf(stderr,
+				"Usage: %s --input <file> --encoder <id> [options]\n"
+				"  --input <file>          Y4M file, or raw YUV file with --size and --fps\n"
+				"  --encoder <id>          Encoder to test, see --list\n"
+				"  --settings <json>       Encoder settings as JSON, or @file to read them from a file\n"
+				"  --frames <count>        Frames to encode, the input is looped if shorter (default: length of input)\n"
+				"  --preload <count>       Frames to keep in memory, larger inputs are cut short (default: 120)\n"
+				"  --size <WxH>            Size of raw input\n"
+				"  --fps <num/den>         Frame rate of raw input\n"
+				"  --format <format>       Format of raw input: i420, nv12, i422 or i444 (default: i420)\n"
+				"  --module <file>         StreamFX module to load (default: %s)\n"
+				"  --data <path>           StreamFX data directory (default: %s)\n"
+				"  --list                  List the available encoders and exit\n"
+				"  --verbose               Show all libOBS log messages\n",
+				self, STREAMFX_BENCHMARK_MODULE, STREAMFX_BENCHMARK_DATA);
+	}
+} // namespace
+
+int main(int argc, const char* argv[])
+{
+	std::string module_path = STREAMFX_BENCHMARK_MODULE;
+	std::string data_path   = STREAMFX_BENCHMARK_DATA;
+	std::string input_path;
+	std::string encoder_id;
+	std::string settings_json;
+	std::string raw_format = "i420";
+	uint32_t    raw_width = 0, raw_height = 0, raw_fps_num = 0, raw_fps_den = 1;
+	std::size_t frames  = 0;
+	std::size_t preload = 120;
+	bool        list    = false;
+
+	// Show the per-stage timings of the encoders.
+	streamfx::benchmark::runtime::set_log_level(LOG_INFO);
+
+	for (int idx = 1; idx < argc; idx++) {
+		std::string arg   = argv[idx];
+		const char* value = (idx + 1 < argc) ? argv[idx + 1] : nullptr;
+		if (arg == "--verbose") {
+			streamfx::benchmark::runtime::set_log_level(LOG_DEBUG);
+			continue;
+		} else if (arg == "--list") {
+			list = true;
+			continue;
+		} else if (!value) {
+			usage(argv[0]);
+			return 1;
+		}
+
+		if (arg == "--input") {
+			input_path = value;
+		} else if (arg == "--encoder") {
+			encoder_id = value;
+		} else if (arg == "--settings") {
+			settings_json = value;
+		} else if (arg == "--frames") {
+			frames = std::strtoull(value, nullptr, 10);
+		} else if (arg == "--preload") {
+			preload = std::max<std::size_t>(std::strtoull(value, nullptr, 10), 1);
+		} else if (arg == "--size") {
+			if (sscanf(value, "%" SCNu32 "x%" SCNu32, &raw_width, &raw_height) != 2) {
+				usage(argv[0]);
+				return 1;
+			}
+		} else if (arg == "--fps") {
+			if (sscanf(value, "%" SCNu32 "/%" SCNu32, &raw_fps_num, &raw_fps_den) < 1) {
+				usage(argv[0]);
+				return 1;
+			}
+		} else if (arg == "--format") {
+			raw_format = value;
+		} else if (arg == "--module") {
+			module_path = value;
+		} else if (arg == "--data") {
+			data_path = value;
+		} else {
+			usage(argv[0]);
+			return 1;
+		}
+		idx++;
+	}
+	if (!list && (input_path.empty() || encoder_id.empty())) {
+		usage(argv[0]);
+		return 1;
+	}
+
+	try {
+		if (list) {
+			streamfx::benchmark::runtime rt{module_path, data_path, 1280, 720, 60, 1};
+			const char*                  id = nullptr;
+			for (std::size_t idx = 0; obs_enum_encoder_types(idx, &id); idx++) {
+				if ((strncmp(id, "streamfx-", 9) == 0) && (obs_get_encoder_type(id) == OBS_ENCODER_VIDEO)) {
+					printf("%s\n", id);
+				}
+			}
+			return 0;
+		}
+
+		// Load the input into memory, so that reading it does not count towards the encoding time.
+		input                             in{input_path, raw_format, raw_width, raw_height, raw_fps_num, raw_fps_den};
+		std::vector<std::vector<uint8_t>> buffers;
+		while (buffers.size() < preload) {
+			std::vector<uint8_t> buffer;
+			if (!in.read(buffer)) {
+				break;
+			}
+			buffers.push_back(std::move(buffer));
+		}
+		if (buffers.empty()) {
+			throw std::runtime_error("'" + input_path + "' contains no frames.");
+		}
+		if (frames == 0) {
+			frames = buffers.size();
+		}
+
+		streamfx::benchmark::runtime rt{module_path, data_path, in.width, in.height, in.fps_num, in.fps_den};
+		register_output();
+
+		// A video output that is not tied to rendering, so frames are encoded as fast as the encoder accepts them.
+		video_output_info voi = {};
+		voi.name              = "Benchmark";
+		voi.format            = in.format;
+		voi.fps_num           = in.fps_num;
+		voi.fps_den           = in.fps_den;
+		voi.width             = in.width;
+		voi.height            = in.height;
+		voi.cache_size        = ST_CACHE_SIZE;
+		voi.colorspace        = VIDEO_CS_709;
+		voi.range             = VIDEO_RANGE_PARTIAL;
+		video_t* video        = nullptr;
+		if (video_output_open(&video, &voi) != VIDEO_OUTPUT_SUCCESS) {
+			throw std::runtime_error("Failed to open the video output.");
+		}
+
+		obs_data_t* settings = nullptr;
+		if (settings_json.empty()) {
+			settings = obs_data_create();
+		} else if (settings_json[0] == '@') {
+			settings = obs_data_create_from_json_file(settings_json.c_str() + 1);
+		} else {
+			settings = obs_data_create_from_json(settings_json.c_str());
+		}
+		if (!settings) {
+			video_output_close(video);
+			throw std::runtime_error("Failed to parse the encoder settings.");
+		}
+
+		obs_encoder_t* encoder = obs_video_encoder_create(encoder_id.c_str(), "Benchmark", settings, nullptr);
+		obs_output_t*  output  = obs_output_create(ST_OUTPUT_ID, "Benchmark", nullptr, nullptr);
+		obs_data_release(settings);
+		if (!encoder || !output) {
+			obs_output_release(output);
+			obs_encoder_release(encoder);
+			video_output_close(video);
+			throw std::runtime_error("Failed to create encoder '" + encoder_id + "'.");
+		}
+		obs_encoder_set_video(encoder, video);
+		obs_output_set_video_encoder(output, encoder);
+
+		std::vector<double> copy_times;
+		copy_times.reserve(frames);
+		bool started = obs_output_start(output);
+		if (started) {
+			video_output_connect(video, nullptr, on_raw_frame, nullptr);
+
+			_counters.start    = std::chrono::high_resolution_clock::now();
+			uint64_t timestamp = 0;
+			uint64_t interval  = 1000000000ull * in.fps_den / in.fps_num;
+			for (std::size_t idx = 0; idx < frames; idx++) {
+				// Locking a frame while the cache is full silently duplicates the previous one instead.
+				while ((idx - _counters.processed) >= (ST_CACHE_SIZE - 1)) {
+					std::this_thread::yield();
+				}
+
+				video_frame frame;
+				if (!video_output_lock_frame(video, &frame, 1, timestamp)) {
+					break;
+				}
+				auto begin = std::chrono::high_resolution_clock::now();
+				copy_frame(in, buffers[idx % buffers.size()], frame);
+				copy_times.push_back(
+					std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - begin)
+						.count());
+				video_output_unlock_frame(video);
+				timestamp += interval;
+			}
+
+			// Wait for the encoder to catch up, and then for any delayed packets.
+			while (_counters.processed < copy_times.size()) {
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			}
+			for (uint64_t packets = 0; packets != _counters.packets;) {
+				packets = _counters.packets;
+				std::this_thread::sleep_for(std::chrono::milliseconds(250));
+			}
+
+			video_output_disconnect(video, on_raw_frame, nullptr);
+			obs_output_stop(output);
+		}
+
+		// Releasing the encoder logs and publishes its per-stage timings.
+		obs_output_release(output);
+		obs_encoder_release(encoder);
+		video_output_close(video);
+
+		if (!started) {
+			throw std::runtime_error("Failed to start encoder '" + encoder_id + "'.");
+		}
+
+		// The encoder is only destroyed once the output has fully stopped, which may happen on another thread.
+		std::vector<stage> stages;
+		for (auto end = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+			 stages.empty() && (std::chrono::steady_clock::now() < end);) {
+			stages = read_stages(rt.module());
+			if (stages.empty()) {
+				std::this_thread::sleep_for(std::chrono::milliseconds(10));
+			}
+		}
+
+		double seconds = static_cast<double>(std::max<int64_t>(_counters.last_packet, 1)) / 1000000000.;
+		double copy    = 0.;
+		for (auto time : copy_times) {
+			copy += time;
+		}
+		copy /= static_cast<double>(std::max<std::size_t>(copy_times.size(), 1));
+		double duration = static_cast<double>(copy_times.size()) * in.fps_den / in.fps_num;
+
+		printf("{\"encoder\":\"%s\",\"width\":%" PRIu32 ",\"height\":%" PRIu32 ",\"frames\":%zu,\"packets\":%" PRIu64
+			   ",\"keyframes\":%" PRIu64 ",\"seconds\":%.4f,\"fps\":%.2f,\"bitrate_kbps\":%.1f,\"copy_ms_mean\":%.4f,"
+			   "\"copy_ms_p95\":%.4f,\"peak_memory_bytes\":%" PRIu64 ",\"stages\":%s}\n",
+			   encoder_id.c_str(), in.width, in.height, copy_times.size(), _counters.packets.load(),
+			   _counters.keyframes.load(), seconds, static_cast<double>(copy_times.size()) / seconds,
+			   static_cast<double>(_counters.bytes) * 8. / duration / 1000., copy, percentile(copy_times, .95),
+			   streamfx::benchmark::peak_memory_usage(), stages_to_json(stages).c_str());
+		fflush(stdout);
+	} catch (std::exception const& ex) {
+		fprintf(stderr, "%s\n", ex.what());
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,516 @@
+// Copyright (c) 2021 Michael Fabian Dirks <info@xaymar.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Headless render benchmark for the filters of StreamFX.
+//
+// Starts libOBS with the OpenGL backend, loads the StreamFX module from the build tree, and renders every filter on
+// top of a synthetic noise source at several resolutions. Each result is written to stdout as a single line of JSON,
+// everything else goes to stderr.
+//
+// On Linux this runs without a GPU on Mesa llvmpipe, but libobs-opengl still needs an X server:
+//   LIBGL_ALWAYS_SOFTWARE=1 xvfb-run -a ./StreamFX-RenderBenchmark > results.jsonl
+
+#include "benchmark-runtime.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+extern "C" {
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable : 4201)
+#endif
+#include <obs.h>
+#include <util/bmem.h>
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+}
+
+#define ST_PATTERN_ID "streamfx-benchmark-pattern"
+#define ST_KEY_WIDTH "Width"
+#define ST_KEY_HEIGHT "Height"
+
+namespace {
+	struct allocation_counter {
+		std::atomic<uint64_t> count{0};
+		std::atomic<uint64_t> bytes{0};
+
+		void track(std::size_t size)
+		{
+			count.fetch_add(1, std::memory_order_relaxed);
+			bytes.fetch_add(size, std::memory_order_relaxed);
+		}
+	};
+
+	// Allocations made through operator new. On Linux and MacOS this also covers the StreamFX module, as the
+	// replacement in the executable takes precedence for all loaded libraries. On Windows it only covers this file.
+	allocation_counter _new_allocations;
+
+	// Allocations made through bmalloc, which covers libOBS and the graphics subsystem on all platforms.
+	allocation_counter _obs_allocations;
+
+	void* counted_malloc(std::size_t size)
+	{
+		_obs_allocations.track(size);
+		return std::malloc(size);
+	}
+
+	void* counted_realloc(void* ptr, std::size_t size)
+	{
+		_obs_allocations.track(size);
+		return std::realloc(ptr, size);
+	}
+
+	void counted_free(void* ptr)
+	{
+		std::free(ptr);
+	}
+} // namespace
+
+void* operator new(std::size_t size)
+{
+	_new_allocations.track(size);
+	if (void* ptr = std::malloc(size ? size : 1); ptr) {
+		return ptr;
+	}
+	throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+	std::free(ptr);
+}
+
+namespace {
+	// Synthetic input source, which alternates between two noise textures every frame. This keeps filters from
+	// reusing their previous output, so that the full render path is measured every frame.
+	class pattern {
+		uint32_t      _width;
+		uint32_t      _height;
+		gs_texture_t* _textures[2];
+		std::size_t   _current;
+
+		public:
+		pattern(obs_data_t* settings) : _textures(), _current(0)
+		{
+			_width  = static_cast<uint32_t>(obs_data_get_int(settings, ST_KEY_WIDTH));
+			_height = static_cast<uint32_t>(obs_data_get_int(settings, ST_KEY_HEIGHT));
+
+			std::mt19937          generator(_width * _height);
+			std::vector<uint32_t> pixels(static_cast<std::size_t>(_width) * _height);
+			const uint8_t*        data = reinterpret_cast<const uint8_t*>(pixels.data());
+			obs_enter_graphics();
+			for (auto& texture : _textures) {
+				for (auto& pixel : pixels) {
+					pixel = generator() | 0xFF000000;
+				}
+				texture = gs_texture_create(_width, _height, GS_RGBA, 1, &data, 0);
+			}
+			obs_leave_graphics();
+		}
+
+		~pattern()
+		{
+			obs_enter_graphics();
+			for (auto& texture : _textures) {
+				gs_texture_destroy(texture);
+			}
+			obs_leave_graphics();
+		}
+
+		uint32_t width()
+		{
+			return _width;
+		}
+
+		uint32_t height()
+		{
+			return _height;
+		}
+
+		void tick()
+		{
+			_current = (_current + 1) % 2;
+		}
+
+		void render()
+		{
+			obs_source_draw(_textures[_current], 0, 0, 0, 0, false);
+		}
+	};
+
+	void register_pattern()
+	{
+		obs_source_info info = {};
+		info.id              = ST_PATTERN_ID;
+		info.type            = OBS_SOURCE_TYPE_INPUT;
+		info.output_flags    = OBS_SOURCE_VIDEO;
+		info.get_name        = [](void*) { return "Benchmark Pattern"; };
+		info.create          = [](obs_data_t* settings, obs_source_t*) -> void* { return new pattern(settings); };
+		info.destroy         = [](void* data) { delete reinterpret_cast<pattern*>(data); };
+		info.get_width       = [](void* data) { return reinterpret_cast<pattern*>(data)->width(); };
+		info.get_height      = [](void* data) { return reinterpret_cast<pattern*>(data)->height(); };
+		info.video_tick      = [](void* data, float) { reinterpret_cast<pattern*>(data)->tick(); };
+		info.video_render    = [](void* data, gs_effect_t*) { reinterpret_cast<pattern*>(data)->render(); };
+		obs_register_source(&info);
+	}
+
+	struct test_case {
+		std::string                      name;
+		std::string                      id;
+		std::function<void(obs_data_t*)> configure;
+	};
+
+	std::vector<test_case> generate_cases(std::string const& data_path)
+	{
+		std::vector<test_case> cases;
+
+		// Unfiltered source, as the baseline for all other results.
+		cases.push_back({"none", "", [](obs_data_t*) {}});
+
+		// Blur
+		std::pair<const char*, double> blurs[] = {
+			{"box", 16.},
+			{"box_linear", 16.},
+			{"gaussian", 16.},
+			{"gaussian_linear", 16.},
+			{"dual_filtering", 4.},
+			{"dual_filtering_radius", 64.},
+			{"pyramid", 64.},
+		};
+		for (auto blur : blurs) {
+			cases.push_back({std::string("blur.") + blur.first, "streamfx-filter-blur", [blur](obs_data_t* settings) {
+								 obs_data_set_string(settings, "Filter.Blur.Type", blur.first);
+								 obs_data_set_string(settings, "Filter.Blur.SubType", "area");
+								 obs_data_set_double(settings, "Filter.Blur.Size", blur.second);
+							 }});
+		}
+
+		// SDF Effects
+		cases.push_back({"sdf_effects", "streamfx-filter-sdf-effects", [](obs_data_t* settings) {
+							 obs_data_set_bool(settings, "Filter.SDFEffects.Shadow.Outer", true);
+							 obs_data_set_bool(settings, "Filter.SDFEffects.Glow.Outer", true);
+							 obs_data_set_bool(settings, "Filter.SDFEffects.Outline", true);
+						 }});
+
+		// Color Grade
+		cases.push_back({"color_grade", "streamfx-filter-color-grade", [](obs_data_t*) {}});
+
+		// Transform
+		cases.push_back({"transform", "streamfx-filter-transform",
+						 [](obs_data_t* settings) { obs_data_set_double(settings, "Rotation.X", 30.); }});
+
+		// Displacement
+		cases.push_back({"displacement", "streamfx-filter-displacement", [](obs_data_t*) {}});
+
+		// Dynamic Mask
+		cases.push_back({"dynamic_mask", "streamfx-filter-dynamic-mask", [](obs_data_t*) {}});
+
+		// Shader
+		std::string shader = data_path + "/examples/shaders/filter/swirl.effect";
+		cases.push_back({"shader", "streamfx-filter-shader", [shader](obs_data_t* settings) {
+							 obs_data_set_string(settings, "Shader.Shader.File", shader.c_str());
+						 }});
+
+		return cases;
+	}
+
+	void wait_for_tick()
+	{
+		uint64_t last = obs_get_video_frame_time();
+		while (obs_get_video_frame_time() == last) {
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+	}
+
+	struct frame_result {
+		double   milliseconds;
+		uint64_t allocations;
+		uint64_t bytes;
+	};
+
+	class renderer {
+		gs_texrender_t* _output;
+		gs_texrender_t* _sync;
+		gs_stagesurf_t* _stage;
+		uint32_t        _width;
+		uint32_t        _height;
+
+		public:
+		renderer(uint32_t width, uint32_t height) : _width(width), _height(height)
+		{
+			obs_enter_graphics();
+			_output = gs_texrender_create(GS_RGBA, GS_ZS_NONE);
+			_sync   = gs_texrender_create(GS_RGBA, GS_ZS_NONE);
+			_stage  = gs_stagesurface_create(1, 1, GS_RGBA);
+			obs_leave_graphics();
+		}
+
+		~renderer()
+		{
+			obs_enter_graphics();
+			gs_stagesurface_destroy(_stage);
+			gs_texrender_destroy(_sync);
+			gs_texrender_destroy(_output);
+			obs_leave_graphics();
+		}
+
+		frame_result render(obs_source_t* source)
+		{
+			obs_enter_graphics();
+
+			uint64_t allocations = _new_allocations.count + _obs_allocations.count;
+			uint64_t bytes       = _new_allocations.bytes + _obs_allocations.bytes;
+			auto     begin       = std::chrono::high_resolution_clock::now();
+
+			gs_blend_state_push();
+			gs_reset_blend_state();
+
+			gs_texrender_reset(_output);
+			if (gs_texrender_begin(_output, _width, _height)) {
+				vec4 black;
+				vec4_zero(&black);
+				gs_clear(GS_CLEAR_COLOR, &black, 0, 0);
+				gs_ortho(0, static_cast<float>(_width), 0, static_cast<float>(_height), -1., 1.);
+				obs_source_video_render(source);
+				gs_texrender_end(_output);
+			}
+
+			// Reduce the output to a single texel and read it back, which waits for the GPU to finish all the work
+			// queued so far. The cost of this is included in the "none" result.
+			gs_texrender_reset(_sync);
+			if (gs_texrender_begin(_sync, 1, 1)) {
+				gs_texture_t* texture = gs_texrender_get_texture(_output);
+				gs_effect_t*  effect  = obs_get_base_effect(OBS_EFFECT_DEFAULT);
+				gs_ortho(0, 1., 0, 1., -1., 1.);
+				gs_effect_set_texture(gs_effect_get_param_by_name(effect, "image"), texture);
+				while (gs_effect_loop(effect, "Draw")) {
+					gs_draw_sprite(texture, 0, 1, 1);
+				}
+				gs_texrender_end(_sync);
+			}
+			gs_stage_texture(_stage, gs_texrender_get_texture(_sync));
+			uint8_t* data;
+			uint32_t linesize;
+			if (gs_stagesurface_map(_stage, &data, &linesize)) {
+				gs_stagesurface_unmap(_stage);
+			}
+
+			gs_blend_state_pop();
+
+			auto end = std::chrono::high_resolution_clock::now();
+
+			frame_result result;
+			result.milliseconds = std::chrono::duration<double, std::milli>(end - begin).count();
+			result.allocations  = _new_allocations.count + _obs_allocations.count - allocations;
+			result.bytes        = _new_allocations.bytes + _obs_allocations.bytes - bytes;
+
+			obs_leave_graphics();
+			return result;
+		}
+	};
+
+	double percentile(std::vector<double> values, double p)
+	{
+		if (values.empty()) {
+			return 0.;
+		}
+		std::sort(values.begin(), values.end());
+		std::size_t idx = static_cast<std::size_t>(p * static_cast<double>(values.size() - 1) + 0.5);
+		return values[std::min(idx, values.size() - 1)];
+	}
+
+	bool run_case(test_case const& tc, uint32_t width, uint32_t height, std::size_t warmup, std::size_t frames)
+	{
+		obs_data_t* settings = obs_data_create();
+		obs_data_set_int(settings, ST_KEY_WIDTH, width);
+		obs_data_set_int(settings, ST_KEY_HEIGHT, height);
+		obs_source_t* input = obs_source_create_private(ST_PATTERN_ID, "Benchmark Input", settings);
+		obs_data_release(settings);
+		if (!input) {
+			fprintf(stderr, "Failed to create the benchmark input.\n");
+			return false;
+		}
+
+		obs_source_t* filter = nullptr;
+		if (!tc.id.empty()) {
+			obs_data_t* filter_settings = obs_data_create();
+			tc.configure(filter_settings);
+			filter = obs_source_create_private(tc.id.c_str(), tc.name.c_str(), filter_settings);
+			obs_data_release(filter_settings);
+			if (!filter) {
+				fprintf(stderr, "Filter '%s' is not available, skipping.\n", tc.id.c_str());
+				obs_source_release(input);
+				return false;
+			}
+			obs_source_filter_add(input, filter);
+		}
+		obs_source_inc_showing(input);
+
+		std::vector<frame_result> results;
+		results.reserve(frames);
+		{
+			renderer rdr{width, height};
+			for (std::size_t frame = 0; frame < (warmup + frames); frame++) {
+				wait_for_tick();
+				auto result = rdr.render(input);
+				if (frame >= warmup) {
+					results.push_back(result);
+				}
+			}
+		}
+
+		obs_source_dec_showing(input);
+		if (filter) {
+			obs_source_filter_remove(input, filter);
+			obs_source_release(filter);
+		}
+		obs_source_release(input);
+
+		std::vector<double> times;
+		uint64_t            allocations = 0;
+		uint64_t            bytes       = 0;
+		for (auto& result : results) {
+			times.push_back(result.milliseconds);
+			allocations += result.allocations;
+			bytes += result.bytes;
+		}
+		double mean = 0.;
+		for (auto time : times) {
+			mean += time;
+		}
+		mean /= static_cast<double>(std::max<std::size_t>(times.size(), 1));
+
+		printf("{\"case\":\"%s\",\"width\":%" PRIu32 ",\"height\":%" PRIu32 ",\"frames\":%zu,\"ms_mean\":%.4f,"
+			   "\"ms_min\":%.4f,\"ms_p50\":%.4f,\"ms_p95\":%.4f,\"ms_max\":%.4f,\"allocations_per_frame\":%.2f,"
+			   "\"bytes_per_frame\":%.1f}\n",
+			   tc.name.c_str(), width, height, results.size(), mean, percentile(times, 0.), percentile(times, .5),
+			   percentile(times, .95), percentile(times, 1.),
+			   static_cast<double>(allocations) / static_cast<double>(std::max<std::size_t>(results.size(), 1)),
+			   static_cast<double>(bytes) / static_cast<double>(std::max<std::size_t>(results.size(), 1)));
+		fflush(stdout);
+		return true;
+	}
+
+	void usage(const char* self)
+	{
+		fprintf(stderr,
+				"Usage: %s [options]\n"
+				"  --module <file>         StreamFX module to load (default: %s)\n"
+				"  --data <path>           StreamFX data directory (default: %s)\n"
+				"  --resolution <WxH>      Resolution to test, can be repeated (default: 1280x720, 1920x1080, 3840x2160)\n"
+				"  --filter <text>         Only run cases whose name contains the text\n"
+				"  --warmup <count>        Frames to render before measuring (default: 30)\n"
+				"  --frames <count>        Frames to measure (default: 120)\n"
+				"  --verbose               Show all libOBS log messages\n",
+				self, STREAMFX_BENCHMARK_MODULE, STREAMFX_BENCHMARK_DATA);
+	}
+} // namespace
+
+int main(int argc, const char* argv[])
+{
+	std::string                                module_path = STREAMFX_BENCHMARK_MODULE;
+	std::string                                data_path   = STREAMFX_BENCHMARK_DATA;
+	std::vector<std::pair<uint32_t, uint32_t>> resolutions;
+	std::string                                filter;
+	std::size_t                                warmup = 30;
+	std::size_t                                frames = 120;
+
+	for (int idx = 1; idx < argc; idx++) {
+		std::string arg   = argv[idx];
+		const char* value = (idx + 1 < argc) ? argv[idx + 1] : nullptr;
+		if (arg == "--verbose") {
+			streamfx::benchmark::runtime::set_log_level(LOG_DEBUG);
+			continue;
+		} else if (!value) {
+			usage(argv[0]);
+			return 1;
+		}
+
+		if (arg == "--module") {
+			module_path = value;
+		} else if (arg == "--data") {
+			data_path = value;
+		} else if (arg == "--filter") {
+			filter = value;
+		} else if (arg == "--warmup") {
+			warmup = std::strtoull(value, nullptr, 10);
+		} else if (arg == "--frames") {
+			frames = std::max<std::size_t>(std::strtoull(value, nullptr, 10), 1);
+		} else if (arg == "--resolution") {
+			unsigned int width = 0, height = 0;
+			if ((sscanf(value, "%ux%u", &width, &height) != 2) || (width == 0) || (height == 0)) {
+				usage(argv[0]);
+				return 1;
+			}
+			resolutions.emplace_back(width, height);
+		} else {
+			usage(argv[0]);
+			return 1;
+		}
+		idx++;
+	}
+	if (resolutions.empty()) {
+		resolutions = {{1280, 720}, {1920, 1080}, {3840, 2160}};
+	}
+
+	base_allocator allocator = {counted_malloc, counted_realloc, counted_free};
+	base_set_allocator(&allocator);
+
+	try {
+		streamfx::benchmark::runtime rt{module_path, data_path, 1280, 720, 60, 1};
+		register_pattern();
+
+		obs_enter_graphics();
+		fprintf(stderr, "Renderer: %s\n", gs_get_device_name());
+		obs_leave_graphics();
+
+		for (auto const& tc : generate_cases(data_path)) {
+			if (!filter.empty() && (tc.name.find(filter) == std::string::npos)) {
+				continue;
+			}
+			for (auto resolution : resolutions) {
+				run_case(tc, resolution.first, resolution.second, warmup, frames);
+			}
+		}
+	} catch (std::exception const& ex) {
+		fprintf(stderr, "%s\n", ex.what());
+		return 1;
+	}
+
+	return 0;
+}
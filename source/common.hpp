@@ -53,6 +53,7 @@
 #include "util/util-math.hpp"
 #include "util/util-profiler.hpp"
 #include "util/util-threadpool.hpp"
+#include "util/util-tracing.hpp"
 #include "util/utility.hpp"
 
 // Common OBS includes
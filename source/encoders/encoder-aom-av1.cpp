@@ -22,6 +22,7 @@
 #include <filesystem>
 #include <thread>
 #include "util/util-logging.hpp"
+#include "util/util-plane-copy.hpp"
 
 #ifdef _DEBUG
 #define ST_PREFIX "<%s> "
@@ -317,12 +318,10 @@ aom_av1_instance::aom_av1_instance(obs_data_t* settings, obs_encoder_t* self, bo
 		throw std::runtime_error("AOM library does not provide AV1 encoder.");
 	}
 
-#ifdef ENABLE_PROFILING
 	// Profilers
 	_profiler_copy   = streamfx::util::profiler::create();
 	_profiler_encode = streamfx::util::profiler::create();
 	_profiler_packet = streamfx::util::profiler::create();
-#endif
 
 	{     // Generate Static Configuration
 		{ // OBS Information
@@ -591,7 +590,6 @@ aom_av1_instance::aom_av1_instance(obs_data_t* settings, obs_encoder_t* self, bo
 
 aom_av1_instance::~aom_av1_instance()
 {
-#ifdef ENABLE_PROFILING
 	// Profiling
 	D_LOG_INFO("Timings | Avg. µs       | 99.9ile µs    | 99.0ile µs    | 95.0ile µs    | Samples  ", "");
 	D_LOG_INFO("--------+---------------+---------------+---------------+---------------+----------", "");
@@ -613,6 +611,10 @@ aom_av1_instance::~aom_av1_instance()
 			   std::chrono::duration_cast<std::chrono::microseconds>(_profiler_packet->percentile(0.990)).count(),
 			   std::chrono::duration_cast<std::chrono::microseconds>(_profiler_packet->percentile(0.950)).count(),
 			   _profiler_packet->count());
+#ifdef ENABLE_BENCHMARK
+	streamfx::util::profiler::publish("copy", _profiler_copy);
+	streamfx::util::profiler::publish("encode", _profiler_encode);
+	streamfx::util::profiler::publish("packet", _profiler_packet);
 #endif
 
 	// Deallocate global buffer.
@@ -950,6 +952,7 @@ void aom_av1_instance::log()
 			   aom_color_trc_to_string(_settings.color_trc),
 			   _settings.color_range == AOM_CR_FULL_RANGE ? "Full" : "Partial",
 			   _settings.monochrome ? "/Monochrome" : "");
+	D_LOG_INFO("  Frame Copy: %s", ::streamfx::util::copy_plane_implementation());
 
 	// Rate Control
 	D_LOG_INFO("  Rate Control: %s", aom_rc_mode_to_string(_settings.rc_mode));
@@ -1048,49 +1051,89 @@ void aom_av1_instance::get_video_info(struct video_scale_info* info)
 	}
 }
 
+bool streamfx::encoder::aom::av1::aom_av1_instance::wrap_frame(encoder_frame* frame, aom_image_t& image)
+{
+	// libaom copies the image into its own look-ahead buffer during aom_codec_encode, so the OBS frame only has to
+	// stay alive for the duration of encode_video. It does however only know a single stride for both chroma planes.
+	if (!frame->data[AOM_PLANE_Y] || !frame->data[AOM_PLANE_U] || !frame->data[AOM_PLANE_V]
+		|| (frame->linesize[AOM_PLANE_U] != frame->linesize[AOM_PLANE_V])) {
+		return false;
+	}
+
+	// Let libaom fill in the format information, without allocating anything.
+	if (!_factory->libaom_img_wrap(&image, _settings.color_format, _settings.width, _settings.height, 1,
+								   frame->data[AOM_PLANE_Y])) {
+		return false;
+	}
+
+	// aom_img_wrap assumes all planes are packed into one buffer, which isn't guaranteed by OBS.
+	for (int plane = AOM_PLANE_Y; plane <= AOM_PLANE_V; plane++) {
+		auto width = static_cast<uint32_t>(_factory->libaom_img_plane_width(&image, plane));
+		if (frame->linesize[plane] < width) {
+			return false;
+		}
+
+		image.planes[plane] = frame->data[plane];
+		image.stride[plane] = static_cast<int>(frame->linesize[plane]);
+	}
+
+	// Color Information.
+	image.cp         = _settings.color_primaries;
+	image.tc         = _settings.color_trc;
+	image.mc         = _settings.color_matrix;
+	image.range      = _settings.color_range;
+	image.monochrome = _settings.monochrome ? 1 : 0;
+	image.csp        = AOM_CSP_VERTICAL; // !TODO: Consider making this user-controlled.
+
+	// Size
+	image.r_w = image.w;
+	image.r_h = image.h;
+
+	return true;
+}
+
 bool streamfx::encoder::aom::av1::aom_av1_instance::encode_video(encoder_frame* frame, encoder_packet* packet,
 																 bool* received_packet)
 {
-	// Retrieve current indexed image.
-	auto& image = _images.at(_image_index);
-
-	{ // Copy Image data.
-#ifdef ENABLE_PROFILING
+	// Try to use the memory OBS gave us directly, and only fall back to the indexed image if that fails.
+	aom_image_t  wrapped;
+	aom_image_t* image = &wrapped;
+	if (!wrap_frame(frame, wrapped)) { // Copy Image data.
 		auto profile = _profiler_copy->track();
-#endif
-		std::memcpy(image.planes[AOM_PLANE_Y], frame->data[0], frame->linesize[0] * image.h);
-		if (image.fmt == AOM_IMG_FMT_I420) {
-			std::memcpy(image.planes[AOM_PLANE_U], frame->data[1], frame->linesize[1] * image.h / 2);
-			std::memcpy(image.planes[AOM_PLANE_V], frame->data[2], frame->linesize[2] * image.h / 2);
-		} else {
-			std::memcpy(image.planes[AOM_PLANE_U], frame->data[1], frame->linesize[1] * image.h);
-			std::memcpy(image.planes[AOM_PLANE_V], frame->data[2], frame->linesize[2] * image.h);
+		::streamfx::util::tracing::span trace("AOM Copy", "encoder");
+		image = &_images.at(_image_index);
+		for (int plane = AOM_PLANE_Y; plane <= AOM_PLANE_V; plane++) {
+			std::size_t width  = static_cast<size_t>(_factory->libaom_img_plane_width(image, plane));
+			std::size_t height = static_cast<size_t>(_factory->libaom_img_plane_height(image, plane));
+			std::size_t ls_in  = static_cast<size_t>(frame->linesize[plane]);
+			std::size_t ls_out = static_cast<size_t>(image->stride[plane]);
+
+			::streamfx::util::copy_plane(image->planes[plane], ls_out, frame->data[plane], ls_in,
+										 std::min(width, std::min(ls_in, ls_out)), height);
 		}
 	}
 
 	{ // Try to encode the new image.
-#ifdef ENABLE_PROFILING
 		auto profile = _profiler_encode->track();
-#endif
+		::streamfx::util::tracing::span trace("AOM Encode", "encoder");
 		aom_enc_frame_flags_t flags = 0;
 		if (_cfg.g_usage == AOM_USAGE_ALL_INTRA) {
 			flags = AOM_EFLAG_FORCE_KF;
 		}
-		if (auto error = _factory->libaom_codec_encode(&_ctx, &image, frame->pts, 1, flags); error != AOM_CODEC_OK) {
+		if (auto error = _factory->libaom_codec_encode(&_ctx, image, frame->pts, 1, flags); error != AOM_CODEC_OK) {
 			const char* errstr = _factory->libaom_codec_err_to_string(error);
 			D_LOG_ERROR("Encoding frame failed with error: %s (code %" PRIu32 ")\n%s\n%s", errstr, error,
 						_factory->libaom_codec_error(&_ctx), _factory->libaom_codec_error_detail(&_ctx));
 			return false;
-		} else {
+		} else if (image != &wrapped) {
 			// Increment the image index.
 			_image_index = (_image_index++) % _images.size();
 		}
 	}
 
 	{ // Get Packet
-#ifdef ENABLE_PROFILING
 		auto profile = _profiler_packet->track();
-#endif
+		::streamfx::util::tracing::span trace("AOM Packet", "encoder");
 		aom_codec_iter_t iter = NULL;
 		for (auto* pkt = _factory->libaom_codec_get_cx_data(&_ctx, &iter); pkt != nullptr;
 			 pkt       = _factory->libaom_codec_get_cx_data(&_ctx, &iter)) {
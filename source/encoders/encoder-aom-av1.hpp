@@ -91,11 +91,9 @@ namespace streamfx::encoder::aom::av1 {
 			aom_tune_content tune_content;
 		} _settings;
 
-#ifdef ENABLE_PROFILING
 		std::shared_ptr<streamfx::util::profiler> _profiler_copy;
 		std::shared_ptr<streamfx::util::profiler> _profiler_encode;
 		std::shared_ptr<streamfx::util::profiler> _profiler_packet;
-#endif
 
 		public:
 		aom_av1_instance(obs_data_t* settings, obs_encoder_t* self, bool is_hw);
@@ -114,6 +112,9 @@ namespace streamfx::encoder::aom::av1 {
 		virtual void get_video_info(struct video_scale_info* info);
 
 		virtual bool encode_video(encoder_frame* frame, encoder_packet* packet, bool* received_packet);
+
+		private:
+		bool wrap_frame(encoder_frame* frame, aom_image_t& image);
 	};
 
 	class aom_av1_factory : public obs::encoder_factory<aom_av1_factory, aom_av1_instance> {
@@ -27,6 +27,7 @@
 #include "handlers/debug_handler.hpp"
 #include "obs/gs/gs-helper.hpp"
 #include "plugin.hpp"
+#include "util/util-plane-copy.hpp"
 
 #ifdef ENABLE_ENCODER_FFMPEG_AMF
 #include "handlers/amf_h264_handler.hpp"
@@ -71,6 +72,10 @@ extern "C" {
 #define ST_KEY_FFMPEG_THREADS "FFmpeg.Threads"
 #define ST_I18N_FFMPEG_GPU ST_I18N_FFMPEG ".GPU"
 #define ST_KEY_FFMPEG_GPU "FFmpeg.GPU"
+#define ST_I18N_FFMPEG_PIPELINE ST_I18N_FFMPEG ".Pipeline"
+#define ST_KEY_FFMPEG_PIPELINE "FFmpeg.Pipeline"
+#define ST_I18N_FFMPEG_FRAMEPARALLEL ST_I18N_FFMPEG ".FrameParallel"
+#define ST_KEY_FFMPEG_FRAMEPARALLEL "FFmpeg.FrameParallel"
 
 #define ST_I18N_KEYFRAMES ST_I18N_FFMPEG ".KeyFrames"
 #define ST_I18N_KEYFRAMES_INTERVALTYPE ST_I18N_KEYFRAMES ".IntervalType"
@@ -80,6 +85,16 @@ extern "C" {
 #define ST_KEY_KEYFRAMES_INTERVAL_SECONDS "KeyFrames.Interval.Seconds"
 #define ST_KEY_KEYFRAMES_INTERVAL_FRAMES "KeyFrames.Interval.Frames"
 
+// Maximum number of frames that may be queued for the encoder thread. Packets are never held back, as the encoder
+// thread must not wait on OBS while OBS waits on it.
+#define ST_PIPELINE_QUEUE_SIZE 8
+
+// Number of frames each frame-parallel worker may have queued before OBS has to wait for the oldest one.
+#define ST_PARALLEL_QUEUE_SIZE 2
+
+// Frames kept in the pool beyond what the encoder lags behind: one being converted, one being sent, and some slack.
+#define ST_FRAME_POOL_HEADROOM 4
+
 using namespace streamfx::encoder::ffmpeg;
 using namespace streamfx::encoder::codec;
 
@@ -94,11 +109,22 @@ ffmpeg_instance::ffmpeg_instance(obs_data_t* settings, obs_encoder_t* self, bool
 
 	  _scaler(), _packet(),
 
-	  _hwapi(), _hwinst(),
+	  _hwapi(), _hwinst(), _graphics_lock(true),
+
+	  _lag_in_frames(0), _sent_frames(0),
+
+	  _profiler_convert(streamfx::util::profiler::create()), _profiler_send(streamfx::util::profiler::create()),
+	  _profiler_receive(streamfx::util::profiler::create()),
+
+	  _have_first_frame(false), _extra_data(), _sei_data(),
+
+	  _free_frames(), _used_frames(),
 
-	  _lag_in_frames(0), _sent_frames(0), _have_first_frame(false), _extra_data(), _sei_data(),
+	  _pipeline(false), _pipeline_worker(), _pipeline_lock(), _pipeline_cv(), _pipeline_stop(false),
+	  _pipeline_failed(false), _pipeline_frames(), _pipeline_packets(), _pipeline_packet(),
 
-	  _free_frames(), _used_frames(), _free_frames_last_used()
+	  _parallel_workers(), _parallel_next(0), _parallel_lock(), _parallel_cv(), _parallel_stop(false),
+	  _parallel_failed(false), _parallel_order(), _parallel_packets(), _parallel_packet()
 {
 	// Initialize GPU Stuff
 	if (is_hw) {
@@ -122,6 +148,11 @@ ffmpeg_instance::ffmpeg_instance(obs_data_t* settings, obs_encoder_t* self, bool
 		_hwinst = _hwapi->create_from_obs();
 	}
 
+	// Only encoders that share the graphics device with OBS need to hold the graphics context while encoding, for
+	// everything else it would just stall the render thread.
+	_graphics_lock = _hwinst || (_handler ? _handler->requires_graphics_context(_factory)
+										  : ((_codec->capabilities & AV_CODEC_CAP_HARDWARE) != 0));
+
 	// Initialize context.
 	_context = avcodec_alloc_context3(_codec);
 	if (!_context) {
@@ -143,16 +174,62 @@ ffmpeg_instance::ffmpeg_instance(obs_data_t* settings, obs_encoder_t* self, bool
 	// Update settings
 	update(settings);
 
+	// Intra-only codecs produce independent frames, so several contexts can work on different frames at once.
+	std::size_t parallel = 1;
+	if (!_hwinst && _handler && !_handler->has_keyframe_support(_factory)) {
+		parallel = static_cast<size_t>(std::max<int64_t>(obs_data_get_int(settings, ST_KEY_FFMPEG_FRAMEPARALLEL), 1));
+	}
+
 	// Initialize Encoder
 	auto gctx = streamfx::obs::gs::context();
-	int  res  = avcodec_open2(_context, _codec, NULL);
-	if (res < 0) {
-		throw std::runtime_error(::streamfx::ffmpeg::tools::get_error_description(res));
+	if (parallel > 1) {
+		parallel_start(parallel);
+	} else {
+		int res = avcodec_open2(_context, _codec, NULL);
+		if (res < 0) {
+			throw std::runtime_error(::streamfx::ffmpeg::tools::get_error_description(res));
+		}
+	}
+
+	// Figure out how many frames the encoder holds on to before it returns the first packet. Encoders report their
+	// reordering delay once opened, but look-ahead is only known through their private options.
+	{
+		int64_t lookahead = 0;
+		for (const char* option : {"rc-lookahead", "rc_lookahead", "lag-in-frames"}) {
+			if ((av_opt_get_int(_context, option, AV_OPT_SEARCH_CHILDREN, &lookahead) >= 0) && (lookahead > 0))
+				break;
+			lookahead = 0;
+		}
+		_lag_in_frames = static_cast<std::size_t>(std::max(_context->delay, _context->has_b_frames))
+						 + static_cast<std::size_t>(lookahead);
+	}
+
+	// Pre-allocate all frames we expect to need, so that none are allocated once encoding is running.
+	{
+		std::size_t pool_size = _lag_in_frames + ST_FRAME_POOL_HEADROOM;
+		if (parallel > 1) {
+			pool_size += parallel * ST_PARALLEL_QUEUE_SIZE;
+		} else if (!_hwinst && obs_data_get_bool(settings, ST_KEY_FFMPEG_PIPELINE)) {
+			pool_size += ST_PIPELINE_QUEUE_SIZE;
+		}
+		_free_frames = std::make_unique<::streamfx::ffmpeg::avframe_pool>(
+			pool_size, std::bind(&ffmpeg_instance::allocate_frame, this));
+		_free_frames->prewarm(pool_size);
+	}
+
+	// Move encoding to a dedicated thread if requested. Hardware encoding relies on the texture lock keys handed to
+	// us by OBS, so this is only available for software encoding. Frame-parallel encoding already is asynchronous.
+	if (!_hwinst && (parallel <= 1) && obs_data_get_bool(settings, ST_KEY_FFMPEG_PIPELINE)) {
+		pipeline_start();
 	}
 }
 
 ffmpeg_instance::~ffmpeg_instance()
 {
+	// The encoder threads may require the graphics context, so they must be stopped before we acquire it.
+	pipeline_stop();
+	parallel_stop();
+
 	auto gctx = streamfx::obs::gs::context();
 	if (_context) {
 		// Flush encoders that require it.
@@ -172,6 +249,32 @@ ffmpeg_instance::~ffmpeg_instance()
 	av_packet_unref(&_packet);
 
 	_scaler.finalize();
+
+	// Profiling
+	auto log_timings = [this](const char* stage, std::shared_ptr<streamfx::util::profiler> const& profiler) {
+		DLOG_INFO("[%s] %-7s | %13.1f | %13" PRId64 " | %13" PRId64 " | %13" PRId64 " | %9" PRIu64, _codec->name, stage,
+				  profiler->average_duration() / 1000.,
+				  std::chrono::duration_cast<std::chrono::microseconds>(profiler->percentile(0.999)).count(),
+				  std::chrono::duration_cast<std::chrono::microseconds>(profiler->percentile(0.990)).count(),
+				  std::chrono::duration_cast<std::chrono::microseconds>(profiler->percentile(0.950)).count(),
+				  profiler->count());
+	};
+	DLOG_INFO("[%s] Timings | Avg. µs       | 99.9ile µs    | 99.0ile µs    | 95.0ile µs    | Samples  ", _codec->name);
+	DLOG_INFO("[%s] --------+---------------+---------------+---------------+---------------+----------", _codec->name);
+	log_timings("Convert", _profiler_convert);
+	log_timings("Send", _profiler_send);
+	log_timings("Receive", _profiler_receive);
+#ifdef ENABLE_BENCHMARK
+	streamfx::util::profiler::publish("convert", _profiler_convert);
+	streamfx::util::profiler::publish("send", _profiler_send);
+	streamfx::util::profiler::publish("receive", _profiler_receive);
+#endif
+
+	if (_free_frames) {
+		DLOG_INFO("[%s] Frame Pool: %" PRIu64 " hits, %" PRIu64 " misses, %zu peak (of %zu).",
+				  _codec->name, _free_frames->hits(), _free_frames->misses(), _free_frames->peak(),
+				  _free_frames->capacity());
+	}
 }
 
 void ffmpeg_instance::get_properties(obs_properties_t* props)
@@ -185,6 +288,8 @@ void ffmpeg_instance::get_properties(obs_properties_t* props)
 
 	obs_property_set_enabled(obs_properties_get(props, ST_KEY_FFMPEG_THREADS), false);
 	obs_property_set_enabled(obs_properties_get(props, ST_KEY_FFMPEG_GPU), false);
+	obs_property_set_enabled(obs_properties_get(props, ST_KEY_FFMPEG_PIPELINE), false);
+	obs_property_set_enabled(obs_properties_get(props, ST_KEY_FFMPEG_FRAMEPARALLEL), false);
 }
 
 void ffmpeg_instance::migrate(obs_data_t* settings, uint64_t version)
@@ -294,6 +399,14 @@ bool ffmpeg_instance::update(obs_data_t* settings)
 				  ::streamfx::ffmpeg::tools::get_std_compliance_name(_context->strict_std_compliance));
 		DLOG_INFO("[%s]     Threading: %s (with %i threads)", _codec->name,
 				  ::streamfx::ffmpeg::tools::get_thread_type_name(_context->thread_type), _context->thread_count);
+		DLOG_INFO("[%s]     Pipelined: %s", _codec->name,
+				  (!_hwinst && obs_data_get_bool(settings, ST_KEY_FFMPEG_PIPELINE)) ? "Yes" : "No");
+		DLOG_INFO("[%s]     Frame Copy: %s", _codec->name, ::streamfx::util::copy_plane_implementation());
+		DLOG_INFO("[%s]     Graphics Lock: %s", _codec->name, _graphics_lock ? "Yes" : "No");
+		if (_handler && !_handler->has_keyframe_support(_factory)) {
+			DLOG_INFO("[%s]     Frame-Parallel: %" PRId64 " contexts", _codec->name,
+					  std::max<int64_t>(obs_data_get_int(settings, ST_KEY_FFMPEG_FRAMEPARALLEL), 1));
+		}
 
 		DLOG_INFO("[%s]   Video:", _codec->name);
 		if (_hwinst) {
@@ -312,6 +425,7 @@ bool ffmpeg_instance::update(obs_data_t* settings)
 					  ::streamfx::ffmpeg::tools::get_pixel_format_name(_scaler.get_target_format()),
 					  ::streamfx::ffmpeg::tools::get_color_space_name(_scaler.get_target_colorspace()),
 					  _scaler.is_target_full_range() ? "Full" : "Partial");
+			DLOG_INFO("[%s]     Conversion Slices: %" PRIu32, _codec->name, _scaler.get_active_slices());
 			if (!_hwinst)
 				DLOG_INFO("[%s]     On GPU Index: %lli", _codec->name, obs_data_get_int(settings, ST_KEY_FFMPEG_GPU));
 		}
@@ -345,23 +459,11 @@ static inline void copy_data(encoder_frame* frame, AVFrame* vframe)
 			continue;
 
 		std::size_t plane_height = static_cast<size_t>(vframe->height) >> (idx ? v_chroma_shift : 0);
+		std::size_t ls_in        = static_cast<size_t>(frame->linesize[idx]);
+		std::size_t ls_out       = static_cast<size_t>(vframe->linesize[idx]);
+		std::size_t bytes        = ls_in < ls_out ? ls_in : ls_out;
 
-		if (static_cast<uint32_t>(vframe->linesize[idx]) == frame->linesize[idx]) {
-			std::memcpy(vframe->data[idx], frame->data[idx], frame->linesize[idx] * plane_height);
-		} else {
-			std::size_t ls_in  = static_cast<size_t>(frame->linesize[idx]);
-			std::size_t ls_out = static_cast<size_t>(vframe->linesize[idx]);
-			std::size_t bytes  = ls_in < ls_out ? ls_in : ls_out;
-
-			uint8_t* to   = vframe->data[idx];
-			uint8_t* from = frame->data[idx];
-
-			for (std::size_t y = 0; y < plane_height; y++) {
-				std::memcpy(to, from, bytes);
-				to += ls_out;
-				from += ls_in;
-			}
-		}
+		::streamfx::util::copy_plane(vframe->data[idx], ls_out, frame->data[idx], ls_in, bytes, plane_height);
 	}
 }
 
@@ -376,6 +478,8 @@ bool ffmpeg_instance::encode_video(struct encoder_frame* frame, struct encoder_p
 
 	// Convert frame.
 	{
+		::streamfx::util::tracing::span trace("FFmpeg Convert", "encoder");
+		auto profile = _profiler_convert->track();
 		vframe->height          = _context->height;
 		vframe->format          = _context->pix_fmt;
 		vframe->color_range     = _context->color_range;
@@ -399,6 +503,12 @@ bool ffmpeg_instance::encode_video(struct encoder_frame* frame, struct encoder_p
 		}
 	}
 
+	if (!_parallel_workers.empty())
+		return parallel_encode_avframe(vframe, packet, received_packet);
+
+	if (_pipeline)
+		return pipeline_encode_avframe(vframe, packet, received_packet);
+
 	if (!encode_avframe(vframe, packet, received_packet))
 		return false;
 
@@ -416,7 +526,10 @@ bool ffmpeg_instance::encode_video(uint32_t handle, int64_t pts, uint64_t lock_k
 	}
 
 	std::shared_ptr<AVFrame> vframe = pop_free_frame();
-	_hwinst->copy_from_obs(_context->hw_frames_ctx, handle, lock_key, next_key, vframe);
+	{
+		auto profile = _profiler_convert->track();
+		_hwinst->copy_from_obs(_context->hw_frames_ctx, handle, lock_key, next_key, vframe);
+	}
 
 	vframe->color_range     = _context->color_range;
 	vframe->colorspace      = _context->colorspace;
@@ -471,6 +584,9 @@ void ffmpeg_instance::initialize_sw(obs_data_t* settings)
 		_scaler.set_target_color(_context->color_range == AVCOL_RANGE_JPEG, _context->colorspace);
 		_scaler.set_target_format(pix_fmt_target);
 
+		// Split the conversion into bands so that it isn't limited to the encode thread.
+		_scaler.set_slices(std::thread::hardware_concurrency());
+
 		// Create Scaler
 		if (!_scaler.initialize(SWS_POINT)) {
 			std::stringstream sstr;
@@ -521,49 +637,39 @@ void ffmpeg_instance::initialize_hw(obs_data_t*)
 #endif
 }
 
-void ffmpeg_instance::push_free_frame(std::shared_ptr<AVFrame> frame)
+std::shared_ptr<AVFrame> ffmpeg_instance::allocate_frame()
 {
-	auto now = std::chrono::high_resolution_clock::now();
-	if (_free_frames.size() > 0) {
-		if ((now - _free_frames_last_used) < std::chrono::seconds(1)) {
-			_free_frames.push(frame);
-		}
-	} else {
-		_free_frames.push(frame);
-		_free_frames_last_used = std::chrono::high_resolution_clock::now();
+	if (_hwinst) {
+		return _hwinst->allocate_frame(_context->hw_frames_ctx);
 	}
-}
 
-std::shared_ptr<AVFrame> ffmpeg_instance::pop_free_frame()
-{
-	std::shared_ptr<AVFrame> frame;
-	if (_free_frames.size() > 0) {
-		// Re-use existing frames first.
-		frame = _free_frames.top();
-		_free_frames.pop();
-	} else {
-		if (_hwinst) {
-			frame = _hwinst->allocate_frame(_context->hw_frames_ctx);
-		} else {
-			frame = std::shared_ptr<AVFrame>(av_frame_alloc(), [](AVFrame* frame) {
-				av_frame_unref(frame);
-				av_frame_free(&frame);
-			});
+	auto frame = std::shared_ptr<AVFrame>(av_frame_alloc(), [](AVFrame* frame) {
+		av_frame_unref(frame);
+		av_frame_free(&frame);
+	});
 
-			frame->width  = _context->width;
-			frame->height = _context->height;
-			frame->format = _context->pix_fmt;
+	frame->width  = _context->width;
+	frame->height = _context->height;
+	frame->format = _context->pix_fmt;
 
-			int res = av_frame_get_buffer(frame.get(), 32);
-			if (res < 0) {
-				throw std::runtime_error(::streamfx::ffmpeg::tools::get_error_description(res));
-			}
-		}
+	int res = av_frame_get_buffer(frame.get(), 32);
+	if (res < 0) {
+		throw std::runtime_error(::streamfx::ffmpeg::tools::get_error_description(res));
 	}
 
 	return frame;
 }
 
+void ffmpeg_instance::push_free_frame(std::shared_ptr<AVFrame> frame)
+{
+	_free_frames->release(frame);
+}
+
+std::shared_ptr<AVFrame> ffmpeg_instance::pop_free_frame()
+{
+	return _free_frames->acquire();
+}
+
 void ffmpeg_instance::push_used_frame(std::shared_ptr<AVFrame> frame)
 {
 	_used_frames.push(frame);
@@ -611,13 +717,27 @@ int ffmpeg_instance::receive_packet(bool* received_packet, struct encoder_packet
 	av_packet_unref(&_packet);
 
 	{
-		auto gctx = streamfx::obs::gs::context();
-		res       = avcodec_receive_packet(_context, &_packet);
+		::streamfx::util::tracing::span trace("FFmpeg Receive", "encoder");
+		auto profile = _profiler_receive->track();
+		std::optional<streamfx::obs::gs::context> gctx;
+		if (_graphics_lock)
+			gctx.emplace();
+		res = avcodec_receive_packet(_context, &_packet);
 	}
 	if (res != 0) {
 		return res;
 	}
 
+	process_packet(_packet, packet, received_packet);
+
+	// Push free frame back into pool.
+	push_free_frame(pop_used_frame());
+
+	return res;
+}
+
+void ffmpeg_instance::process_packet(AVPacket& av_packet, struct encoder_packet* packet, bool* received_packet)
+{
 	if (!_have_first_frame) {
 		if (_codec->id == AV_CODEC_ID_H264) {
 			uint8_t*    tmp_packet;
@@ -625,7 +745,7 @@ int ffmpeg_instance::receive_packet(bool* received_packet, struct encoder_packet
 			uint8_t*    tmp_sei;
 			std::size_t sz_packet, sz_header, sz_sei;
 
-			obs_extract_avc_headers(_packet.data, static_cast<size_t>(_packet.size), &tmp_packet, &sz_packet,
+			obs_extract_avc_headers(av_packet.data, static_cast<size_t>(av_packet.size), &tmp_packet, &sz_packet,
 									&tmp_header, &sz_header, &tmp_sei, &sz_sei);
 
 			if (sz_header) {
@@ -646,7 +766,7 @@ int ffmpeg_instance::receive_packet(bool* received_packet, struct encoder_packet
 			bfree(tmp_header);
 			bfree(tmp_sei);
 		} else if (_codec->id == AV_CODEC_ID_HEVC) {
-			hevc::extract_header_sei(_packet.data, static_cast<size_t>(_packet.size), _extra_data, _sei_data);
+			hevc::extract_header_sei(av_packet.data, static_cast<size_t>(av_packet.size), _extra_data, _sei_data);
 		} else if (_context->extradata != nullptr) {
 			_extra_data.resize(static_cast<size_t>(_context->extradata_size));
 			std::memcpy(_extra_data.data(), _context->extradata, static_cast<size_t>(_context->extradata_size));
@@ -656,29 +776,29 @@ int ffmpeg_instance::receive_packet(bool* received_packet, struct encoder_packet
 
 	// Allow Handler Post-Processing
 	if (_handler)
-		_handler->process_avpacket(_packet, _codec, _context);
+		_handler->process_avpacket(av_packet, _codec, _context);
 
 	// Build packet for use in OBS.
 	packet->type     = OBS_ENCODER_VIDEO;
-	packet->pts      = _packet.pts;
-	packet->dts      = _packet.dts;
-	packet->data     = _packet.data;
-	packet->size     = static_cast<size_t>(_packet.size);
-	packet->keyframe = !!(_packet.flags & AV_PKT_FLAG_KEY);
+	packet->pts      = av_packet.pts;
+	packet->dts      = av_packet.dts;
+	packet->data     = av_packet.data;
+	packet->size     = static_cast<size_t>(av_packet.size);
+	packet->keyframe = !!(av_packet.flags & AV_PKT_FLAG_KEY);
 	*received_packet = true;
 
 	// Figure out priority and drop_priority.
 	// In theory, this is done by OBS, but its not doing a great job.
 	packet->priority      = packet->keyframe ? 3 : 2;
 	packet->drop_priority = 3;
-	for (size_t idx = 0, edx = _packet.side_data_elems; idx < edx; idx++) {
-		auto& side_data = _packet.side_data[idx];
+	for (size_t idx = 0, edx = av_packet.side_data_elems; idx < edx; idx++) {
+		auto& side_data = av_packet.side_data[idx];
 		if (side_data.type == AV_PKT_DATA_QUALITY_STATS) {
 			// Decisions based on picture type, if present.
 			switch (side_data.data[sizeof(uint32_t)]) {
 			case AV_PICTURE_TYPE_I:  // I-Frame
 			case AV_PICTURE_TYPE_SI: // Switching I-Frame
-				if (_packet.flags & AV_PKT_FLAG_KEY) {
+				if (av_packet.flags & AV_PKT_FLAG_KEY) {
 					// Recovery only via IDR-Frame.
 					packet->priority      = 3; // OBS_NAL_PRIORITY_HIGHEST
 					packet->drop_priority = 2; // OBS_NAL_PRIORITY_HIGH
@@ -712,22 +832,22 @@ int ffmpeg_instance::receive_packet(bool* received_packet, struct encoder_packet
 			}
 		}
 	}
-
-	// Push free frame back into pool.
-	push_free_frame(pop_used_frame());
-
-	return res;
 }
 
 int ffmpeg_instance::send_frame(std::shared_ptr<AVFrame> const frame)
 {
 	int res = 0;
 	{
-		auto gctx = streamfx::obs::gs::context();
-		res       = avcodec_send_frame(_context, frame.get());
+		::streamfx::util::tracing::span trace("FFmpeg Send", "encoder");
+		auto profile = _profiler_send->track();
+		std::optional<streamfx::obs::gs::context> gctx;
+		if (_graphics_lock)
+			gctx.emplace();
+		res = avcodec_send_frame(_context, frame.get());
 	}
 	if (res == 0) {
 		push_used_frame(frame);
+		_sent_frames++;
 	}
 
 	return res;
@@ -809,6 +929,368 @@ bool ffmpeg_instance::encode_avframe(std::shared_ptr<AVFrame> frame, encoder_pac
 	return true;
 }
 
+void ffmpeg_instance::pipeline_start()
+{
+	_pipeline_stop   = false;
+	_pipeline_failed = false;
+	_pipeline_worker = std::thread(std::bind(&ffmpeg_instance::pipeline_work, this));
+	_pipeline        = true;
+}
+
+void ffmpeg_instance::pipeline_stop()
+{
+	if (!_pipeline)
+		return;
+
+	{
+		std::unique_lock<std::mutex> lock(_pipeline_lock);
+		_pipeline_stop = true;
+	}
+	_pipeline_cv.notify_all();
+	if (_pipeline_worker.joinable()) {
+		_pipeline_worker.join();
+	}
+
+	// OBS no longer collects packets once the encoder is being destroyed, so queued frames and packets are dropped
+	// instead of being flushed through the encoder.
+	std::queue<std::shared_ptr<AVFrame>>().swap(_pipeline_frames);
+	std::queue<std::shared_ptr<AVPacket>>().swap(_pipeline_packets);
+	_pipeline_packet.reset();
+	_pipeline = false;
+}
+
+void ffmpeg_instance::pipeline_work()
+{
+	auto fail = [this]() {
+		{
+			std::unique_lock<std::mutex> lock(_pipeline_lock);
+			_pipeline_failed = true;
+		}
+		_pipeline_cv.notify_all();
+	};
+
+	while (true) {
+		std::shared_ptr<AVFrame> frame;
+		{ // Wait for the next frame, or for a request to stop.
+			std::unique_lock<std::mutex> lock(_pipeline_lock);
+			_pipeline_cv.wait(lock, [this]() { return _pipeline_stop || !_pipeline_frames.empty(); });
+			if (_pipeline_stop) {
+				return;
+			}
+
+			frame = _pipeline_frames.front();
+			_pipeline_frames.pop();
+		}
+		_pipeline_cv.notify_all();
+
+		// Unlike the synchronous path, EAGAIN here is never fatal: we simply drain packets and try again.
+		bool sent_frame = false;
+		while (!sent_frame) {
+			int res = send_frame(frame);
+			switch (res) {
+			case 0:
+				sent_frame = true;
+				break;
+			case AVERROR(EAGAIN):
+				break;
+			case AVERROR_EOF:
+				DLOG_ERROR("Skipped frame due to end of stream.");
+				push_free_frame(frame);
+				sent_frame = true;
+				break;
+			default:
+				DLOG_ERROR("Failed to encode frame: %s (%" PRId32 ").",
+						   ::streamfx::ffmpeg::tools::get_error_description(res), res);
+				fail();
+				return;
+			}
+
+			// Drain all packets that the encoder has ready for us.
+			std::size_t drained = 0;
+			while (true) {
+				std::shared_ptr<AVPacket> av_packet{av_packet_alloc(), [](AVPacket* ptr) { av_packet_free(&ptr); }};
+				{
+					::streamfx::util::tracing::span trace("FFmpeg Receive", "encoder");
+					auto profile = _profiler_receive->track();
+					std::optional<streamfx::obs::gs::context> gctx;
+					if (_graphics_lock)
+						gctx.emplace();
+					res = avcodec_receive_packet(_context, av_packet.get());
+				}
+				if ((res == AVERROR(EAGAIN)) || (res == AVERROR_EOF)) {
+					break;
+				} else if (res < 0) {
+					DLOG_ERROR("Failed to receive packet: %s (%" PRId32 ").",
+							   ::streamfx::ffmpeg::tools::get_error_description(res), res);
+					fail();
+					return;
+				}
+				drained++;
+
+				// Push free frame back into pool.
+				push_free_frame(pop_used_frame());
+
+				// Never wait for OBS to pick up packets here: OBS may itself be waiting for space in the frame queue,
+				// and it only takes one packet per frame. The frame queue already limits how far ahead we can get.
+				{
+					std::unique_lock<std::mutex> lock(_pipeline_lock);
+					_pipeline_packets.push(av_packet);
+				}
+			}
+
+			if (!sent_frame && (drained == 0)) {
+				DLOG_ERROR("Both send and recieve returned EAGAIN, encoder is broken.");
+				fail();
+				return;
+			}
+		}
+	}
+}
+
+bool ffmpeg_instance::pipeline_encode_avframe(std::shared_ptr<AVFrame> frame, struct encoder_packet* packet,
+											  bool* received_packet)
+{
+	{
+		std::unique_lock<std::mutex> lock(_pipeline_lock);
+
+		// This only blocks if the encoder thread has fallen behind by an entire queue.
+		_pipeline_cv.wait(lock, [this]() {
+			return _pipeline_failed || (_pipeline_frames.size() < ST_PIPELINE_QUEUE_SIZE);
+		});
+		if (_pipeline_failed) {
+			return false;
+		}
+		_pipeline_frames.push(frame);
+
+		// Hand out the oldest finished packet. OBS expects the packet data to stay valid until the next call, so we
+		// keep a reference to it around until then.
+		if (!_pipeline_packets.empty()) {
+			_pipeline_packet = _pipeline_packets.front();
+			_pipeline_packets.pop();
+		} else {
+			_pipeline_packet.reset();
+		}
+	}
+	_pipeline_cv.notify_all();
+
+	if (_pipeline_packet) {
+		process_packet(*_pipeline_packet, packet, received_packet);
+	}
+
+	return true;
+}
+
+AVCodecContext* ffmpeg_instance::clone_context()
+{
+	AVCodecContext* context = avcodec_alloc_context3(_codec);
+	if (!context) {
+		throw std::runtime_error("Failed to create encoder context.");
+	}
+
+	// Generic and codec specific options, which covers everything handlers and custom settings may have changed.
+	int res = av_opt_copy(context, _context);
+	if ((res >= 0) && context->priv_data && _context->priv_data) {
+		res = av_opt_copy(context->priv_data, _context->priv_data);
+	}
+	if (res < 0) {
+		avcodec_free_context(&context);
+		throw std::runtime_error(::streamfx::ffmpeg::tools::get_error_description(res));
+	}
+
+	// Everything else that isn't exposed as an option.
+	context->width                  = _context->width;
+	context->height                 = _context->height;
+	context->pix_fmt                = _context->pix_fmt;
+	context->sw_pix_fmt             = _context->sw_pix_fmt;
+	context->time_base              = _context->time_base;
+	context->framerate              = _context->framerate;
+	context->ticks_per_frame        = _context->ticks_per_frame;
+	context->sample_aspect_ratio    = _context->sample_aspect_ratio;
+	context->color_range            = _context->color_range;
+	context->colorspace             = _context->colorspace;
+	context->color_primaries        = _context->color_primaries;
+	context->color_trc              = _context->color_trc;
+	context->chroma_sample_location = _context->chroma_sample_location;
+	context->field_order            = _context->field_order;
+	context->profile                = _context->profile;
+	context->level                  = _context->level;
+
+	return context;
+}
+
+void ffmpeg_instance::parallel_start(std::size_t count)
+{
+	_parallel_stop   = false;
+	_parallel_failed = false;
+	_parallel_next   = 0;
+
+	// The first worker uses the primary context, so that extra data and logging keep working as before.
+	for (std::size_t idx = 0; idx < count; idx++) {
+		auto worker     = std::make_unique<parallel_worker>();
+		worker->context = (idx == 0) ? _context : clone_context();
+		_parallel_workers.push_back(std::move(worker));
+
+		int res = avcodec_open2(_parallel_workers.back()->context, _codec, NULL);
+		if (res < 0) {
+			parallel_stop();
+			throw std::runtime_error(::streamfx::ffmpeg::tools::get_error_description(res));
+		}
+	}
+
+	for (auto& worker : _parallel_workers) {
+		worker->thread = std::thread(std::bind(&ffmpeg_instance::parallel_work, this, worker.get()));
+	}
+}
+
+void ffmpeg_instance::parallel_stop()
+{
+	if (_parallel_workers.empty())
+		return;
+
+	{
+		std::unique_lock<std::mutex> lock(_parallel_lock);
+		_parallel_stop = true;
+	}
+	_parallel_cv.notify_all();
+
+	for (auto& worker : _parallel_workers) {
+		if (worker->thread.joinable()) {
+			worker->thread.join();
+		}
+
+		// The primary context is cleaned up by the destructor.
+		if (worker->context != _context) {
+			avcodec_free_context(&worker->context);
+		}
+	}
+	_parallel_workers.clear();
+
+	// Anything still queued at this point will never be returned.
+	std::queue<int64_t>().swap(_parallel_order);
+	_parallel_packets.clear();
+	_parallel_packet.reset();
+}
+
+void ffmpeg_instance::parallel_work(parallel_worker* worker)
+{
+	auto fail = [this]() {
+		{
+			std::unique_lock<std::mutex> lock(_parallel_lock);
+			_parallel_failed = true;
+		}
+		_parallel_cv.notify_all();
+	};
+
+	while (true) {
+		std::shared_ptr<AVFrame> frame;
+		{ // Wait for the next frame, or for a request to stop.
+			std::unique_lock<std::mutex> lock(_parallel_lock);
+			_parallel_cv.wait(lock, [this, worker]() { return _parallel_stop || !worker->frames.empty(); });
+			if (_parallel_stop) {
+				return;
+			}
+
+			frame = worker->frames.front();
+			worker->frames.pop();
+		}
+
+		int res = 0;
+		{
+			::streamfx::util::tracing::span trace("FFmpeg Send", "encoder");
+			auto profile = _profiler_send->track();
+			std::optional<streamfx::obs::gs::context> gctx;
+			if (_graphics_lock)
+				gctx.emplace();
+			res = avcodec_send_frame(worker->context, frame.get());
+		}
+		if (res < 0) {
+			DLOG_ERROR("Failed to encode frame: %s (%" PRId32 ").",
+					   ::streamfx::ffmpeg::tools::get_error_description(res), res);
+			fail();
+			return;
+		}
+		worker->used_frames.push(frame);
+
+		// Intra-only encoders usually have a packet ready right away, but don't rely on it.
+		while (true) {
+			std::shared_ptr<AVPacket> av_packet{av_packet_alloc(), [](AVPacket* ptr) { av_packet_free(&ptr); }};
+			{
+				::streamfx::util::tracing::span trace("FFmpeg Receive", "encoder");
+				auto profile = _profiler_receive->track();
+				std::optional<streamfx::obs::gs::context> gctx;
+				if (_graphics_lock)
+					gctx.emplace();
+				res = avcodec_receive_packet(worker->context, av_packet.get());
+			}
+			if ((res == AVERROR(EAGAIN)) || (res == AVERROR_EOF)) {
+				break;
+			} else if (res < 0) {
+				DLOG_ERROR("Failed to receive packet: %s (%" PRId32 ").",
+						   ::streamfx::ffmpeg::tools::get_error_description(res), res);
+				fail();
+				return;
+			}
+
+			push_free_frame(worker->used_frames.front());
+			worker->used_frames.pop();
+
+			{
+				std::unique_lock<std::mutex> lock(_parallel_lock);
+				_parallel_packets.emplace(av_packet->pts, av_packet);
+			}
+			_parallel_cv.notify_all();
+		}
+	}
+}
+
+bool ffmpeg_instance::parallel_encode_avframe(std::shared_ptr<AVFrame> frame, struct encoder_packet* packet,
+											  bool* received_packet)
+{
+	{
+		std::unique_lock<std::mutex> lock(_parallel_lock);
+		if (_parallel_failed) {
+			return false;
+		}
+
+		// Distribute frames in a round-robin fashion, remembering the order they have to be returned in.
+		_parallel_workers[_parallel_next]->frames.push(frame);
+		_parallel_next = (_parallel_next + 1) % _parallel_workers.size();
+		_parallel_order.push(frame->pts);
+	}
+	_parallel_cv.notify_all();
+
+	// OBS expects the packet data to stay valid until the next call, so we keep a reference to it around until then.
+	_parallel_packet.reset();
+	{
+		std::unique_lock<std::mutex> lock(_parallel_lock);
+		while (true) {
+			if (_parallel_failed) {
+				return false;
+			}
+
+			// Packets can only be handed out in the order the frames came in.
+			if (auto kv = _parallel_packets.find(_parallel_order.front()); kv != _parallel_packets.end()) {
+				_parallel_packet = kv->second;
+				_parallel_packets.erase(kv);
+				_parallel_order.pop();
+				break;
+			}
+
+			// This only blocks if the oldest frame is holding back an entire queue worth of frames.
+			if (_parallel_order.size() < (_parallel_workers.size() * ST_PARALLEL_QUEUE_SIZE)) {
+				break;
+			}
+			_parallel_cv.wait(lock);
+		}
+	}
+
+	if (_parallel_packet) {
+		process_packet(*_parallel_packet, packet, received_packet);
+	}
+
+	return true;
+}
+
 bool ffmpeg_instance::is_hardware_encode()
 {
 	return _hwinst != nullptr;
@@ -1041,6 +1523,8 @@ void ffmpeg_factory::get_defaults2(obs_data_t* settings)
 		obs_data_set_default_string(settings, ST_KEY_FFMPEG_CUSTOMSETTINGS, "");
 		obs_data_set_default_int(settings, ST_KEY_FFMPEG_THREADS, 0);
 		obs_data_set_default_int(settings, ST_KEY_FFMPEG_GPU, -1);
+		obs_data_set_default_bool(settings, ST_KEY_FFMPEG_PIPELINE, false);
+		obs_data_set_default_int(settings, ST_KEY_FFMPEG_FRAMEPARALLEL, 1);
 	}
 }
 
@@ -1135,6 +1619,16 @@ obs_properties_t* ffmpeg_factory::get_properties2(instance_t* data)
 			auto p = obs_properties_add_int_slider(grp, ST_KEY_FFMPEG_THREADS, D_TRANSLATE(ST_I18N_FFMPEG_THREADS), 0,
 												   static_cast<int64_t>(std::thread::hardware_concurrency() * 2), 1);
 		}
+
+		{ // Pipelined Encoding
+			auto p = obs_properties_add_bool(grp, ST_KEY_FFMPEG_PIPELINE, D_TRANSLATE(ST_I18N_FFMPEG_PIPELINE));
+		}
+
+		if (_handler && !_handler->has_keyframe_support(this)) { // Frame-Parallel Encoding
+			auto p = obs_properties_add_int_slider(grp, ST_KEY_FFMPEG_FRAMEPARALLEL,
+												   D_TRANSLATE(ST_I18N_FFMPEG_FRAMEPARALLEL), 1,
+												   static_cast<int64_t>(std::thread::hardware_concurrency()), 1);
+		}
 	};
 
 	return props;
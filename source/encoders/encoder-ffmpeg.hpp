@@ -21,18 +21,22 @@
 
 #pragma once
 #include "common.hpp"
+#include <atomic>
 #include <condition_variable>
 #include <map>
 #include <mutex>
+#include <optional>
 #include <queue>
 #include <stack>
 #include <thread>
 #include <vector>
+#include "ffmpeg/avframe-pool.hpp"
 #include "ffmpeg/avframe-queue.hpp"
 #include "ffmpeg/hwapi/base.hpp"
 #include "ffmpeg/swscale.hpp"
 #include "handlers/handler.hpp"
 #include "obs/obs-encoder-factory.hpp"
+#include "util/util-profiler.hpp"
 
 extern "C" {
 #ifdef _MSC_VER
@@ -62,19 +66,52 @@ namespace streamfx::encoder::ffmpeg {
 
 		std::shared_ptr<::streamfx::ffmpeg::hwapi::base>     _hwapi;
 		std::shared_ptr<::streamfx::ffmpeg::hwapi::instance> _hwinst;
+		bool                                                 _graphics_lock;
 
 		std::size_t _lag_in_frames;
 		std::size_t _sent_frames;
 
+		// Profiling
+		std::shared_ptr<streamfx::util::profiler> _profiler_convert;
+		std::shared_ptr<streamfx::util::profiler> _profiler_send;
+		std::shared_ptr<streamfx::util::profiler> _profiler_receive;
+
 		// Extra Data
 		bool                 _have_first_frame;
 		std::vector<uint8_t> _extra_data;
 		std::vector<uint8_t> _sei_data;
 
-		// Frame Stack and Queue
-		std::stack<std::shared_ptr<AVFrame>>           _free_frames;
-		std::queue<std::shared_ptr<AVFrame>>           _used_frames;
-		std::chrono::high_resolution_clock::time_point _free_frames_last_used;
+		// Frame Pool and Queue
+		std::unique_ptr<::streamfx::ffmpeg::avframe_pool> _free_frames;
+		std::queue<std::shared_ptr<AVFrame>>              _used_frames;
+
+		// Pipelined Encoding
+		bool                                  _pipeline;
+		std::thread                           _pipeline_worker;
+		std::mutex                            _pipeline_lock;
+		std::condition_variable               _pipeline_cv;
+		bool                                  _pipeline_stop;
+		std::atomic<bool>                     _pipeline_failed;
+		std::queue<std::shared_ptr<AVFrame>>  _pipeline_frames;
+		std::queue<std::shared_ptr<AVPacket>> _pipeline_packets;
+		std::shared_ptr<AVPacket>             _pipeline_packet;
+
+		// Frame-Parallel Encoding
+		struct parallel_worker {
+			AVCodecContext*                      context;
+			std::thread                          thread;
+			std::queue<std::shared_ptr<AVFrame>> frames;
+			std::queue<std::shared_ptr<AVFrame>> used_frames;
+		};
+		std::vector<std::unique_ptr<parallel_worker>> _parallel_workers;
+		std::size_t                                   _parallel_next;
+		std::mutex                                    _parallel_lock;
+		std::condition_variable                       _parallel_cv;
+		bool                                          _parallel_stop;
+		bool                                          _parallel_failed;
+		std::queue<int64_t>                           _parallel_order;
+		std::map<int64_t, std::shared_ptr<AVPacket>>  _parallel_packets;
+		std::shared_ptr<AVPacket>                     _parallel_packet;
 
 		public:
 		ffmpeg_instance(obs_data_t* settings, obs_encoder_t* self, bool is_hw);
@@ -104,6 +141,7 @@ namespace streamfx::encoder::ffmpeg {
 		void initialize_sw(obs_data_t* settings);
 		void initialize_hw(obs_data_t* settings);
 
+		std::shared_ptr<AVFrame> allocate_frame();
 		void                     push_free_frame(std::shared_ptr<AVFrame> frame);
 		std::shared_ptr<AVFrame> pop_free_frame();
 
@@ -112,10 +150,28 @@ namespace streamfx::encoder::ffmpeg {
 
 		int receive_packet(bool* received_packet, struct encoder_packet* packet);
 
+		void process_packet(AVPacket& av_packet, struct encoder_packet* packet, bool* received_packet);
+
 		int send_frame(std::shared_ptr<AVFrame> frame);
 
 		bool encode_avframe(std::shared_ptr<AVFrame> frame, struct encoder_packet* packet, bool* received_packet);
 
+		void pipeline_start();
+		void pipeline_stop();
+		void pipeline_work();
+
+		bool pipeline_encode_avframe(std::shared_ptr<AVFrame> frame, struct encoder_packet* packet,
+									 bool* received_packet);
+
+		AVCodecContext* clone_context();
+
+		void parallel_start(std::size_t count);
+		void parallel_stop();
+		void parallel_work(parallel_worker* worker);
+
+		bool parallel_encode_avframe(std::shared_ptr<AVFrame> frame, struct encoder_packet* packet,
+									 bool* received_packet);
+
 		public: // Handler API
 		bool is_hardware_encode();
 
@@ -34,6 +34,11 @@ bool handler::handler::is_hardware_encoder(ffmpeg_factory* instance)
 	return false;
 }
 
+bool handler::handler::requires_graphics_context(ffmpeg_factory* instance)
+{
+	return is_hardware_encoder(instance) || (instance->get_avcodec()->capabilities & AV_CODEC_CAP_HARDWARE);
+}
+
 bool handler::handler::has_threading_support(ffmpeg_factory* instance)
 {
 	return (instance->get_avcodec()->capabilities & (AV_CODEC_CAP_FRAME_THREADS | AV_CODEC_CAP_SLICE_THREADS));
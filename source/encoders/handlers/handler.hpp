@@ -57,6 +57,9 @@ namespace streamfx::encoder::ffmpeg {
 
 			virtual bool is_hardware_encoder(ffmpeg_factory* instance);
 
+			/** Does the encoder share the graphics device with OBS, and thus require the graphics context to encode? */
+			virtual bool requires_graphics_context(ffmpeg_factory* instance);
+
 			virtual bool has_threading_support(ffmpeg_factory* instance);
 
 			virtual bool has_pixel_format_support(ffmpeg_factory* instance);
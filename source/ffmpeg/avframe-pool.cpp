@@ -0,0 +1,159 @@
+// FFMPEG Video Encoder Integration for OBS Studio
+// Copyright (c) 2021 Michael Fabian Dirks <info@xaymar.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "avframe-pool.hpp"
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
+
+using namespace streamfx::ffmpeg;
+
+// The slots form a bounded multi-producer multi-consumer queue: each slot carries a sequence number which tells
+// producers and consumers whether it is theirs to use for a given position, so no locks are ever taken.
+
+avframe_pool::avframe_pool(std::size_t capacity, allocator_t allocator)
+	: _allocator(allocator), _capacity(std::max<std::size_t>(capacity, 1)), _slots(), _head(0), _tail(0), _hits(0),
+	  _misses(0), _outstanding(0), _peak(0)
+{
+	if (!_allocator) {
+		throw std::invalid_argument("allocator must not be empty");
+	}
+
+	_slots = std::make_unique<slot[]>(_capacity);
+	for (std::size_t idx = 0; idx < _capacity; idx++) {
+		_slots[idx].sequence.store(idx, std::memory_order_relaxed);
+	}
+}
+
+avframe_pool::~avframe_pool() {}
+
+void avframe_pool::prewarm(std::size_t count)
+{
+	count = std::min(count, _capacity);
+	for (std::size_t idx = _tail.load() - _head.load(); idx < count; idx++) {
+		auto frame = _allocator();
+		if (!try_push(frame)) {
+			break;
+		}
+	}
+}
+
+std::shared_ptr<AVFrame> avframe_pool::acquire()
+{
+	std::shared_ptr<AVFrame> frame;
+	if (try_pop(frame)) {
+		_hits.fetch_add(1, std::memory_order_relaxed);
+	} else {
+		frame = _allocator();
+		_misses.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	// Track the highest number of frames that were in use at the same time.
+	std::size_t outstanding = _outstanding.fetch_add(1, std::memory_order_relaxed) + 1;
+	std::size_t peak        = _peak.load(std::memory_order_relaxed);
+	while ((outstanding > peak) && !_peak.compare_exchange_weak(peak, outstanding, std::memory_order_relaxed)) {
+	}
+
+	return frame;
+}
+
+void avframe_pool::release(std::shared_ptr<AVFrame> frame)
+{
+	if (!frame) {
+		return;
+	}
+
+	_outstanding.fetch_sub(1, std::memory_order_relaxed);
+
+	// If the pool is already full, the frame is simply freed once the last reference to it is gone.
+	try_push(frame);
+}
+
+std::size_t avframe_pool::capacity()
+{
+	return _capacity;
+}
+
+uint64_t avframe_pool::hits()
+{
+	return _hits.load(std::memory_order_relaxed);
+}
+
+uint64_t avframe_pool::misses()
+{
+	return _misses.load(std::memory_order_relaxed);
+}
+
+std::size_t avframe_pool::peak()
+{
+	return _peak.load(std::memory_order_relaxed);
+}
+
+bool avframe_pool::try_push(std::shared_ptr<AVFrame>& frame)
+{
+	std::size_t pos = _tail.load(std::memory_order_relaxed);
+	while (true) {
+		slot&       cell = _slots[pos % _capacity];
+		std::size_t seq  = cell.sequence.load(std::memory_order_acquire);
+		if (seq == pos) {
+			if (_tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+				cell.frame = std::move(frame);
+				cell.sequence.store(pos + 1, std::memory_order_release);
+				return true;
+			}
+		} else if (seq < pos) {
+			// Slot still holds a frame from the previous lap, so the pool is either full or a consumer is still
+			// busy taking the frame out of it.
+			if (pos >= (_head.load(std::memory_order_relaxed) + _capacity)) {
+				return false;
+			}
+			std::this_thread::yield();
+			pos = _tail.load(std::memory_order_relaxed);
+		} else {
+			pos = _tail.load(std::memory_order_relaxed);
+		}
+	}
+}
+
+bool avframe_pool::try_pop(std::shared_ptr<AVFrame>& frame)
+{
+	std::size_t pos = _head.load(std::memory_order_relaxed);
+	while (true) {
+		slot&       cell = _slots[pos % _capacity];
+		std::size_t seq  = cell.sequence.load(std::memory_order_acquire);
+		if (seq == (pos + 1)) {
+			if (_head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+				frame = std::move(cell.frame);
+				cell.sequence.store(pos + _capacity, std::memory_order_release);
+				return true;
+			}
+		} else if (seq < (pos + 1)) {
+			// Slot has not been filled yet, so the pool is either empty or a producer is still busy filling it.
+			if (_tail.load(std::memory_order_relaxed) <= pos) {
+				return false;
+			}
+			std::this_thread::yield();
+			pos = _head.load(std::memory_order_relaxed);
+		} else {
+			pos = _head.load(std::memory_order_relaxed);
+		}
+	}
+}
@@ -0,0 +1,91 @@
+// FFMPEG Video Encoder Integration for OBS Studio
+// Copyright (c) 2021 Michael Fabian Dirks <info@xaymar.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+#include "common.hpp"
+#include <atomic>
+#include <functional>
+#include <memory>
+
+extern "C" {
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable : 4242 4244 4365)
+#endif
+#include <libavutil/frame.h>
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+}
+
+namespace streamfx::ffmpeg {
+	/** Bounded pool of reusable frames.
+	 *
+	 * Acquiring and releasing frames is lock-free, so frames can be returned from any thread. Frames are only
+	 * allocated if the pool is empty, and frames released into a full pool are freed instead of kept.
+	 */
+	class avframe_pool {
+		public:
+		typedef std::function<std::shared_ptr<AVFrame>()> allocator_t;
+
+		private:
+		struct slot {
+			std::atomic<std::size_t> sequence;
+			std::shared_ptr<AVFrame> frame;
+		};
+
+		allocator_t             _allocator;
+		std::size_t             _capacity;
+		std::unique_ptr<slot[]> _slots;
+
+		alignas(64) std::atomic<std::size_t> _head;
+		alignas(64) std::atomic<std::size_t> _tail;
+
+		std::atomic<uint64_t>    _hits;
+		std::atomic<uint64_t>    _misses;
+		std::atomic<std::size_t> _outstanding;
+		std::atomic<std::size_t> _peak;
+
+		public:
+		avframe_pool(std::size_t capacity, allocator_t allocator);
+		~avframe_pool();
+
+		/** Allocate frames until the pool holds `count` frames, or is full. */
+		void prewarm(std::size_t count);
+
+		/** Retrieve a free frame, allocating a new one only if the pool is empty. */
+		std::shared_ptr<AVFrame> acquire();
+
+		/** Return a frame to the pool. */
+		void release(std::shared_ptr<AVFrame> frame);
+
+		std::size_t capacity();
+
+		// Statistics
+		uint64_t    hits();
+		uint64_t    misses();
+		std::size_t peak();
+
+		private:
+		bool try_push(std::shared_ptr<AVFrame>& frame);
+		bool try_pop(std::shared_ptr<AVFrame>& frame);
+	};
+} // namespace streamfx::ffmpeg
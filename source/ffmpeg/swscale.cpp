@@ -20,7 +20,12 @@
 // SOFTWARE.
 
 #include "swscale.hpp"
+#include <algorithm>
 #include <stdexcept>
+#include "plugin.hpp"
+
+// Bands smaller than this aren't worth the overhead of dispatching them to another thread.
+#define ST_SLICE_MIN_HEIGHT 64
 
 using namespace streamfx::ffmpeg;
 
@@ -157,6 +162,39 @@ bool swscale::is_target_full_range()
 	return this->target_full_range;
 }
 
+void swscale::set_slices(uint32_t count)
+{
+	this->slices = std::max<uint32_t>(count, 1);
+}
+
+uint32_t swscale::get_slices()
+{
+	return this->slices;
+}
+
+uint32_t swscale::get_active_slices()
+{
+	return std::max<uint32_t>(static_cast<uint32_t>(this->slice_contexts.size()), 1);
+}
+
+static SwsContext* create_context(int32_t source_width, int32_t source_height, AVPixelFormat source_format,
+								  bool source_full_range, AVColorSpace source_colorspace, int32_t target_width,
+								  int32_t target_height, AVPixelFormat target_format, bool target_full_range,
+								  AVColorSpace target_colorspace, int flags)
+{
+	SwsContext* context = sws_getContext(source_width, source_height, source_format, target_width, target_height,
+										 target_format, flags, nullptr, nullptr, nullptr);
+	if (!context) {
+		return nullptr;
+	}
+
+	sws_setColorspaceDetails(context, sws_getCoefficients(source_colorspace), source_full_range ? 1 : 0,
+							 sws_getCoefficients(target_colorspace), target_full_range ? 1 : 0, 1L << 16 | 0L,
+							 1L << 16 | 0L, 1L << 16 | 0L);
+
+	return context;
+}
+
 bool swscale::initialize(int flags)
 {
 	if (this->context) {
@@ -171,23 +209,64 @@ bool swscale::initialize(int flags)
 		throw std::invalid_argument("not all target parameters were set");
 	}
 
-	this->context =
-		sws_getContext(static_cast<int>(source_size.first), static_cast<int>(source_size.second), source_format,
-					   static_cast<int>(target_size.first), static_cast<int>(target_size.second), target_format, flags,
-					   nullptr, nullptr, nullptr);
+	this->context = create_context(static_cast<int32_t>(source_size.first), static_cast<int32_t>(source_size.second),
+								   source_format, source_full_range, source_colorspace,
+								   static_cast<int32_t>(target_size.first), static_cast<int32_t>(target_size.second),
+								   target_format, target_full_range, target_colorspace, flags);
 	if (!this->context) {
 		return false;
 	}
 
-	sws_setColorspaceDetails(this->context, sws_getCoefficients(source_colorspace), source_full_range ? 1 : 0,
-							 sws_getCoefficients(target_colorspace), target_full_range ? 1 : 0, 1L << 16 | 0L,
-							 1L << 16 | 0L, 1L << 16 | 0L);
+	// Slicing is only possible if every output row depends on the matching input row, which is not the case when
+	// scaling, nor for formats that aren't simple planar or packed images.
+	auto source_desc = av_pix_fmt_desc_get(source_format);
+	auto target_desc = av_pix_fmt_desc_get(target_format);
+	if ((slices <= 1) || (source_size != target_size) || !source_desc || !target_desc
+		|| ((source_desc->flags | target_desc->flags) & (AV_PIX_FMT_FLAG_PAL | AV_PIX_FMT_FLAG_BITSTREAM))) {
+		return true;
+	}
+
+	// Bands must start on a row that exists in every plane, so align them to the vertical chroma subsampling.
+	int32_t height    = static_cast<int32_t>(source_size.second);
+	int32_t alignment = 1 << std::max(source_desc->log2_chroma_h, target_desc->log2_chroma_h);
+	int32_t count     = std::min(static_cast<int32_t>(slices), std::max(height / ST_SLICE_MIN_HEIGHT, 1));
+	int32_t band      = (((height + count - 1) / count) + alignment - 1) / alignment * alignment;
+	if (band >= height) {
+		return true;
+	}
+
+	for (int32_t row = 0; row < height; row += band) {
+		int32_t rows = std::min(band, height - row);
+
+		SwsContext* slice_context =
+			create_context(static_cast<int32_t>(source_size.first), rows, source_format, source_full_range,
+						   source_colorspace, static_cast<int32_t>(target_size.first), rows, target_format,
+						   target_full_range, target_colorspace, flags);
+		if (!slice_context) {
+			// Not fatal, we can still convert everything on a single thread.
+			finalize_slices();
+			return true;
+		}
+
+		slice_bands.emplace_back(row, rows);
+		slice_contexts.push_back(slice_context);
+	}
 
 	return true;
 }
 
+void swscale::finalize_slices()
+{
+	for (auto slice_context : slice_contexts) {
+		sws_freeContext(slice_context);
+	}
+	slice_contexts.clear();
+	slice_bands.clear();
+}
+
 bool swscale::finalize()
 {
+	finalize_slices();
 	if (this->context) {
 		sws_freeContext(this->context);
 		this->context = nullptr;
@@ -202,7 +281,56 @@ int32_t swscale::convert(const uint8_t* const source_data[], const int source_st
 	if (!this->context) {
 		return 0;
 	}
+	if ((slice_contexts.size() > 1) && (source_row == 0)
+		&& (source_rows == static_cast<int32_t>(source_size.second))) {
+		return convert_sliced(source_data, source_stride, target_data, target_stride);
+	}
 	int height =
 		sws_scale(this->context, source_data, source_stride, source_row, source_rows, target_data, target_stride);
 	return height;
 }
+
+template<typename T>
+static void offset_planes(AVPixelFormat format, int32_t row, T* const data[], const int stride[], T* output[4])
+{
+	auto desc = av_pix_fmt_desc_get(format);
+	for (std::size_t plane = 0; plane < 4; plane++) {
+		if (!data[plane]) {
+			output[plane] = nullptr;
+			continue;
+		}
+
+		// Only the chroma planes are subsampled, luma and alpha always have full height.
+		int32_t plane_row = ((plane == 1) || (plane == 2)) ? (row >> desc->log2_chroma_h) : row;
+		output[plane]     = data[plane] + static_cast<ptrdiff_t>(plane_row) * stride[plane];
+	}
+}
+
+int32_t swscale::convert_sliced(const uint8_t* const source_data[], const int source_stride[],
+								uint8_t* const target_data[], const int target_stride[])
+{
+	std::vector<int32_t> heights(slice_contexts.size(), 0);
+
+	// Bands are converted by the thread pool, and this thread, until all of them are done.
+	::streamfx::threadpool()->parallel_for(0, slice_contexts.size(), 1, [&](std::size_t begin, std::size_t end) {
+		for (std::size_t idx = begin; idx < end; idx++) {
+			const uint8_t* source_band[4];
+			uint8_t*       target_band[4];
+			offset_planes(source_format, slice_bands[idx].first, source_data, source_stride, source_band);
+			offset_planes(target_format, slice_bands[idx].first, target_data, target_stride, target_band);
+
+			heights[idx] = sws_scale(slice_contexts[idx], source_band, source_stride, 0, slice_bands[idx].second,
+									 target_band, target_stride);
+		}
+	});
+
+	// Report the same as sws_scale would: the total output height, or the first error.
+	int32_t height = 0;
+	for (auto band_height : heights) {
+		if (band_height <= 0) {
+			return band_height;
+		}
+		height += band_height;
+	}
+	return height;
+}
@@ -22,12 +22,14 @@
 #pragma once
 #include "common.hpp"
 #include <utility>
+#include <vector>
 
 extern "C" {
 #ifdef _MSC_VER
 #pragma warning(push)
 #pragma warning(disable : 4242 4244 4365)
 #endif
+#include <libavutil/pixdesc.h>
 #include <libavutil/pixfmt.h>
 #include <libswscale/swscale.h>
 #ifdef _MSC_VER
@@ -49,6 +51,11 @@ namespace streamfx::ffmpeg {
 
 		SwsContext* context = nullptr;
 
+		// Slice-threading: One context per horizontal band, only available if no scaling is done.
+		uint32_t                                 slices = 1;
+		std::vector<std::pair<int32_t, int32_t>> slice_bands;
+		std::vector<SwsContext*>                 slice_contexts;
+
 		public:
 		swscale();
 		~swscale();
@@ -79,10 +86,19 @@ namespace streamfx::ffmpeg {
 		void                          set_target_full_range(bool full_range);
 		bool                          is_target_full_range();
 
+		void     set_slices(uint32_t count);
+		uint32_t get_slices();
+		uint32_t get_active_slices();
+
 		bool initialize(int flags);
 		bool finalize();
 
 		int32_t convert(const uint8_t* const source_data[], const int source_stride[], int32_t source_row,
 						int32_t source_rows, uint8_t* const target_data[], const int target_stride[]);
+
+		private:
+		void    finalize_slices();
+		int32_t convert_sliced(const uint8_t* const source_data[], const int source_stride[],
+							   uint8_t* const target_data[], const int target_stride[]);
 	};
 } // namespace streamfx::ffmpeg
@@ -467,11 +467,9 @@ void autoframing_instance::video_render(gs_effect_t* effect)
 		return;
 	}
 
-#ifdef ENABLE_PROFILING
 	::streamfx::obs::gs::debug_marker profiler0{::streamfx::obs::gs::debug_color_source, "StreamFX Auto-Framing"};
 	::streamfx::obs::gs::debug_marker profiler0_0{::streamfx::obs::gs::debug_color_gray, "'%s' on '%s'",
 												  obs_source_get_name(_self), obs_source_get_name(parent)};
-#endif
 
 	if (_dirty) {
 		// Capture the input.
@@ -526,9 +524,7 @@ void autoframing_instance::video_render(gs_effect_t* effect)
 	}
 
 	{ // Draw the result for the next filter to use.
-#ifdef ENABLE_PROFILING
 		::streamfx::obs::gs::debug_marker profiler1{::streamfx::obs::gs::debug_color_render, "Render"};
-#endif
 
 		if (_debug) { // Debug Mode
 			gs_effect_set_texture(gs_effect_get_param_by_name(effect, "image"), _input->get_object());
@@ -890,7 +886,8 @@ void streamfx::filter::autoframing::autoframing_instance::switch_provider(tracki
 
 	// Then spawn a new task to switch provider.
 	_provider_task = streamfx::threadpool()->push(
-		std::bind(&autoframing_instance::task_switch_provider, this, std::placeholders::_1), spd);
+		std::bind(&autoframing_instance::task_switch_provider, this, std::placeholders::_1), spd,
+		::streamfx::util::threadpool_priority::LOW);
 }
 
 void streamfx::filter::autoframing::autoframing_instance::task_switch_provider(util::threadpool_data_t data)
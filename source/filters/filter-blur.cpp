@@ -29,6 +29,7 @@
 #include "gfx/blur/gfx-blur-dual-filtering.hpp"
 #include "gfx/blur/gfx-blur-gaussian-linear.hpp"
 #include "gfx/blur/gfx-blur-gaussian.hpp"
+#include "gfx/blur/gfx-blur-pyramid.hpp"
 #include "obs/gs/gs-helper.hpp"
 #include "obs/obs-source-tracker.hpp"
 #include "util/util-logging.hpp"
@@ -133,6 +134,9 @@ static std::map<std::string, local_blur_type_t> list_of_types = {
 	{"gaussian", {&::streamfx::gfx::blur::gaussian_factory::get, S_BLUR_TYPE_GAUSSIAN}},
 	{"gaussian_linear", {&::streamfx::gfx::blur::gaussian_linear_factory::get, S_BLUR_TYPE_GAUSSIAN_LINEAR}},
 	{"dual_filtering", {&::streamfx::gfx::blur::dual_filtering_factory::get, S_BLUR_TYPE_DUALFILTERING}},
+	{"dual_filtering_radius",
+	 {&::streamfx::gfx::blur::dual_filtering_factory::get_radius, S_BLUR_TYPE_DUALFILTERING_RADIUS}},
+	{"pyramid", {&::streamfx::gfx::blur::pyramid_factory::get, S_BLUR_TYPE_PYRAMID}},
 };
 static std::map<std::string, local_blur_subtype_t> list_of_subtypes = {
 	{"area", {::streamfx::gfx::blur::type::Area, S_BLUR_SUBTYPE_AREA}},
@@ -142,15 +146,12 @@ static std::map<std::string, local_blur_subtype_t> list_of_subtypes = {
 };
 
 blur_instance::blur_instance(obs_data_t* settings, obs_source_t* self)
-	: obs::source_instance(settings, self), _source_rendered(false), _output_rendered(false)
+	: obs::source_instance(settings, self), _rt_pool(streamfx::obs::gs::rendertarget_pool::get()),
+	  _source_rendered(false), _output_rendered(false), _output_dirty(true)
 {
 	{
 		auto gctx = streamfx::obs::gs::context();
 
-		// Create RenderTargets
-		this->_source_rt = std::make_shared<streamfx::obs::gs::rendertarget>(GS_RGBA, GS_ZS_NONE);
-		this->_output_rt = std::make_shared<streamfx::obs::gs::rendertarget>(GS_RGBA, GS_ZS_NONE);
-
 		// Load Effects
 		{
 			auto file = streamfx::data_file_path("effects/mask.effect");
@@ -339,6 +340,8 @@ void blur_instance::update(obs_data_t* settings)
 			}
 		}
 	}
+
+	_output_dirty = true;
 }
 
 void blur_instance::video_tick(float)
@@ -387,8 +390,18 @@ void blur_instance::video_tick(float)
 		}
 	}
 
+	// The output is only kept for reuse while the filter keeps being drawn. Hidden filters are not rendered, and
+	// should not hold on to a full size render target until they are shown again.
+	if (!_source_rendered) {
+		_output_texture.reset();
+		_output_rt.reset();
+	}
+
+	// Return the input to the pool, it is leased again when this is rendered.
 	_source_rendered = false;
 	_output_rendered = false;
+	_source_texture.reset();
+	_source_rt.reset();
 }
 
 void blur_instance::video_render(gs_effect_t* effect)
@@ -405,21 +418,18 @@ void blur_instance::video_render(gs_effect_t* effect)
 		return;
 	}
 
-#ifdef ENABLE_PROFILING
 	streamfx::obs::gs::debug_marker gdmp{streamfx::obs::gs::debug_color_source, "Blur '%s'",
 										 obs_source_get_name(_self)};
-#endif
 
 	if (!_source_rendered) {
 		// Source To Texture
 		{
-#ifdef ENABLE_PROFILING
 			streamfx::obs::gs::debug_marker gdm{streamfx::obs::gs::debug_color_cache, "Cache"};
-#endif
 
 			if (obs_source_process_filter_begin(this->_self, GS_RGBA, OBS_ALLOW_DIRECT_RENDERING)) {
 				{
-					auto op = this->_source_rt->render(baseW, baseH);
+					this->_source_rt = _rt_pool->acquire(GS_RGBA, GS_ZS_NONE, baseW, baseH);
+					auto op          = this->_source_rt->render(baseW, baseH);
 
 					gs_blend_state_push();
 					gs_reset_blend_state();
@@ -458,14 +468,20 @@ void blur_instance::video_render(gs_effect_t* effect)
 			}
 		}
 
+		// Static input produces the same output every frame, so reuse the previous output. Masks from other sources
+		// may change on their own, so those always have to be rendered.
+		bool unchanged = _source_tracker.track(_source_texture);
+		if (unchanged && !_output_dirty && _output_texture
+			&& !(_mask.enabled && (_mask.type == mask_type::Source))) {
+			_output_rendered = true;
+		}
+
 		_source_rendered = true;
 	}
 
 	if (!_output_rendered) {
 		{
-#ifdef ENABLE_PROFILING
 			streamfx::obs::gs::debug_marker gdm{streamfx::obs::gs::debug_color_convert, "Blur"};
-#endif
 
 			_blur->set_input(_source_texture);
 			_output_texture = _blur->render();
@@ -473,9 +489,7 @@ void blur_instance::video_render(gs_effect_t* effect)
 
 		// Mask
 		if (_mask.enabled) {
-#ifdef ENABLE_PROFILING
 			streamfx::obs::gs::debug_marker gdm{streamfx::obs::gs::debug_color_convert, "Mask"};
-#endif
 
 			gs_blend_state_push();
 			gs_reset_blend_state();
@@ -531,10 +545,8 @@ void blur_instance::video_render(gs_effect_t* effect)
 					}
 				}
 
-#ifdef ENABLE_PROFILING
 				streamfx::obs::gs::debug_marker gdm{streamfx::obs::gs::debug_color_capture, "Capture '%s'",
 													obs_source_get_name(_mask.source.source_texture->get_object())};
-#endif
 
 				this->_mask.source.texture = this->_mask.source.source_texture->render(source_width, source_height);
 			}
@@ -542,7 +554,8 @@ void blur_instance::video_render(gs_effect_t* effect)
 			apply_mask_parameters(_effect_mask, _source_texture->get_object(), _output_texture->get_object());
 
 			try {
-				auto op = this->_output_rt->render(baseW, baseH);
+				this->_output_rt = _rt_pool->acquire(GS_RGBA, GS_ZS_NONE, baseW, baseH);
+				auto op          = this->_output_rt->render(baseW, baseH);
 				gs_ortho(0, 1, 0, 1, -1, 1);
 
 				// Render
@@ -563,13 +576,12 @@ void blur_instance::video_render(gs_effect_t* effect)
 		}
 
 		_output_rendered = true;
+		_output_dirty    = false;
 	}
 
 	// Draw source
 	{
-#ifdef ENABLE_PROFILING
 		streamfx::obs::gs::debug_marker gdm{streamfx::obs::gs::debug_color_render, "Render"};
-#endif
 
 		// It is important that we do not modify the blend state here, as it is set correctly by OBS
 		gs_set_cull_mode(GS_NEITHER);
@@ -799,6 +811,8 @@ obs_properties_t* blur_factory::get_properties2(blur_instance* data)
 		obs_property_list_add_string(p, D_TRANSLATE(S_BLUR_TYPE_GAUSSIAN), "gaussian");
 		obs_property_list_add_string(p, D_TRANSLATE(S_BLUR_TYPE_GAUSSIAN_LINEAR), "gaussian_linear");
 		obs_property_list_add_string(p, D_TRANSLATE(S_BLUR_TYPE_DUALFILTERING), "dual_filtering");
+		obs_property_list_add_string(p, D_TRANSLATE(S_BLUR_TYPE_DUALFILTERING_RADIUS), "dual_filtering_radius");
+		obs_property_list_add_string(p, D_TRANSLATE(S_BLUR_TYPE_PYRAMID), "pyramid");
 
 		p = obs_properties_add_list(pr, ST_KEY_SUBTYPE, D_TRANSLATE(ST_I18N_SUBTYPE), OBS_COMBO_TYPE_LIST,
 									OBS_COMBO_FORMAT_STRING);
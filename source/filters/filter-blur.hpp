@@ -24,9 +24,11 @@
 #include <list>
 #include <map>
 #include "gfx/blur/gfx-blur-base.hpp"
+#include "gfx/gfx-content-tracker.hpp"
 #include "gfx/gfx-source-texture.hpp"
 #include "obs/gs/gs-effect.hpp"
 #include "obs/gs/gs-helper.hpp"
+#include "obs/gs/gs-rendertarget-pool.hpp"
 #include "obs/gs/gs-rendertarget.hpp"
 #include "obs/gs/gs-texture.hpp"
 #include "obs/obs-source-factory.hpp"
@@ -42,15 +44,20 @@ namespace streamfx::filter::blur {
 		// Effects
 		streamfx::obs::gs::effect _effect_mask;
 
+		// Leased from the pool for the current frame, or for as long as the output is reused.
+		std::shared_ptr<streamfx::obs::gs::rendertarget_pool> _rt_pool;
+
 		// Input
 		std::shared_ptr<streamfx::obs::gs::rendertarget> _source_rt;
 		std::shared_ptr<streamfx::obs::gs::texture>      _source_texture;
 		bool                                             _source_rendered;
+		streamfx::gfx::content_tracker                   _source_tracker;
 
-		// Rendering
+		// Rendering, kept across frames for as long as the input and settings don't change.
 		std::shared_ptr<streamfx::obs::gs::texture>      _output_texture;
 		std::shared_ptr<streamfx::obs::gs::rendertarget> _output_rt;
 		bool                                             _output_rendered;
+		bool                                             _output_dirty;
 
 		// Blur
 		std::shared_ptr<::streamfx::gfx::blur::base> _blur;
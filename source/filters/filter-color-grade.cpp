@@ -133,7 +133,9 @@ color_grade_instance::color_grade_instance(obs_data_t* data, obs_source_t* self)
 	  _lift(), _gamma(), _gain(), _offset(), _tint_detection(), _tint_luma(), _tint_exponent(), _tint_low(),
 	  _tint_mid(), _tint_hig(), _correction(), _lut_enabled(true), _lut_depth(),
 
-	  _cache_rt(), _cache_texture(), _cache_fresh(false),
+	  _rt_pool(streamfx::obs::gs::rendertarget_pool::get()),
+
+	  _cache_rt(), _cache_texture(), _cache_fresh(false), _cache_dirty(true),
 
 	  _lut_initialized(false), _lut_dirty(true), _lut_producer(), _lut_consumer()
 {
@@ -160,24 +162,11 @@ color_grade_instance::color_grade_instance(obs_data_t* data, obs_source_t* self)
 			D_LOG_WARNING("Failed to initialize LUT rendering, falling back to direct rendering.\n%s", ex.what());
 			_lut_initialized = false;
 		}
-
-		// Allocate render target for rendering.
-		try {
-			allocate_rendertarget(GS_RGBA);
-		} catch (std::exception const& ex) {
-			D_LOG_ERROR("Failed to acquire render target for rendering: %s", ex.what());
-			throw;
-		}
 	}
 
 	update(data);
 }
 
-void color_grade_instance::allocate_rendertarget(gs_color_format format)
-{
-	_cache_rt = std::make_unique<streamfx::obs::gs::rendertarget>(format, GS_ZS_NONE);
-}
-
 float_t fix_gamma_value(double_t v)
 {
 	if (v < 0.0) {
@@ -244,6 +233,8 @@ void color_grade_instance::update(obs_data_t* data)
 
 	if (_lut_enabled && _lut_initialized)
 		_lut_dirty = true;
+
+	_cache_dirty = true;
 }
 
 void color_grade_instance::prepare_effect()
@@ -299,9 +290,7 @@ void color_grade_instance::prepare_effect()
 
 void color_grade_instance::rebuild_lut()
 {
-#ifdef ENABLE_PROFILING
 	streamfx::obs::gs::debug_marker gdm{streamfx::obs::gs::debug_color_cache, "Rebuild LUT"};
-#endif
 
 	// Generate a fresh LUT texture.
 	auto lut_texture = _lut_producer->produce(_lut_depth);
@@ -353,8 +342,19 @@ void color_grade_instance::rebuild_lut()
 
 void color_grade_instance::video_tick(float)
 {
+	// The render cache is only kept for reuse while the filter keeps being drawn. Hidden filters are not rendered, and
+	// should not hold on to a full size render target until they are shown again.
+	if (!_ccache_fresh) {
+		_cache_texture.reset();
+		_cache_rt.reset();
+	}
+
 	_ccache_fresh = false;
 	_cache_fresh  = false;
+
+	// Return the capture to the pool, it is leased again when this is rendered.
+	_ccache_texture.reset();
+	_ccache_rt.reset();
 }
 
 void color_grade_instance::video_render(gs_effect_t* shader)
@@ -373,27 +373,19 @@ void color_grade_instance::video_render(gs_effect_t* shader)
 		return;
 	}
 
-#ifdef ENABLE_PROFILING
 	streamfx::obs::gs::debug_marker gdmp{streamfx::obs::gs::debug_color_source, "Color Grading '%s'",
 										 obs_source_get_name(_self)};
-#endif
 
 	// TODO: Optimize this once (https://github.com/obsproject/obs-studio/pull/4199) is merged.
 	// - We can skip the original capture and reduce the overall impact of this.
 
 	// 1. Capture the filter/source rendered above this.
 	if (!_ccache_fresh || !_ccache_texture) {
-#ifdef ENABLE_PROFILING
 		streamfx::obs::gs::debug_marker gdmp{streamfx::obs::gs::debug_color_cache, "Cache '%s'",
 											 obs_source_get_name(target)};
-#endif
-		// If the input cache render target doesn't exist, create it.
-		if (!_ccache_rt) {
-			_ccache_rt = std::make_shared<streamfx::obs::gs::rendertarget>(GS_RGBA, GS_ZS_NONE);
-		}
-
 		{
-			auto op = _ccache_rt->render(width, height);
+			_ccache_rt = _rt_pool->acquire(GS_RGBA, GS_ZS_NONE, width, height);
+			auto op    = _ccache_rt->render(width, height);
 			gs_ortho(0, static_cast<float_t>(width), 0, static_cast<float_t>(height), 0, 1);
 
 			// Blank out the input cache.
@@ -434,14 +426,17 @@ void color_grade_instance::video_render(gs_effect_t* shader)
 
 		// Mark the input cache as valid.
 		_ccache_fresh = true;
+
+		// If the input hasn't changed, the render cache from the last frame is still valid.
+		if (_ccache_tracker.track(_ccache_texture) && !_cache_dirty && _cache_texture) {
+			_cache_fresh = true;
+		}
 	}
 
 	// 2. Apply one of the two rendering methods (LUT or Direct).
 	if (_lut_initialized && _lut_enabled) { // Try to apply with the LUT based method.
 		try {
-#ifdef ENABLE_PROFILING
 			streamfx::obs::gs::debug_marker gdm{streamfx::obs::gs::debug_color_convert, "LUT Rendering"};
-#endif
 			// If the LUT was changed, rebuild the LUT first.
 			if (_lut_dirty) {
 				rebuild_lut();
@@ -450,14 +445,10 @@ void color_grade_instance::video_render(gs_effect_t* shader)
 				_cache_fresh = false;
 			}
 
-			// Reallocate the rendertarget if necessary.
-			if (_cache_rt->get_color_format() != GS_RGBA) {
-				allocate_rendertarget(GS_RGBA);
-			}
-
 			if (!_cache_fresh) {
 				{ // Render the source to the cache.
-					auto op = _cache_rt->render(width, height);
+					_cache_rt = _rt_pool->acquire(GS_RGBA, GS_ZS_NONE, width, height);
+					auto op   = _cache_rt->render(width, height);
 					gs_ortho(0, 1., 0, 1., 0, 1);
 
 					// Blank out the input cache.
@@ -495,26 +486,22 @@ void color_grade_instance::video_render(gs_effect_t* shader)
 
 				// Mark the render cache as valid.
 				_cache_fresh = true;
+				_cache_dirty = false;
 			}
 		} catch (std::exception const& ex) {
 			// If anything happened, revert to direct rendering.
 			_lut_rt.reset();
 			_lut_texture.reset();
 			_lut_enabled = false;
+			_cache_fresh = false;
 			D_LOG_WARNING("Reverting to direct rendering due to error: %s", ex.what());
 		}
 	}
 	if ((!_lut_initialized || !_lut_enabled) && !_cache_fresh) {
-#ifdef ENABLE_PROFILING
 		streamfx::obs::gs::debug_marker gdm{streamfx::obs::gs::debug_color_convert, "Direct Rendering"};
-#endif
-		// Reallocate the rendertarget if necessary.
-		if (_cache_rt->get_color_format() != GS_RGBA) {
-			allocate_rendertarget(GS_RGBA);
-		}
-
 		{ // Render the source to the cache.
-			auto op = _cache_rt->render(width, height);
+			_cache_rt = _rt_pool->acquire(GS_RGBA, GS_ZS_NONE, width, height);
+			auto op   = _cache_rt->render(width, height);
 			gs_ortho(0, 1, 0, 1, 0, 1);
 
 			prepare_effect();
@@ -554,6 +541,7 @@ void color_grade_instance::video_render(gs_effect_t* shader)
 
 		// Mark the render cache as valid.
 		_cache_fresh = true;
+		_cache_dirty = false;
 	}
 	if (!_cache_texture) {
 		throw std::runtime_error("Failed to cache processed source.");
@@ -561,9 +549,7 @@ void color_grade_instance::video_render(gs_effect_t* shader)
 
 	// 3. Render the output cache.
 	{
-#ifdef ENABLE_PROFILING
 		streamfx::obs::gs::debug_marker gdm{streamfx::obs::gs::debug_color_cache_render, "Draw Cache"};
-#endif
 		// Revert GPU status to what OBS Studio expects.
 		gs_enable_depth_test(false);
 		gs_enable_color(true, true, true, true);
@@ -19,10 +19,12 @@
 
 #pragma once
 #include <vector>
+#include "gfx/gfx-content-tracker.hpp"
 #include "gfx/lut/gfx-lut-consumer.hpp"
 #include "gfx/lut/gfx-lut-producer.hpp"
 #include "gfx/lut/gfx-lut.hpp"
 #include "obs/gs/gs-mipmapper.hpp"
+#include "obs/gs/gs-rendertarget-pool.hpp"
 #include "obs/gs/gs-rendertarget.hpp"
 #include "obs/gs/gs-texture.hpp"
 #include "obs/gs/gs-vertexbuffer.hpp"
@@ -62,10 +64,14 @@ namespace streamfx::filter::color_grade {
 		bool                            _lut_enabled;
 		streamfx::gfx::lut::color_depth _lut_depth;
 
+		// Leased from the pool for the current frame, or for as long as the render cache is reused.
+		std::shared_ptr<streamfx::obs::gs::rendertarget_pool> _rt_pool;
+
 		// Capture Cache
 		std::shared_ptr<streamfx::obs::gs::rendertarget> _ccache_rt;
 		std::shared_ptr<streamfx::obs::gs::texture>      _ccache_texture;
 		bool                                             _ccache_fresh;
+		streamfx::gfx::content_tracker                   _ccache_tracker;
 
 		// LUT work flow
 		bool                                             _lut_initialized;
@@ -79,13 +85,12 @@ namespace streamfx::filter::color_grade {
 		std::shared_ptr<streamfx::obs::gs::rendertarget> _cache_rt;
 		std::shared_ptr<streamfx::obs::gs::texture>      _cache_texture;
 		bool                                             _cache_fresh;
+		bool                                             _cache_dirty;
 
 		public:
 		color_grade_instance(obs_data_t* data, obs_source_t* self);
 		virtual ~color_grade_instance();
 
-		void allocate_rendertarget(gs_color_format format);
-
 		virtual void load(obs_data_t* data) override;
 		virtual void migrate(obs_data_t* data, uint64_t version) override;
 		virtual void update(obs_data_t* data) override;
@@ -257,11 +257,9 @@ void denoising_instance::video_render(gs_effect_t* effect)
 		return;
 	}
 
-#ifdef ENABLE_PROFILING
 	::streamfx::obs::gs::debug_marker profiler0{::streamfx::obs::gs::debug_color_source, "StreamFX Denoising"};
 	::streamfx::obs::gs::debug_marker profiler0_0{::streamfx::obs::gs::debug_color_gray, "'%s' on '%s'",
 												  obs_source_get_name(_self), obs_source_get_name(parent)};
-#endif
 
 	if (_dirty) { // Lock the provider from being changed.
 		std::unique_lock<std::mutex> ul(_provider_lock);
@@ -280,9 +278,7 @@ void denoising_instance::video_render(gs_effect_t* effect)
 		}
 
 		{ // Capture the incoming frame.
-#ifdef ENABLE_PROFILING
 			::streamfx::obs::gs::debug_marker profiler1{::streamfx::obs::gs::debug_color_capture, "Capture"};
-#endif
 			if (obs_source_process_filter_begin(_self, GS_RGBA, OBS_ALLOW_DIRECT_RENDERING)) {
 				auto op = _input->render(_size.first, _size.second);
 
@@ -302,9 +298,7 @@ void denoising_instance::video_render(gs_effect_t* effect)
 				gs_set_cull_mode(GS_NEITHER);
 
 				// Render
-#ifdef ENABLE_PROFILING
 				::streamfx::obs::gs::debug_marker profiler2{::streamfx::obs::gs::debug_color_capture, "Storage"};
-#endif
 				obs_source_process_filter_end(_self, obs_get_base_effect(OBS_EFFECT_DEFAULT), 1, 1);
 
 				// Reset GPU state
@@ -317,9 +311,7 @@ void denoising_instance::video_render(gs_effect_t* effect)
 		}
 
 		try { // Process the captured input with the provider.
-#ifdef ENABLE_PROFILING
 			::streamfx::obs::gs::debug_marker profiler1{::streamfx::obs::gs::debug_color_convert, "Process"};
-#endif
 			switch (_provider) {
 #ifdef ENABLE_FILTER_DENOISING_NVIDIA
 			case denoising_provider::NVIDIA_DENOISING:
@@ -348,9 +340,7 @@ void denoising_instance::video_render(gs_effect_t* effect)
 	}
 
 	{ // Draw the result for the next filter to use.
-#ifdef ENABLE_PROFILING
 		::streamfx::obs::gs::debug_marker profiler1{::streamfx::obs::gs::debug_color_render, "Render"};
-#endif
 		if (_standard_effect->has_parameter("InputA", ::streamfx::obs::gs::effect_parameter::type::Texture)) {
 			_standard_effect->get_parameter("InputA").set_texture(_output);
 		}
@@ -403,7 +393,8 @@ void streamfx::filter::denoising::denoising_instance::switch_provider(denoising_
 
 	// Then spawn a new task to switch provider.
 	_provider_task = streamfx::threadpool()->push(
-		std::bind(&denoising_instance::task_switch_provider, this, std::placeholders::_1), spd);
+		std::bind(&denoising_instance::task_switch_provider, this, std::placeholders::_1), spd,
+		::streamfx::util::threadpool_priority::LOW);
 }
 
 void streamfx::filter::denoising::denoising_instance::task_switch_provider(util::threadpool_data_t data)
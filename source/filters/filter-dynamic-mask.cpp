@@ -73,16 +73,14 @@ static std::pair<channel, const char*> channel_translations[] = {
 };
 
 dynamic_mask_instance::dynamic_mask_instance(obs_data_t* settings, obs_source_t* self)
-	: obs::source_instance(settings, self), _translation_map(), _effect(), _have_filter_texture(false), _filter_rt(),
+	: obs::source_instance(settings, self), _translation_map(), _effect(),
+	  _rt_pool(streamfx::obs::gs::rendertarget_pool::get()), _have_filter_texture(false), _filter_rt(),
 	  _filter_texture(), _have_input_texture(false), _input(), _input_capture(), _input_texture(),
 	  _have_final_texture(false), _final_rt(), _final_texture(), _channels(), _precalc()
 {
 	{
 		auto gctx = streamfx::obs::gs::context();
 
-		_filter_rt = std::make_shared<streamfx::obs::gs::rendertarget>(GS_RGBA, GS_ZS_NONE);
-		_final_rt  = std::make_shared<streamfx::obs::gs::rendertarget>(GS_RGBA, GS_ZS_NONE);
-
 		{
 			auto file = streamfx::data_file_path("effects/channel-mask.effect");
 			try {
@@ -209,6 +207,12 @@ void dynamic_mask_instance::video_tick(float)
 	_have_input_texture  = false;
 	_have_filter_texture = false;
 	_have_final_texture  = false;
+
+	// Return everything to the pool, it is leased again when this is rendered.
+	_filter_texture.reset();
+	_filter_rt.reset();
+	_final_texture.reset();
+	_final_rt.reset();
 }
 
 void dynamic_mask_instance::video_render(gs_effect_t* in_effect)
@@ -226,21 +230,18 @@ void dynamic_mask_instance::video_render(gs_effect_t* in_effect)
 		return;
 	}
 
-#ifdef ENABLE_PROFILING
 	streamfx::obs::gs::debug_marker gdmp{streamfx::obs::gs::debug_color_source, "Dynamic Mask '%s' on '%s'",
 										 obs_source_get_name(_self), obs_source_get_name(obs_filter_get_parent(_self))};
-#endif
 
 	gs_effect_t* default_effect = obs_get_base_effect(obs_base_effect::OBS_EFFECT_DEFAULT);
 
 	try { // Capture filter and input
 		if (!_have_filter_texture) {
-#ifdef ENABLE_PROFILING
 			streamfx::obs::gs::debug_marker gdm{streamfx::obs::gs::debug_color_cache, "Cache"};
-#endif
 
 			if (obs_source_process_filter_begin(_self, GS_RGBA, OBS_ALLOW_DIRECT_RENDERING)) {
-				auto op = _filter_rt->render(width, height);
+				_filter_rt = _rt_pool->acquire(GS_RGBA, GS_ZS_NONE, width, height);
+				auto op    = _filter_rt->render(width, height);
 
 				gs_blend_state_push();
 				gs_reset_blend_state();
@@ -271,10 +272,8 @@ void dynamic_mask_instance::video_render(gs_effect_t* in_effect)
 		}
 
 		if (!_have_input_texture) {
-#ifdef ENABLE_PROFILING
 			streamfx::obs::gs::debug_marker gdm{streamfx::obs::gs::debug_color_capture, "Capture '%s'",
 												obs_source_get_name(_input_capture->get_object())};
-#endif
 
 			_input_texture      = _input_capture->render(_input->width(), _input->height());
 			_have_input_texture = true;
@@ -282,12 +281,11 @@ void dynamic_mask_instance::video_render(gs_effect_t* in_effect)
 
 		// Draw source
 		if (!_have_final_texture) {
-#ifdef ENABLE_PROFILING
 			streamfx::obs::gs::debug_marker gdm{streamfx::obs::gs::debug_color_convert, "Masking"};
-#endif
 
 			{
-				auto op = _final_rt->render(width, height);
+				_final_rt = _rt_pool->acquire(GS_RGBA, GS_ZS_NONE, width, height);
+				auto op   = _final_rt->render(width, height);
 
 				gs_blend_state_push();
 				gs_reset_blend_state();
@@ -339,9 +337,7 @@ void dynamic_mask_instance::video_render(gs_effect_t* in_effect)
 
 	// Draw source
 	{
-#ifdef ENABLE_PROFILING
 		streamfx::obs::gs::debug_marker gdm{streamfx::obs::gs::debug_color_render, "Render"};
-#endif
 
 		// It is important that we do not modify the blend state here, as it is set correctly by OBS
 		gs_set_cull_mode(GS_NEITHER);
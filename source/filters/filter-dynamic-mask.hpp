@@ -23,6 +23,7 @@
 #include <map>
 #include "gfx/gfx-source-texture.hpp"
 #include "obs/gs/gs-effect.hpp"
+#include "obs/gs/gs-rendertarget-pool.hpp"
 #include "obs/obs-source-factory.hpp"
 #include "obs/obs-source-tracker.hpp"
 #include "obs/obs-source.hpp"
@@ -36,6 +37,9 @@ namespace streamfx::filter::dynamic_mask {
 
 		streamfx::obs::gs::effect _effect;
 
+		// Leased from the pool for the current frame only.
+		std::shared_ptr<streamfx::obs::gs::rendertarget_pool> _rt_pool;
+
 		bool                                             _have_filter_texture;
 		std::shared_ptr<streamfx::obs::gs::rendertarget> _filter_rt;
 		std::shared_ptr<streamfx::obs::gs::texture>      _filter_texture;
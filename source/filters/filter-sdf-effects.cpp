@@ -19,6 +19,7 @@
 
 #include "filter-sdf-effects.hpp"
 #include "strings.hpp"
+#include <algorithm>
 #include <stdexcept>
 #include "obs/gs/gs-helper.hpp"
 #include "util/util-logging.hpp"
@@ -109,36 +110,65 @@
 #define ST_KEY_SDF_SCALE "Filter.SDFEffects.SDF.Scale"
 #define ST_I18N_SDF_THRESHOLD "Filter.SDFEffects.SDF.Threshold"
 #define ST_KEY_SDF_THRESHOLD "Filter.SDFEffects.SDF.Threshold"
+#define ST_I18N_SDF_METHOD "Filter.SDFEffects.SDF.Method"
+#define ST_KEY_SDF_METHOD "Filter.SDFEffects.SDF.Method"
+#define ST_I18N_SDF_METHOD_TEMPORAL "Filter.SDFEffects.SDF.Method.Temporal"
+#define ST_I18N_SDF_METHOD_JUMPFLOOD "Filter.SDFEffects.SDF.Method.JumpFlood"
 
 using namespace streamfx::filter::sdf_effects;
 
+namespace {
+	// Indices into the parameter bindings of the SDF producer and consumer effects.
+	enum producer_parameter : std::size_t {
+		PRODUCER_IMAGE,
+		PRODUCER_SIZE,
+		PRODUCER_SDF,
+		PRODUCER_THRESHOLD,
+		PRODUCER_STEP,
+		PRODUCER_IMAGE_SIZE,
+	};
+
+	enum consumer_parameter : std::size_t {
+		CONSUMER_SDF_TEXTURE,
+		CONSUMER_SDF_THRESHOLD,
+		CONSUMER_IMAGE_TEXTURE,
+		CONSUMER_SHADOW_COLOR,
+		CONSUMER_SHADOW_MIN,
+		CONSUMER_SHADOW_MAX,
+		CONSUMER_SHADOW_OFFSET,
+		CONSUMER_GLOW_COLOR,
+		CONSUMER_GLOW_WIDTH,
+		CONSUMER_GLOW_SHARPNESS,
+		CONSUMER_GLOW_SHARPNESS_INVERSE,
+		CONSUMER_OUTLINE_COLOR,
+		CONSUMER_OUTLINE_WIDTH,
+		CONSUMER_OUTLINE_OFFSET,
+		CONSUMER_OUTLINE_SHARPNESS,
+		CONSUMER_OUTLINE_SHARPNESS_INVERSE,
+	};
+} // namespace
+
 static constexpr std::string_view HELP_URL = "https://github.com/Xaymar/obs-StreamFX/wiki/Filter-SDF-Effects";
 
 sdf_effects_instance::sdf_effects_instance(obs_data_t* settings, obs_source_t* self)
-	: obs::source_instance(settings, self), _source_rendered(false), _sdf_scale(1.0), _sdf_threshold(),
-	  _output_rendered(false), _inner_shadow(false), _inner_shadow_color(), _inner_shadow_range_min(),
-	  _inner_shadow_range_max(), _inner_shadow_offset_x(), _inner_shadow_offset_y(), _outer_shadow(false),
-	  _outer_shadow_color(), _outer_shadow_range_min(), _outer_shadow_range_max(), _outer_shadow_offset_x(),
-	  _outer_shadow_offset_y(), _inner_glow(false), _inner_glow_color(), _inner_glow_width(), _inner_glow_sharpness(),
-	  _inner_glow_sharpness_inv(), _outer_glow(false), _outer_glow_color(), _outer_glow_width(),
-	  _outer_glow_sharpness(), _outer_glow_sharpness_inv(), _outline(false), _outline_color(), _outline_width(),
-	  _outline_offset(), _outline_sharpness(), _outline_sharpness_inv()
+	: obs::source_instance(settings, self), _rt_pool(streamfx::obs::gs::rendertarget_pool::get()),
+	  _sdf_producer_parameters({"_image", "_size", "_sdf", "_threshold", "_step", "_image_size"}),
+	  _sdf_consumer_parameters({"pSDFTexture", "pSDFThreshold", "pImageTexture", "pShadowColor", "pShadowMin",
+								"pShadowMax", "pShadowOffset", "pGlowColor", "pGlowWidth", "pGlowSharpness",
+								"pGlowSharpnessInverse", "pOutlineColor", "pOutlineWidth", "pOutlineOffset",
+								"pOutlineSharpness", "pOutlineSharpnessInverse"}),
+	  _source_rendered(false), _sdf_leased(false), _sdf_scale(1.0), _sdf_threshold(),
+	  _sdf_method(sdf_method::Temporal), _output_rendered(false), _output_dirty(true), _inner_shadow(false),
+	  _inner_shadow_color(), _inner_shadow_range_min(), _inner_shadow_range_max(), _inner_shadow_offset_x(),
+	  _inner_shadow_offset_y(), _outer_shadow(false), _outer_shadow_color(), _outer_shadow_range_min(),
+	  _outer_shadow_range_max(), _outer_shadow_offset_x(), _outer_shadow_offset_y(), _inner_glow(false),
+	  _inner_glow_color(), _inner_glow_width(), _inner_glow_sharpness(), _inner_glow_sharpness_inv(),
+	  _outer_glow(false), _outer_glow_color(), _outer_glow_width(), _outer_glow_sharpness(),
+	  _outer_glow_sharpness_inv(), _outline(false), _outline_color(), _outline_width(), _outline_offset(),
+	  _outline_sharpness(), _outline_sharpness_inv()
 {
 	{
-		auto gctx        = streamfx::obs::gs::context();
-		vec4 transparent = {0, 0, 0, 0};
-
-		_source_rt = std::make_shared<streamfx::obs::gs::rendertarget>(GS_RGBA, GS_ZS_NONE);
-		_sdf_write = std::make_shared<streamfx::obs::gs::rendertarget>(GS_RGBA32F, GS_ZS_NONE);
-		_sdf_read  = std::make_shared<streamfx::obs::gs::rendertarget>(GS_RGBA32F, GS_ZS_NONE);
-		_output_rt = std::make_shared<streamfx::obs::gs::rendertarget>(GS_RGBA, GS_ZS_NONE);
-
-		std::shared_ptr<streamfx::obs::gs::rendertarget> initialize_rts[] = {_source_rt, _sdf_write, _sdf_read,
-																			 _output_rt};
-		for (auto rt : initialize_rts) {
-			auto op = rt->render(1, 1);
-			gs_clear(GS_CLEAR_COLOR | GS_CLEAR_DEPTH, &transparent, 0, 0);
-		}
+		auto gctx = streamfx::obs::gs::context();
 
 		std::pair<const char*, streamfx::obs::gs::effect&> load_arr[] = {
 			{"effects/sdf/sdf-producer.effect", _sdf_producer_effect},
@@ -302,13 +332,39 @@ void sdf_effects_instance::update(obs_data_t* data)
 
 	_sdf_scale     = double_t(obs_data_get_double(data, ST_KEY_SDF_SCALE) / 100.0);
 	_sdf_threshold = float_t(obs_data_get_double(data, ST_KEY_SDF_THRESHOLD) / 100.0);
+	_sdf_method    = static_cast<sdf_method>(obs_data_get_int(data, ST_KEY_SDF_METHOD));
+
+	_output_dirty = true;
 }
 
 void sdf_effects_instance::video_tick(float_t)
 {
 	if (obs_source_t* target = obs_filter_get_target(_self); target != nullptr) {
+		// The output is only kept for reuse while the filter keeps being drawn. Hidden filters are not rendered, and
+		// should not hold on to a full size render target until they are shown again.
+		if (!_source_rendered) {
+			_output_texture.reset();
+			_output_rt.reset();
+		}
+
 		_source_rendered = false;
 		_output_rendered = false;
+
+		// Return the input to the pool, it is leased again when this is rendered.
+		_source_texture.reset();
+		_source_rt.reset();
+	}
+
+	release_sdf();
+}
+
+void sdf_effects_instance::release_sdf()
+{
+	if (_sdf_leased) {
+		_sdf_texture.reset();
+		_sdf_read.reset();
+		_sdf_write.reset();
+		_sdf_leased = false;
 	}
 }
 
@@ -326,10 +382,8 @@ void sdf_effects_instance::video_render(gs_effect_t* effect)
 		return;
 	}
 
-#ifdef ENABLE_PROFILING
 	streamfx::obs::gs::debug_marker gdmp{streamfx::obs::gs::debug_color_source, "SDF Effects '%s' on '%s'",
 										 obs_source_get_name(_self), obs_source_get_name(obs_filter_get_parent(_self))};
-#endif
 
 	auto gctx              = streamfx::obs::gs::context();
 	vec4 color_transparent = {0, 0, 0, 0};
@@ -352,11 +406,10 @@ void sdf_effects_instance::video_render(gs_effect_t* effect)
 		if (!_source_rendered) {
 			// Store input texture.
 			{
-#ifdef ENABLE_PROFILING
 				streamfx::obs::gs::debug_marker gdm{streamfx::obs::gs::debug_color_cache, "Cache"};
-#endif
 
-				auto op = _source_rt->render(baseW, baseH);
+				_source_rt = _rt_pool->acquire(GS_RGBA, GS_ZS_NONE, baseW, baseH);
+				auto op    = _source_rt->render(baseW, baseH);
 				gs_ortho(0, static_cast<float>(baseW), 0, static_cast<float>(baseH), -1, 1);
 				gs_clear(GS_CLEAR_COLOR | GS_CLEAR_DEPTH, &color_transparent, 0, 0);
 
@@ -371,16 +424,19 @@ void sdf_effects_instance::video_render(gs_effect_t* effect)
 				throw std::runtime_error("failed to draw source");
 			}
 
-			// Generate SDF Buffers
-			{
-				_sdf_read->get_texture(_sdf_texture);
-				if (!_sdf_texture) {
-					throw std::runtime_error("SDF Backbuffer empty");
-				}
+			// Static input produces the same distance field and output every frame, so reuse the previous output. The
+			// temporal method still converges over several frames, and has to keep running.
+			bool unchanged = _source_tracker.track(_source_texture);
+			if (unchanged && !_output_dirty && _output_texture && (_sdf_method == sdf_method::JumpFlood)) {
+				_output_rendered = true;
+			}
 
+			// Generate SDF Buffers
+			if (!_output_rendered) {
 				if (!_sdf_producer_effect) {
 					throw std::runtime_error("SDF Effect no loaded");
 				}
+				auto& producer = _sdf_producer_parameters.bind(_sdf_producer_effect);
 
 				// Scale SDF Size
 				double_t sdfW, sdfH;
@@ -393,29 +449,78 @@ void sdf_effects_instance::video_render(gs_effect_t* effect)
 					sdfH = 1.0;
 				}
 
-				{
-#ifdef ENABLE_PROFILING
-					streamfx::obs::gs::debug_marker gdm{streamfx::obs::gs::debug_color_convert,
-														"Update Distance Field"};
-#endif
+				if (_sdf_method == sdf_method::JumpFlood) {
+					// The field is rebuilt from the seed pass every frame, so the buffers are only needed until the
+					// output has been rendered.
+					release_sdf();
+					_sdf_write  = _rt_pool->acquire(GS_RGBA32F, GS_ZS_NONE, uint32_t(sdfW), uint32_t(sdfH));
+					_sdf_read   = _rt_pool->acquire(GS_RGBA32F, GS_ZS_NONE, uint32_t(sdfW), uint32_t(sdfH));
+					_sdf_leased = true;
+				} else {
+					// The temporal method refines the field over several frames, so it keeps its own buffers.
+					if (!_sdf_read || !_sdf_write || _sdf_leased) {
+						_sdf_leased = false;
+						_sdf_write  = std::make_shared<streamfx::obs::gs::rendertarget>(GS_RGBA32F, GS_ZS_NONE);
+						_sdf_read   = std::make_shared<streamfx::obs::gs::rendertarget>(GS_RGBA32F, GS_ZS_NONE);
+
+						std::shared_ptr<streamfx::obs::gs::rendertarget> initialize_rts[] = {_sdf_write, _sdf_read};
+						for (auto rt : initialize_rts) {
+							auto op = rt->render(1, 1);
+							gs_clear(GS_CLEAR_COLOR | GS_CLEAR_DEPTH, &color_transparent, 0, 0);
+						}
+					}
 
-					auto op = _sdf_write->render(uint32_t(sdfW), uint32_t(sdfH));
-					gs_ortho(0, 1, 0, 1, -1, 1);
-					gs_clear(GS_CLEAR_COLOR | GS_CLEAR_DEPTH, &color_transparent, 0, 0);
+					_sdf_read->get_texture(_sdf_texture);
+					if (!_sdf_texture) {
+						throw std::runtime_error("SDF Backbuffer empty");
+					}
+				}
 
-					_sdf_producer_effect.get_parameter("_image").set_texture(_source_texture);
-					_sdf_producer_effect.get_parameter("_size").set_float2(float_t(sdfW), float_t(sdfH));
-					_sdf_producer_effect.get_parameter("_sdf").set_texture(_sdf_texture);
-					_sdf_producer_effect.get_parameter("_threshold").set_float(_sdf_threshold);
+				// Runs a single pass of the producer, reading from and then swapping the back buffer.
+				auto sdf_pass = [&](const char* technique) {
+					{
+						auto op = _sdf_write->render(uint32_t(sdfW), uint32_t(sdfH));
+						gs_ortho(0, 1, 0, 1, -1, 1);
+						gs_clear(GS_CLEAR_COLOR | GS_CLEAR_DEPTH, &color_transparent, 0, 0);
+
+						producer[PRODUCER_SDF].set_texture(_sdf_texture ? _sdf_texture->get_object() : nullptr);
+						while (gs_effect_loop(_sdf_producer_effect.get_object(), technique)) {
+							streamfx::gs_draw_fullscreen_tri();
+						}
+					}
+					std::swap(_sdf_read, _sdf_write);
+					_sdf_read->get_texture(_sdf_texture);
+					if (!_sdf_texture) {
+						throw std::runtime_error("SDF Backbuffer empty");
+					}
+				};
+
+				producer[PRODUCER_IMAGE].set_texture(_source_texture);
+				producer[PRODUCER_SIZE].set_float2(float_t(sdfW), float_t(sdfH));
+				producer[PRODUCER_THRESHOLD].set_float(_sdf_threshold);
+				producer[PRODUCER_IMAGE_SIZE].set_float2(float_t(baseW), float_t(baseH));
 
-					while (gs_effect_loop(_sdf_producer_effect.get_object(), "Draw")) {
-						streamfx::gs_draw_fullscreen_tri();
+				if (_sdf_method == sdf_method::JumpFlood) {
+					streamfx::obs::gs::debug_marker gdm{streamfx::obs::gs::debug_color_convert,
+														"Jump Flood Distance Field"};
+
+					// Start with the largest power of two below the size, so that the first jumps span the field.
+					uint32_t step = 1;
+					while ((step * 2) < uint32_t(std::max(sdfW, sdfH))) {
+						step *= 2;
 					}
-				}
-				std::swap(_sdf_read, _sdf_write);
-				_sdf_read->get_texture(_sdf_texture);
-				if (!_sdf_texture) {
-					throw std::runtime_error("SDF Backbuffer empty");
+
+					sdf_pass("JumpFloodSeed");
+					for (; step > 0; step /= 2) {
+						producer[PRODUCER_STEP].set_float2(float_t(step / sdfW), float_t(step / sdfH));
+						sdf_pass("JumpFlood");
+					}
+					sdf_pass("JumpFloodResolve");
+				} else {
+					streamfx::obs::gs::debug_marker gdm{streamfx::obs::gs::debug_color_convert,
+														"Update Distance Field"};
+
+					sdf_pass("Draw");
 				}
 			}
 
@@ -436,6 +541,7 @@ void sdf_effects_instance::video_render(gs_effect_t* effect)
 			obs_source_skip_video_filter(_self);
 			return;
 		}
+		auto& consumer = _sdf_consumer_parameters.bind(_sdf_consumer_effect);
 
 		gs_blend_state_push();
 		gs_reset_blend_state();
@@ -453,11 +559,10 @@ void sdf_effects_instance::video_render(gs_effect_t* effect)
 
 		// Optimized Render path.
 		try {
-#ifdef ENABLE_PROFILING
 			streamfx::obs::gs::debug_marker gdm{streamfx::obs::gs::debug_color_convert, "Calculate"};
-#endif
 
-			auto op = _output_rt->render(baseW, baseH);
+			_output_rt = _rt_pool->acquire(GS_RGBA, GS_ZS_NONE, baseW, baseH);
+			auto op    = _output_rt->render(baseW, baseH);
 			gs_ortho(0, 1, 0, 1, 0, 1);
 
 			gs_enable_blending(false);
@@ -473,64 +578,64 @@ void sdf_effects_instance::video_render(gs_effect_t* effect)
 			gs_enable_blending(true);
 			gs_blend_function_separate(GS_BLEND_SRCALPHA, GS_BLEND_INVSRCALPHA, GS_BLEND_ONE, GS_BLEND_ONE);
 			if (_outer_shadow) {
-				_sdf_consumer_effect.get_parameter("pSDFTexture").set_texture(_sdf_texture);
-				_sdf_consumer_effect.get_parameter("pSDFThreshold").set_float(_sdf_threshold);
-				_sdf_consumer_effect.get_parameter("pImageTexture").set_texture(_source_texture->get_object());
-				_sdf_consumer_effect.get_parameter("pShadowColor").set_float4(_outer_shadow_color);
-				_sdf_consumer_effect.get_parameter("pShadowMin").set_float(_outer_shadow_range_min);
-				_sdf_consumer_effect.get_parameter("pShadowMax").set_float(_outer_shadow_range_max);
-				_sdf_consumer_effect.get_parameter("pShadowOffset")
+				consumer[CONSUMER_SDF_TEXTURE].set_texture(_sdf_texture);
+				consumer[CONSUMER_SDF_THRESHOLD].set_float(_sdf_threshold);
+				consumer[CONSUMER_IMAGE_TEXTURE].set_texture(_source_texture->get_object());
+				consumer[CONSUMER_SHADOW_COLOR].set_float4(_outer_shadow_color);
+				consumer[CONSUMER_SHADOW_MIN].set_float(_outer_shadow_range_min);
+				consumer[CONSUMER_SHADOW_MAX].set_float(_outer_shadow_range_max);
+				consumer[CONSUMER_SHADOW_OFFSET]
 					.set_float2(_outer_shadow_offset_x / float_t(baseW), _outer_shadow_offset_y / float_t(baseH));
 				while (gs_effect_loop(_sdf_consumer_effect.get_object(), "ShadowOuter")) {
 					streamfx::gs_draw_fullscreen_tri();
 				}
 			}
 			if (_inner_shadow) {
-				_sdf_consumer_effect.get_parameter("pSDFTexture").set_texture(_sdf_texture);
-				_sdf_consumer_effect.get_parameter("pSDFThreshold").set_float(_sdf_threshold);
-				_sdf_consumer_effect.get_parameter("pImageTexture").set_texture(_source_texture->get_object());
-				_sdf_consumer_effect.get_parameter("pShadowColor").set_float4(_inner_shadow_color);
-				_sdf_consumer_effect.get_parameter("pShadowMin").set_float(_inner_shadow_range_min);
-				_sdf_consumer_effect.get_parameter("pShadowMax").set_float(_inner_shadow_range_max);
-				_sdf_consumer_effect.get_parameter("pShadowOffset")
+				consumer[CONSUMER_SDF_TEXTURE].set_texture(_sdf_texture);
+				consumer[CONSUMER_SDF_THRESHOLD].set_float(_sdf_threshold);
+				consumer[CONSUMER_IMAGE_TEXTURE].set_texture(_source_texture->get_object());
+				consumer[CONSUMER_SHADOW_COLOR].set_float4(_inner_shadow_color);
+				consumer[CONSUMER_SHADOW_MIN].set_float(_inner_shadow_range_min);
+				consumer[CONSUMER_SHADOW_MAX].set_float(_inner_shadow_range_max);
+				consumer[CONSUMER_SHADOW_OFFSET]
 					.set_float2(_inner_shadow_offset_x / float_t(baseW), _inner_shadow_offset_y / float_t(baseH));
 				while (gs_effect_loop(_sdf_consumer_effect.get_object(), "ShadowInner")) {
 					streamfx::gs_draw_fullscreen_tri();
 				}
 			}
 			if (_outer_glow) {
-				_sdf_consumer_effect.get_parameter("pSDFTexture").set_texture(_sdf_texture);
-				_sdf_consumer_effect.get_parameter("pSDFThreshold").set_float(_sdf_threshold);
-				_sdf_consumer_effect.get_parameter("pImageTexture").set_texture(_source_texture->get_object());
-				_sdf_consumer_effect.get_parameter("pGlowColor").set_float4(_outer_glow_color);
-				_sdf_consumer_effect.get_parameter("pGlowWidth").set_float(_outer_glow_width);
-				_sdf_consumer_effect.get_parameter("pGlowSharpness").set_float(_outer_glow_sharpness);
-				_sdf_consumer_effect.get_parameter("pGlowSharpnessInverse").set_float(_outer_glow_sharpness_inv);
+				consumer[CONSUMER_SDF_TEXTURE].set_texture(_sdf_texture);
+				consumer[CONSUMER_SDF_THRESHOLD].set_float(_sdf_threshold);
+				consumer[CONSUMER_IMAGE_TEXTURE].set_texture(_source_texture->get_object());
+				consumer[CONSUMER_GLOW_COLOR].set_float4(_outer_glow_color);
+				consumer[CONSUMER_GLOW_WIDTH].set_float(_outer_glow_width);
+				consumer[CONSUMER_GLOW_SHARPNESS].set_float(_outer_glow_sharpness);
+				consumer[CONSUMER_GLOW_SHARPNESS_INVERSE].set_float(_outer_glow_sharpness_inv);
 				while (gs_effect_loop(_sdf_consumer_effect.get_object(), "GlowOuter")) {
 					streamfx::gs_draw_fullscreen_tri();
 				}
 			}
 			if (_inner_glow) {
-				_sdf_consumer_effect.get_parameter("pSDFTexture").set_texture(_sdf_texture);
-				_sdf_consumer_effect.get_parameter("pSDFThreshold").set_float(_sdf_threshold);
-				_sdf_consumer_effect.get_parameter("pImageTexture").set_texture(_source_texture->get_object());
-				_sdf_consumer_effect.get_parameter("pGlowColor").set_float4(_inner_glow_color);
-				_sdf_consumer_effect.get_parameter("pGlowWidth").set_float(_inner_glow_width);
-				_sdf_consumer_effect.get_parameter("pGlowSharpness").set_float(_inner_glow_sharpness);
-				_sdf_consumer_effect.get_parameter("pGlowSharpnessInverse").set_float(_inner_glow_sharpness_inv);
+				consumer[CONSUMER_SDF_TEXTURE].set_texture(_sdf_texture);
+				consumer[CONSUMER_SDF_THRESHOLD].set_float(_sdf_threshold);
+				consumer[CONSUMER_IMAGE_TEXTURE].set_texture(_source_texture->get_object());
+				consumer[CONSUMER_GLOW_COLOR].set_float4(_inner_glow_color);
+				consumer[CONSUMER_GLOW_WIDTH].set_float(_inner_glow_width);
+				consumer[CONSUMER_GLOW_SHARPNESS].set_float(_inner_glow_sharpness);
+				consumer[CONSUMER_GLOW_SHARPNESS_INVERSE].set_float(_inner_glow_sharpness_inv);
 				while (gs_effect_loop(_sdf_consumer_effect.get_object(), "GlowInner")) {
 					streamfx::gs_draw_fullscreen_tri();
 				}
 			}
 			if (_outline) {
-				_sdf_consumer_effect.get_parameter("pSDFTexture").set_texture(_sdf_texture);
-				_sdf_consumer_effect.get_parameter("pSDFThreshold").set_float(_sdf_threshold);
-				_sdf_consumer_effect.get_parameter("pImageTexture").set_texture(_source_texture->get_object());
-				_sdf_consumer_effect.get_parameter("pOutlineColor").set_float4(_outline_color);
-				_sdf_consumer_effect.get_parameter("pOutlineWidth").set_float(_outline_width);
-				_sdf_consumer_effect.get_parameter("pOutlineOffset").set_float(_outline_offset);
-				_sdf_consumer_effect.get_parameter("pOutlineSharpness").set_float(_outline_sharpness);
-				_sdf_consumer_effect.get_parameter("pOutlineSharpnessInverse").set_float(_outline_sharpness_inv);
+				consumer[CONSUMER_SDF_TEXTURE].set_texture(_sdf_texture);
+				consumer[CONSUMER_SDF_THRESHOLD].set_float(_sdf_threshold);
+				consumer[CONSUMER_IMAGE_TEXTURE].set_texture(_source_texture->get_object());
+				consumer[CONSUMER_OUTLINE_COLOR].set_float4(_outline_color);
+				consumer[CONSUMER_OUTLINE_WIDTH].set_float(_outline_width);
+				consumer[CONSUMER_OUTLINE_OFFSET].set_float(_outline_offset);
+				consumer[CONSUMER_OUTLINE_SHARPNESS].set_float(_outline_sharpness);
+				consumer[CONSUMER_OUTLINE_SHARPNESS_INVERSE].set_float(_outline_sharpness_inv);
 				while (gs_effect_loop(_sdf_consumer_effect.get_object(), "Outline")) {
 					streamfx::gs_draw_fullscreen_tri();
 				}
@@ -538,10 +643,15 @@ void sdf_effects_instance::video_render(gs_effect_t* effect)
 		} catch (...) {
 		}
 
-		_output_rt->get_texture(_output_texture);
+		if (_output_rt) {
+			_output_rt->get_texture(_output_texture);
+		}
 
 		gs_blend_state_pop();
 		_output_rendered = true;
+		_output_dirty    = false;
+
+		release_sdf();
 	}
 
 	if (!_output_texture) {
@@ -550,9 +660,7 @@ void sdf_effects_instance::video_render(gs_effect_t* effect)
 	}
 
 	{
-#ifdef ENABLE_PROFILING
 		streamfx::obs::gs::debug_marker gdm{streamfx::obs::gs::debug_color_render, "Render"};
-#endif
 
 		gs_eparam_t* ep = gs_effect_get_param_by_name(final_effect, "image");
 		if (ep) {
@@ -621,6 +729,9 @@ void sdf_effects_factory::get_defaults2(obs_data_t* data)
 
 	obs_data_set_default_double(data, ST_KEY_SDF_SCALE, 100.0);
 	obs_data_set_default_double(data, ST_KEY_SDF_THRESHOLD, 50.0);
+	// Jump flood measures distances in source pixels instead of SDF texels, which would change the size of effects in
+	// existing scenes. Saved filters don't store the default, so it has to stay at the original method.
+	obs_data_set_default_int(data, ST_KEY_SDF_METHOD, static_cast<int64_t>(sdf_method::Temporal));
 }
 
 obs_properties_t* sdf_effects_factory::get_properties2(sdf_effects_instance* data)
@@ -715,6 +826,12 @@ obs_properties_t* sdf_effects_factory::get_properties2(sdf_effects_instance* dat
 		auto pr = obs_properties_create();
 		obs_properties_add_group(prs, S_ADVANCED, D_TRANSLATE(S_ADVANCED), OBS_GROUP_NORMAL, pr);
 
+		p = obs_properties_add_list(pr, ST_KEY_SDF_METHOD, D_TRANSLATE(ST_I18N_SDF_METHOD), OBS_COMBO_TYPE_LIST,
+									OBS_COMBO_FORMAT_INT);
+		obs_property_list_add_int(p, D_TRANSLATE(ST_I18N_SDF_METHOD_JUMPFLOOD),
+								  static_cast<int64_t>(sdf_method::JumpFlood));
+		obs_property_list_add_int(p, D_TRANSLATE(ST_I18N_SDF_METHOD_TEMPORAL),
+								  static_cast<int64_t>(sdf_method::Temporal));
 		obs_properties_add_float_slider(pr, ST_KEY_SDF_SCALE, D_TRANSLATE(ST_I18N_SDF_SCALE), 0.1, 500.0, 0.1);
 		obs_properties_add_float_slider(pr, ST_KEY_SDF_THRESHOLD, D_TRANSLATE(ST_I18N_SDF_THRESHOLD), 0.0, 100.0, 0.01);
 	}
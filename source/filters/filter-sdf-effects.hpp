@@ -19,7 +19,9 @@
 
 #pragma once
 #include "common.hpp"
+#include "gfx/gfx-content-tracker.hpp"
 #include "obs/gs/gs-effect.hpp"
+#include "obs/gs/gs-rendertarget-pool.hpp"
 #include "obs/gs/gs-rendertarget.hpp"
 #include "obs/gs/gs-sampler.hpp"
 #include "obs/gs/gs-texture.hpp"
@@ -27,26 +29,40 @@
 #include "obs/obs-source-factory.hpp"
 
 namespace streamfx::filter::sdf_effects {
+	enum class sdf_method : int64_t {
+		Temporal,  // One pass per frame, converges over time.
+		JumpFlood, // Exact, in log2(N) passes per frame.
+	};
+
 	class sdf_effects_instance : public obs::source_instance {
-		streamfx::obs::gs::effect _sdf_producer_effect;
-		streamfx::obs::gs::effect _sdf_consumer_effect;
+		streamfx::obs::gs::effect          _sdf_producer_effect;
+		streamfx::obs::gs::effect          _sdf_consumer_effect;
+		streamfx::obs::gs::effect_bindings _sdf_producer_parameters;
+		streamfx::obs::gs::effect_bindings _sdf_consumer_parameters;
+
+		// Leased from the pool for the current frame, or for as long as the output is reused.
+		std::shared_ptr<streamfx::obs::gs::rendertarget_pool> _rt_pool;
 
 		// Input
 		std::shared_ptr<streamfx::obs::gs::rendertarget> _source_rt;
 		std::shared_ptr<streamfx::obs::gs::texture>      _source_texture;
 		bool                                             _source_rendered;
+		streamfx::gfx::content_tracker                   _source_tracker;
 
 		// Distance Field
 		std::shared_ptr<streamfx::obs::gs::rendertarget> _sdf_write;
 		std::shared_ptr<streamfx::obs::gs::rendertarget> _sdf_read;
 		std::shared_ptr<streamfx::obs::gs::texture>      _sdf_texture;
+		bool                                             _sdf_leased;
 		double_t                                         _sdf_scale;
 		float_t                                          _sdf_threshold;
+		sdf_method                                       _sdf_method;
 
-		// Effects
+		// Effects, kept across frames for as long as the input and settings don't change.
 		bool                                             _output_rendered;
 		std::shared_ptr<streamfx::obs::gs::texture>      _output_texture;
 		std::shared_ptr<streamfx::obs::gs::rendertarget> _output_rt;
+		bool                                             _output_dirty;
 		/// Inner Shadow
 		bool    _inner_shadow;
 		vec4    _inner_shadow_color;
@@ -91,6 +107,10 @@ namespace streamfx::filter::sdf_effects {
 
 		virtual void video_tick(float_t) override;
 		virtual void video_render(gs_effect_t*) override;
+
+		private:
+		// Returns the distance field buffers to the pool, if they were leased for the current frame.
+		void release_sdf();
 	};
 
 	class sdf_effects_factory : public obs::source_factory<filter::sdf_effects::sdf_effects_factory,
@@ -44,10 +44,10 @@ using namespace streamfx::filter::shader;
 static constexpr std::string_view HELP_URL =
 	"https://github.com/Xaymar/obs-StreamFX/wiki/Source-Filter-Transition-Shader";
 
-shader_instance::shader_instance(obs_data_t* data, obs_source_t* self) : obs::source_instance(data, self)
+shader_instance::shader_instance(obs_data_t* data, obs_source_t* self)
+	: obs::source_instance(data, self), _rt_pool(streamfx::obs::gs::rendertarget_pool::get())
 {
 	_fx = std::make_shared<streamfx::gfx::shader::shader>(self, streamfx::gfx::shader::shader_mode::Filter);
-	_rt = std::make_shared<streamfx::obs::gs::rendertarget>(GS_RGBA, GS_ZS_NONE);
 
 	update(data);
 }
@@ -83,6 +83,9 @@ void shader_instance::update(obs_data_t* data)
 
 void shader_instance::video_tick(float_t sec_since_last)
 {
+	// Return the input to the pool, it is leased again when this is rendered.
+	_rt.reset();
+
 	if (_fx->tick(sec_since_last)) {
 		obs_data_t* data = obs_source_get_settings(_self);
 		_fx->update(data);
@@ -103,17 +106,14 @@ void shader_instance::video_render(gs_effect_t* effect)
 			throw std::runtime_error("No effect, or invalid base size.");
 		}
 
-#ifdef ENABLE_PROFILING
 		streamfx::obs::gs::debug_marker gdmp{streamfx::obs::gs::debug_color_source, "Shader Filter '%s' on '%s'",
 											 obs_source_get_name(_self),
 											 obs_source_get_name(obs_filter_get_parent(_self))};
-#endif
 
 		{
-#ifdef ENABLE_PROFILING
 			streamfx::obs::gs::debug_marker gdm{streamfx::obs::gs::debug_color_source, "Cache"};
-#endif
 
+			_rt     = _rt_pool->acquire(GS_RGBA, GS_ZS_NONE, _fx->base_width(), _fx->base_height());
 			auto op = _rt->render(_fx->base_width(), _fx->base_height());
 
 			gs_ortho(0, 1, 0, 1, -1, 1);
@@ -139,9 +139,7 @@ void shader_instance::video_render(gs_effect_t* effect)
 		}
 
 		{
-#ifdef ENABLE_PROFILING
 			streamfx::obs::gs::debug_marker gdm{streamfx::obs::gs::debug_color_render, "Render"};
-#endif
 
 			_fx->prepare_render();
 			_fx->set_input_a(_rt->get_texture());
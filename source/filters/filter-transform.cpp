@@ -111,14 +111,12 @@ enum RotationOrder : int64_t {
 
 transform_instance::transform_instance(obs_data_t* data, obs_source_t* context)
 	: obs::source_instance(data, context), _camera_mode(), _camera_fov(), _standard_effect(), _transform_effect(),
-	  _sampler(), _params(), _corners(), _cache_rendered(), _mipmap_enabled(), _source_rendered(), _source_size(),
-	  _update_mesh(true)
+	  _sampler(), _params(), _corners(), _rt_pool(streamfx::obs::gs::rendertarget_pool::get()), _cache_rendered(),
+	  _mipmap_enabled(), _source_rendered(), _source_size(), _source_dirty(true), _update_mesh(true)
 {
 	{
 		auto gctx = obs::gs::context();
 
-		_cache_rt      = std::make_shared<streamfx::obs::gs::rendertarget>(GS_RGBA, GS_ZS_NONE);
-		_source_rt     = std::make_shared<streamfx::obs::gs::rendertarget>(GS_RGBA, GS_ZS_NONE);
 		_vertex_buffer = std::make_shared<streamfx::obs::gs::vertex_buffer>(uint32_t(4u), uint8_t(1u));
 		{
 			auto file = streamfx::data_file_path("effects/standard.effect");
@@ -161,8 +159,10 @@ transform_instance::transform_instance(obs_data_t* data, obs_source_t* context)
 transform_instance::~transform_instance()
 {
 	_vertex_buffer.reset();
-	_cache_rt.reset();
 	_cache_texture.reset();
+	_cache_rt.reset();
+	_source_texture.reset();
+	_source_rt.reset();
 	_mipmap_texture.reset();
 }
 
@@ -258,7 +258,8 @@ void transform_instance::update(obs_data_t* settings)
 	_mipmap_enabled = obs_data_get_bool(settings, ST_KEY_MIPMAPPING);
 	_sampler.set_filter(_mipmap_enabled ? GS_FILTER_ANISOTROPIC : GS_FILTER_LINEAR);
 
-	_update_mesh = true;
+	_update_mesh  = true;
+	_source_dirty = true;
 }
 
 void transform_instance::video_tick(float)
@@ -375,12 +376,24 @@ void transform_instance::video_tick(float)
 		}
 
 		_vertex_buffer->update(true);
-		_update_mesh = false;
+		_update_mesh  = false;
+		_source_dirty = true;
+	}
+
+	// The output is only kept for reuse while the filter keeps being drawn. Hidden filters are not rendered, and
+	// should not hold on to a full size render target until they are shown again.
+	if (!_cache_rendered) {
+		_source_texture.reset();
+		_source_rt.reset();
 	}
 
 	_cache_rendered  = false;
 	_mipmap_rendered = false;
 	_source_rendered = false;
+
+	// Return the input to the pool, it is leased again when this is rendered.
+	_cache_texture.reset();
+	_cache_rt.reset();
 }
 
 void transform_instance::video_render(gs_effect_t* effect)
@@ -399,10 +412,8 @@ void transform_instance::video_render(gs_effect_t* effect)
 		return;
 	}
 
-#ifdef ENABLE_PROFILING
 	streamfx::obs::gs::debug_marker gdmp{streamfx::obs::gs::debug_color_source, "3D Transform '%s' on '%s'",
 										 obs_source_get_name(_self), obs_source_get_name(obs_filter_get_parent(_self))};
-#endif
 
 	uint32_t cache_width  = base_width;
 	uint32_t cache_height = base_height;
@@ -427,11 +438,10 @@ void transform_instance::video_render(gs_effect_t* effect)
 	}
 
 	if (!_cache_rendered) {
-#ifdef ENABLE_PROFILING
 		streamfx::obs::gs::debug_marker gdm{streamfx::obs::gs::debug_color_cache, "Cache"};
-#endif
 
-		auto op = _cache_rt->render(cache_width, cache_height);
+		_cache_rt = _rt_pool->acquire(GS_RGBA, GS_ZS_NONE, cache_width, cache_height);
+		auto op   = _cache_rt->render(cache_width, cache_height);
 
 		gs_ortho(0, static_cast<float>(base_width), 0, static_cast<float>(base_height), -1, 1);
 
@@ -466,16 +476,17 @@ void transform_instance::video_render(gs_effect_t* effect)
 		return;
 	}
 
-	if (_mipmap_enabled) {
-#ifdef ENABLE_PROFILING
+	// Static input produces the same output every frame, so the previous output can be reused.
+	if (!_source_rendered && _cache_tracker.track(_cache_texture) && !_source_dirty && _source_texture) {
+		_source_rendered = true;
+	}
+
+	if (_mipmap_enabled && !_source_rendered) {
 		streamfx::obs::gs::debug_marker gdm{streamfx::obs::gs::debug_color_convert, "Mipmap"};
-#endif
 
 		if (!_mipmap_texture || (_mipmap_texture->get_width() != cache_width)
 			|| (_mipmap_texture->get_height() != cache_height)) {
-#ifdef ENABLE_PROFILING
 			streamfx::obs::gs::debug_marker gdr{streamfx::obs::gs::debug_color_allocate, "Allocate Mipmapped Texture"};
-#endif
 
 			std::size_t mip_levels = _mipmapper.calculate_max_mip_level(cache_width, cache_height);
 			_mipmap_texture        = std::make_shared<streamfx::obs::gs::texture>(cache_width, cache_height, GS_RGBA,
@@ -491,12 +502,11 @@ void transform_instance::video_render(gs_effect_t* effect)
 		}
 	}
 
-	{
-#ifdef ENABLE_PROFILING
+	if (!_source_rendered) {
 		streamfx::obs::gs::debug_marker gdm{streamfx::obs::gs::debug_color_convert, "Transform"};
-#endif
 
-		auto op = _source_rt->render(base_width, base_height);
+		_source_rt = _rt_pool->acquire(GS_RGBA, GS_ZS_NONE, base_width, base_height);
+		auto op    = _source_rt->render(base_width, base_height);
 
 		vec4 clear_color = {0, 0, 0, 0};
 		gs_clear(GS_CLEAR_COLOR | GS_CLEAR_DEPTH, &clear_color, 0, 0);
@@ -572,6 +582,9 @@ void transform_instance::video_render(gs_effect_t* effect)
 		}
 
 		gs_blend_state_pop();
+
+		_source_rendered = true;
+		_source_dirty    = false;
 	}
 	_source_rt->get_texture(_source_texture);
 	if (!_source_texture) {
@@ -580,9 +593,7 @@ void transform_instance::video_render(gs_effect_t* effect)
 	}
 
 	{
-#ifdef ENABLE_PROFILING
 		streamfx::obs::gs::debug_marker gdm{streamfx::obs::gs::debug_color_render, "Render"};
-#endif
 
 		gs_effect_set_texture(gs_effect_get_param_by_name(effect, "image"), _source_texture->get_object());
 		while (gs_effect_loop(effect, "Draw")) {
@@ -20,7 +20,9 @@
 #pragma once
 #include "common.hpp"
 #include <vector>
+#include "gfx/gfx-content-tracker.hpp"
 #include "obs/gs/gs-mipmapper.hpp"
+#include "obs/gs/gs-rendertarget-pool.hpp"
 #include "obs/gs/gs-rendertarget.hpp"
 #include "obs/gs/gs-texture.hpp"
 #include "obs/gs/gs-vertexbuffer.hpp"
@@ -56,10 +58,14 @@ namespace streamfx::filter::transform {
 		streamfx::obs::gs::effect  _transform_effect;
 		streamfx::obs::gs::sampler _sampler;
 
+		// Leased from the pool for the current frame, or for as long as the output is reused.
+		std::shared_ptr<streamfx::obs::gs::rendertarget_pool> _rt_pool;
+
 		// Cache
 		bool                                             _cache_rendered;
 		std::shared_ptr<streamfx::obs::gs::rendertarget> _cache_rt;
 		std::shared_ptr<streamfx::obs::gs::texture>      _cache_texture;
+		streamfx::gfx::content_tracker                   _cache_tracker;
 
 		// Mip-mapping
 		bool                                        _mipmap_enabled;
@@ -72,6 +78,7 @@ namespace streamfx::filter::transform {
 		std::pair<uint32_t, uint32_t>                    _source_size;
 		std::shared_ptr<streamfx::obs::gs::rendertarget> _source_rt;
 		std::shared_ptr<streamfx::obs::gs::texture>      _source_texture;
+		bool                                             _source_dirty;
 
 		// Mesh
 		bool                                              _update_mesh;
@@ -258,20 +258,16 @@ void upscaling_instance::video_render(gs_effect_t* effect)
 		return;
 	}
 
-#ifdef ENABLE_PROFILING
 	::streamfx::obs::gs::debug_marker profiler0{::streamfx::obs::gs::debug_color_source, "StreamFX Upscaling"};
 	::streamfx::obs::gs::debug_marker profiler0_0{::streamfx::obs::gs::debug_color_gray, "'%s' on '%s'",
 												  obs_source_get_name(_self), obs_source_get_name(parent)};
-#endif
 
 	if (_dirty) {
 		// Lock the provider from being changed.
 		std::unique_lock<std::mutex> ul(_provider_lock);
 
 		{ // Capture the incoming frame.
-#ifdef ENABLE_PROFILING
 			::streamfx::obs::gs::debug_marker profiler1{::streamfx::obs::gs::debug_color_capture, "Capture"};
-#endif
 			if (obs_source_process_filter_begin(_self, GS_RGBA, OBS_ALLOW_DIRECT_RENDERING)) {
 				auto op = _input->render(_in_size.first, _in_size.second);
 
@@ -291,9 +287,7 @@ void upscaling_instance::video_render(gs_effect_t* effect)
 				gs_set_cull_mode(GS_NEITHER);
 
 				// Render
-#ifdef ENABLE_PROFILING
 				::streamfx::obs::gs::debug_marker profiler2{::streamfx::obs::gs::debug_color_capture, "Storage"};
-#endif
 				obs_source_process_filter_end(_self, obs_get_base_effect(OBS_EFFECT_DEFAULT), 1, 1);
 
 				// Reset GPU state
@@ -306,9 +300,7 @@ void upscaling_instance::video_render(gs_effect_t* effect)
 		}
 
 		try { // Process the captured input with the provider.
-#ifdef ENABLE_PROFILING
 			::streamfx::obs::gs::debug_marker profiler1{::streamfx::obs::gs::debug_color_convert, "Process"};
-#endif
 			switch (_provider) {
 #ifdef ENABLE_FILTER_UPSCALING_NVIDIA
 			case upscaling_provider::NVIDIA_SUPERRESOLUTION:
@@ -334,9 +326,7 @@ void upscaling_instance::video_render(gs_effect_t* effect)
 	}
 
 	{ // Draw the result for the next filter to use.
-#ifdef ENABLE_PROFILING
 		::streamfx::obs::gs::debug_marker profiler1{::streamfx::obs::gs::debug_color_render, "Render"};
-#endif
 		if (_standard_effect->has_parameter("InputA", ::streamfx::obs::gs::effect_parameter::type::Texture)) {
 			_standard_effect->get_parameter("InputA").set_texture(_output);
 		}
@@ -389,7 +379,8 @@ void streamfx::filter::upscaling::upscaling_instance::switch_provider(upscaling_
 
 	// Then spawn a new task to switch provider.
 	_provider_task = streamfx::threadpool()->push(
-		std::bind(&upscaling_instance::task_switch_provider, this, std::placeholders::_1), spd);
+		std::bind(&upscaling_instance::task_switch_provider, this, std::placeholders::_1), spd,
+		::streamfx::util::threadpool_priority::LOW);
 }
 
 void streamfx::filter::upscaling::upscaling_instance::task_switch_provider(util::threadpool_data_t data)
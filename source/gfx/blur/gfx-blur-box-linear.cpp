@@ -34,6 +34,17 @@
 
 #define ST_MAX_BLUR_SIZE 128 // Also change this in box-linear.effect if modified.
 
+namespace {
+	// Indices into the parameter bindings of streamfx::gfx::blur::box_linear.
+	enum parameter : std::size_t {
+		P_IMAGE,
+		P_IMAGE_TEXEL,
+		P_STEP_SCALE,
+		P_SIZE,
+		P_SIZE_INVERSE_MUL,
+	};
+} // namespace
+
 streamfx::gfx::blur::box_linear_data::box_linear_data()
 {
 	auto gctx = streamfx::obs::gs::context();
@@ -189,7 +200,8 @@ std::shared_ptr<::streamfx::gfx::blur::box_linear_data> streamfx::gfx::blur::box
 }
 
 streamfx::gfx::blur::box_linear::box_linear()
-	: _data(::streamfx::gfx::blur::box_linear_factory::get().data()), _size(1.), _step_scale({1., 1.})
+	: _data(::streamfx::gfx::blur::box_linear_factory::get().data()), _size(1.), _step_scale({1., 1.}),
+	  _parameters({"pImage", "pImageTexel", "pStepScale", "pSize", "pSizeInverseMul"})
 {
 	_rendertarget  = std::make_shared<::streamfx::obs::gs::rendertarget>(GS_RGBA, GS_ZS_NONE);
 	_rendertarget2 = std::make_shared<::streamfx::obs::gs::rendertarget>(GS_RGBA, GS_ZS_NONE);
@@ -248,9 +260,7 @@ std::shared_ptr<::streamfx::obs::gs::texture> streamfx::gfx::blur::box_linear::r
 {
 	auto gctx = streamfx::obs::gs::context();
 
-#ifdef ENABLE_PROFILING
 	auto gdmp = streamfx::obs::gs::debug_marker(streamfx::obs::gs::debug_color_azure_radiance, "Box Linear Blur");
-#endif
 
 	float_t width  = float_t(_input_texture->get_width());
 	float_t height = float_t(_input_texture->get_height());
@@ -269,19 +279,18 @@ std::shared_ptr<::streamfx::obs::gs::texture> streamfx::gfx::blur::box_linear::r
 	gs_stencil_op(GS_STENCIL_BOTH, GS_ZERO, GS_ZERO, GS_ZERO);
 
 	// Two Pass Blur
-	streamfx::obs::gs::effect effect = _data->get_effect();
+	streamfx::obs::gs::effect effect     = _data->get_effect();
+	auto&                     parameters = _parameters.bind(effect);
 	if (effect) {
 		// Pass 1
-		effect.get_parameter("pImage").set_texture(_input_texture);
-		effect.get_parameter("pImageTexel").set_float2(float_t(1.f / width), 0.f);
-		effect.get_parameter("pStepScale").set_float2(float_t(_step_scale.first), float_t(_step_scale.second));
-		effect.get_parameter("pSize").set_float(float_t(_size));
-		effect.get_parameter("pSizeInverseMul").set_float(float_t(1.0f / (float_t(_size) * 2.0f + 1.0f)));
+		parameters[P_IMAGE].set_texture(_input_texture);
+		parameters[P_IMAGE_TEXEL].set_float2(float_t(1.f / width), 0.f);
+		parameters[P_STEP_SCALE].set_float2(float_t(_step_scale.first), float_t(_step_scale.second));
+		parameters[P_SIZE].set_float(float_t(_size));
+		parameters[P_SIZE_INVERSE_MUL].set_float(float_t(1.0f / (float_t(_size) * 2.0f + 1.0f)));
 
 		{
-#ifdef ENABLE_PROFILING
 			auto gdm = streamfx::obs::gs::debug_marker(streamfx::obs::gs::debug_color_azure_radiance, "Horizontal");
-#endif
 
 			auto op = _rendertarget2->render(uint32_t(width), uint32_t(height));
 			gs_ortho(0, 1., 0, 1., 0, 1.);
@@ -291,13 +300,11 @@ std::shared_ptr<::streamfx::obs::gs::texture> streamfx::gfx::blur::box_linear::r
 		}
 
 		// Pass 2
-		effect.get_parameter("pImage").set_texture(_rendertarget2->get_texture());
-		effect.get_parameter("pImageTexel").set_float2(0., float_t(1.f / height));
+		parameters[P_IMAGE].set_texture(_rendertarget2->get_texture());
+		parameters[P_IMAGE_TEXEL].set_float2(0., float_t(1.f / height));
 
 		{
-#ifdef ENABLE_PROFILING
 			auto gdm = streamfx::obs::gs::debug_marker(streamfx::obs::gs::debug_color_azure_radiance, "Vertical");
-#endif
 
 			auto op = _rendertarget->render(uint32_t(width), uint32_t(height));
 			gs_ortho(0, 1., 0, 1., 0, 1.);
@@ -338,10 +345,8 @@ std::shared_ptr<::streamfx::obs::gs::texture> streamfx::gfx::blur::box_linear_di
 {
 	auto gctx = streamfx::obs::gs::context();
 
-#ifdef ENABLE_PROFILING
 	auto gdmp =
 		streamfx::obs::gs::debug_marker(streamfx::obs::gs::debug_color_azure_radiance, "Box Linear Directional Blur");
-#endif
 
 	float_t width  = float_t(_input_texture->get_width());
 	float_t height = float_t(_input_texture->get_height());
@@ -360,14 +365,15 @@ std::shared_ptr<::streamfx::obs::gs::texture> streamfx::gfx::blur::box_linear_di
 	gs_stencil_op(GS_STENCIL_BOTH, GS_ZERO, GS_ZERO, GS_ZERO);
 
 	// One Pass Blur
-	streamfx::obs::gs::effect effect = _data->get_effect();
+	streamfx::obs::gs::effect effect     = _data->get_effect();
+	auto&                     parameters = _parameters.bind(effect);
 	if (effect) {
-		effect.get_parameter("pImage").set_texture(_input_texture);
-		effect.get_parameter("pImageTexel")
+		parameters[P_IMAGE].set_texture(_input_texture);
+		parameters[P_IMAGE_TEXEL]
 			.set_float2(float_t(1. / width * cos(_angle)), float_t(1.f / height * sin(_angle)));
-		effect.get_parameter("pStepScale").set_float2(float_t(_step_scale.first), float_t(_step_scale.second));
-		effect.get_parameter("pSize").set_float(float_t(_size));
-		effect.get_parameter("pSizeInverseMul").set_float(float_t(1.0f / (float_t(_size) * 2.0f + 1.0f)));
+		parameters[P_STEP_SCALE].set_float2(float_t(_step_scale.first), float_t(_step_scale.second));
+		parameters[P_SIZE].set_float(float_t(_size));
+		parameters[P_SIZE_INVERSE_MUL].set_float(float_t(1.0f / (float_t(_size) * 2.0f + 1.0f)));
 
 		{
 			auto op = _rendertarget->render(uint32_t(width), uint32_t(height));
@@ -87,6 +87,7 @@ namespace streamfx::gfx {
 			std::pair<double_t, double_t>                      _step_scale;
 			std::shared_ptr<::streamfx::obs::gs::texture>      _input_texture;
 			std::shared_ptr<::streamfx::obs::gs::rendertarget> _rendertarget;
+			streamfx::obs::gs::effect_bindings                 _parameters;
 
 			private:
 			std::shared_ptr<::streamfx::obs::gs::rendertarget> _rendertarget2;
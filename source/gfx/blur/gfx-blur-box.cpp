@@ -34,6 +34,19 @@
 
 #define ST_MAX_BLUR_SIZE 128 // Also change this in box.effect if modified.
 
+namespace {
+	// Indices into the parameter bindings of streamfx::gfx::blur::box.
+	enum parameter : std::size_t {
+		P_IMAGE,
+		P_IMAGE_TEXEL,
+		P_STEP_SCALE,
+		P_SIZE,
+		P_SIZE_INVERSE_MUL,
+		P_ANGLE,
+		P_CENTER,
+	};
+} // namespace
+
 streamfx::gfx::blur::box_data::box_data()
 {
 	auto gctx = streamfx::obs::gs::context();
@@ -197,7 +210,8 @@ std::shared_ptr<::streamfx::gfx::blur::box_data> streamfx::gfx::blur::box_factor
 }
 
 streamfx::gfx::blur::box::box()
-	: _data(::streamfx::gfx::blur::box_factory::get().data()), _size(1.), _step_scale({1., 1.})
+	: _data(::streamfx::gfx::blur::box_factory::get().data()), _size(1.), _step_scale({1., 1.}),
+	  _parameters({"pImage", "pImageTexel", "pStepScale", "pSize", "pSizeInverseMul", "pAngle", "pCenter"})
 {
 	auto gctx      = streamfx::obs::gs::context();
 	_rendertarget  = std::make_shared<::streamfx::obs::gs::rendertarget>(GS_RGBA, GS_ZS_NONE);
@@ -257,9 +271,7 @@ std::shared_ptr<::streamfx::obs::gs::texture> streamfx::gfx::blur::box::render()
 {
 	auto gctx = streamfx::obs::gs::context();
 
-#ifdef ENABLE_PROFILING
 	auto gdmp = streamfx::obs::gs::debug_marker(streamfx::obs::gs::debug_color_azure_radiance, "Box Blur");
-#endif
 
 	float_t width  = float_t(_input_texture->get_width());
 	float_t height = float_t(_input_texture->get_height());
@@ -278,19 +290,18 @@ std::shared_ptr<::streamfx::obs::gs::texture> streamfx::gfx::blur::box::render()
 	gs_stencil_op(GS_STENCIL_BOTH, GS_ZERO, GS_ZERO, GS_ZERO);
 
 	// Two Pass Blur
-	streamfx::obs::gs::effect effect = _data->get_effect();
+	streamfx::obs::gs::effect effect     = _data->get_effect();
+	auto&                     parameters = _parameters.bind(effect);
 	if (effect) {
 		// Pass 1
-		effect.get_parameter("pImage").set_texture(_input_texture);
-		effect.get_parameter("pImageTexel").set_float2(float_t(1.f / width), 0.f);
-		effect.get_parameter("pStepScale").set_float2(float_t(_step_scale.first), float_t(_step_scale.second));
-		effect.get_parameter("pSize").set_float(float_t(_size));
-		effect.get_parameter("pSizeInverseMul").set_float(float_t(1.0f / (float_t(_size) * 2.0f + 1.0f)));
+		parameters[P_IMAGE].set_texture(_input_texture);
+		parameters[P_IMAGE_TEXEL].set_float2(float_t(1.f / width), 0.f);
+		parameters[P_STEP_SCALE].set_float2(float_t(_step_scale.first), float_t(_step_scale.second));
+		parameters[P_SIZE].set_float(float_t(_size));
+		parameters[P_SIZE_INVERSE_MUL].set_float(float_t(1.0f / (float_t(_size) * 2.0f + 1.0f)));
 
 		{
-#ifdef ENABLE_PROFILING
 			auto gdm = streamfx::obs::gs::debug_marker(streamfx::obs::gs::debug_color_azure_radiance, "Horizontal");
-#endif
 
 			auto op = _rendertarget2->render(uint32_t(width), uint32_t(height));
 			gs_ortho(0, 1., 0, 1., 0, 1.);
@@ -300,13 +311,11 @@ std::shared_ptr<::streamfx::obs::gs::texture> streamfx::gfx::blur::box::render()
 		}
 
 		// Pass 2
-		effect.get_parameter("pImage").set_texture(_rendertarget2->get_texture());
-		effect.get_parameter("pImageTexel").set_float2(0.f, float_t(1.f / height));
+		parameters[P_IMAGE].set_texture(_rendertarget2->get_texture());
+		parameters[P_IMAGE_TEXEL].set_float2(0.f, float_t(1.f / height));
 
 		{
-#ifdef ENABLE_PROFILING
 			auto gdm = streamfx::obs::gs::debug_marker(streamfx::obs::gs::debug_color_azure_radiance, "Vertical");
-#endif
 
 			auto op = _rendertarget->render(uint32_t(width), uint32_t(height));
 			gs_ortho(0, 1., 0, 1., 0, 1.);
@@ -347,9 +356,7 @@ std::shared_ptr<::streamfx::obs::gs::texture> streamfx::gfx::blur::box_direction
 {
 	auto gctx = streamfx::obs::gs::context();
 
-#ifdef ENABLE_PROFILING
 	auto gdmp = streamfx::obs::gs::debug_marker(streamfx::obs::gs::debug_color_azure_radiance, "Box Directional Blur");
-#endif
 
 	float_t width  = float_t(_input_texture->get_width());
 	float_t height = float_t(_input_texture->get_height());
@@ -368,14 +375,15 @@ std::shared_ptr<::streamfx::obs::gs::texture> streamfx::gfx::blur::box_direction
 	gs_stencil_op(GS_STENCIL_BOTH, GS_ZERO, GS_ZERO, GS_ZERO);
 
 	// One Pass Blur
-	streamfx::obs::gs::effect effect = _data->get_effect();
+	streamfx::obs::gs::effect effect     = _data->get_effect();
+	auto&                     parameters = _parameters.bind(effect);
 	if (effect) {
-		effect.get_parameter("pImage").set_texture(_input_texture);
-		effect.get_parameter("pImageTexel")
+		parameters[P_IMAGE].set_texture(_input_texture);
+		parameters[P_IMAGE_TEXEL]
 			.set_float2(float_t(1. / width * cos(_angle)), float_t(1.f / height * sin(_angle)));
-		effect.get_parameter("pStepScale").set_float2(float_t(_step_scale.first), float_t(_step_scale.second));
-		effect.get_parameter("pSize").set_float(float_t(_size));
-		effect.get_parameter("pSizeInverseMul").set_float(float_t(1.0f / (float_t(_size) * 2.0f + 1.0f)));
+		parameters[P_STEP_SCALE].set_float2(float_t(_step_scale.first), float_t(_step_scale.second));
+		parameters[P_SIZE].set_float(float_t(_size));
+		parameters[P_SIZE_INVERSE_MUL].set_float(float_t(1.0f / (float_t(_size) * 2.0f + 1.0f)));
 
 		{
 			auto op = _rendertarget->render(uint32_t(width), uint32_t(height));
@@ -422,9 +430,7 @@ std::shared_ptr<::streamfx::obs::gs::texture> streamfx::gfx::blur::box_rotationa
 {
 	auto gctx = streamfx::obs::gs::context();
 
-#ifdef ENABLE_PROFILING
 	auto gdmp = streamfx::obs::gs::debug_marker(streamfx::obs::gs::debug_color_azure_radiance, "Box Rotational Blur");
-#endif
 
 	float_t width  = float_t(_input_texture->get_width());
 	float_t height = float_t(_input_texture->get_height());
@@ -443,15 +449,16 @@ std::shared_ptr<::streamfx::obs::gs::texture> streamfx::gfx::blur::box_rotationa
 	gs_stencil_op(GS_STENCIL_BOTH, GS_ZERO, GS_ZERO, GS_ZERO);
 
 	// One Pass Blur
-	streamfx::obs::gs::effect effect = _data->get_effect();
+	streamfx::obs::gs::effect effect     = _data->get_effect();
+	auto&                     parameters = _parameters.bind(effect);
 	if (effect) {
-		effect.get_parameter("pImage").set_texture(_input_texture);
-		effect.get_parameter("pImageTexel").set_float2(float_t(1.f / width), float_t(1.f / height));
-		effect.get_parameter("pStepScale").set_float2(float_t(_step_scale.first), float_t(_step_scale.second));
-		effect.get_parameter("pSize").set_float(float_t(_size));
-		effect.get_parameter("pSizeInverseMul").set_float(float_t(1.0f / (float_t(_size) * 2.0f + 1.0f)));
-		effect.get_parameter("pAngle").set_float(float_t(_angle / _size));
-		effect.get_parameter("pCenter").set_float2(float_t(_center.first), float_t(_center.second));
+		parameters[P_IMAGE].set_texture(_input_texture);
+		parameters[P_IMAGE_TEXEL].set_float2(float_t(1.f / width), float_t(1.f / height));
+		parameters[P_STEP_SCALE].set_float2(float_t(_step_scale.first), float_t(_step_scale.second));
+		parameters[P_SIZE].set_float(float_t(_size));
+		parameters[P_SIZE_INVERSE_MUL].set_float(float_t(1.0f / (float_t(_size) * 2.0f + 1.0f)));
+		parameters[P_ANGLE].set_float(float_t(_angle / _size));
+		parameters[P_CENTER].set_float2(float_t(_center.first), float_t(_center.second));
 
 		{
 			auto op = _rendertarget->render(uint32_t(width), uint32_t(height));
@@ -488,9 +495,7 @@ std::shared_ptr<::streamfx::obs::gs::texture> streamfx::gfx::blur::box_zoom::ren
 {
 	auto gctx = streamfx::obs::gs::context();
 
-#ifdef ENABLE_PROFILING
 	auto gdmp = streamfx::obs::gs::debug_marker(streamfx::obs::gs::debug_color_azure_radiance, "Box Zoom Blur");
-#endif
 
 	float_t width  = float_t(_input_texture->get_width());
 	float_t height = float_t(_input_texture->get_height());
@@ -509,14 +514,15 @@ std::shared_ptr<::streamfx::obs::gs::texture> streamfx::gfx::blur::box_zoom::ren
 	gs_stencil_op(GS_STENCIL_BOTH, GS_ZERO, GS_ZERO, GS_ZERO);
 
 	// One Pass Blur
-	streamfx::obs::gs::effect effect = _data->get_effect();
+	streamfx::obs::gs::effect effect     = _data->get_effect();
+	auto&                     parameters = _parameters.bind(effect);
 	if (effect) {
-		effect.get_parameter("pImage").set_texture(_input_texture);
-		effect.get_parameter("pImageTexel").set_float2(float_t(1.f / width), float_t(1.f / height));
-		effect.get_parameter("pStepScale").set_float2(float_t(_step_scale.first), float_t(_step_scale.second));
-		effect.get_parameter("pSize").set_float(float_t(_size));
-		effect.get_parameter("pSizeInverseMul").set_float(float_t(1.0f / (float_t(_size) * 2.0f + 1.0f)));
-		effect.get_parameter("pCenter").set_float2(float_t(_center.first), float_t(_center.second));
+		parameters[P_IMAGE].set_texture(_input_texture);
+		parameters[P_IMAGE_TEXEL].set_float2(float_t(1.f / width), float_t(1.f / height));
+		parameters[P_STEP_SCALE].set_float2(float_t(_step_scale.first), float_t(_step_scale.second));
+		parameters[P_SIZE].set_float(float_t(_size));
+		parameters[P_SIZE_INVERSE_MUL].set_float(float_t(1.0f / (float_t(_size) * 2.0f + 1.0f)));
+		parameters[P_CENTER].set_float2(float_t(_center.first), float_t(_center.second));
 
 		{
 			auto op = _rendertarget->render(uint32_t(width), uint32_t(height));
@@ -17,6 +17,7 @@
 
 #include "gfx-blur-dual-filtering.hpp"
 #include <algorithm>
+#include <cmath>
 #include <stdexcept>
 #include "obs/gs/gs-helper.hpp"
 #include "plugin.hpp"
@@ -48,9 +49,26 @@
 //   6: 3 Iteration (8x), Arm Size 7, Offset Scale 0.75
 //   7: 3 Iteration (8x), Arm Size 8, Offset Scale 1.0
 //   ...
+//
+// Fractional iterations blend the result of the last iteration with the level below it, so the
+//  size changes smoothly instead of in steps. When sized by radius, each doubling of the radius
+//  adds one iteration, so a radius of 2 is 1 iteration, 4 is 2 iterations, 6 is ~2.58 iterations.
 
 #define ST_MAX_LEVELS 16
 
+#define ST_MAX_RADIUS 4096.
+
+namespace {
+	// Indices into the parameter bindings of streamfx::gfx::blur::dual_filtering.
+	enum parameter : std::size_t {
+		P_IMAGE,
+		P_IMAGE_SIZE,
+		P_IMAGE_TEXEL,
+		P_BASE,
+		P_BLEND,
+	};
+} // namespace
+
 streamfx::gfx::blur::dual_filtering_data::dual_filtering_data()
 {
 	auto gctx = streamfx::obs::gs::context();
@@ -75,7 +93,7 @@ streamfx::obs::gs::effect streamfx::gfx::blur::dual_filtering_data::get_effect()
 	return _effect;
 }
 
-streamfx::gfx::blur::dual_filtering_factory::dual_filtering_factory() {}
+streamfx::gfx::blur::dual_filtering_factory::dual_filtering_factory(bool by_radius) : _by_radius(by_radius) {}
 
 streamfx::gfx::blur::dual_filtering_factory::~dual_filtering_factory() {}
 
@@ -94,7 +112,7 @@ std::shared_ptr<::streamfx::gfx::blur::base>
 {
 	switch (type) {
 	case ::streamfx::gfx::blur::type::Area:
-		return std::make_shared<::streamfx::gfx::blur::dual_filtering>();
+		return std::make_shared<::streamfx::gfx::blur::dual_filtering>(_by_radius);
 	default:
 		throw std::runtime_error("Invalid type.");
 	}
@@ -107,12 +125,12 @@ double_t streamfx::gfx::blur::dual_filtering_factory::get_min_size(::streamfx::g
 
 double_t streamfx::gfx::blur::dual_filtering_factory::get_step_size(::streamfx::gfx::blur::type)
 {
-	return double_t(1.);
+	return _by_radius ? double_t(1.) : double_t(0.01);
 }
 
 double_t streamfx::gfx::blur::dual_filtering_factory::get_max_size(::streamfx::gfx::blur::type)
 {
-	return double_t(ST_MAX_LEVELS);
+	return _by_radius ? double_t(ST_MAX_RADIUS) : double_t(ST_MAX_LEVELS);
 }
 
 double_t streamfx::gfx::blur::dual_filtering_factory::get_min_angle(::streamfx::gfx::blur::type)
@@ -178,24 +196,23 @@ std::shared_ptr<::streamfx::gfx::blur::dual_filtering_data> streamfx::gfx::blur:
 
 ::streamfx::gfx::blur::dual_filtering_factory& streamfx::gfx::blur::dual_filtering_factory::get()
 {
-	static ::streamfx::gfx::blur::dual_filtering_factory instance;
+	static ::streamfx::gfx::blur::dual_filtering_factory instance(false);
 	return instance;
 }
 
-streamfx::gfx::blur::dual_filtering::dual_filtering()
-	: _data(::streamfx::gfx::blur::dual_filtering_factory::get().data()), _size(0), _iterations(0)
+::streamfx::gfx::blur::dual_filtering_factory& streamfx::gfx::blur::dual_filtering_factory::get_radius()
 {
-	auto gctx = streamfx::obs::gs::context();
-	_rts.resize(ST_MAX_LEVELS + 1);
-	for (std::size_t n = 0; n <= ST_MAX_LEVELS; n++) {
-		gs_color_format cf = GS_RGBA;
-#if 0
-		cf = GS_RGBA16F;
-#elif 0
-		cf = GS_RGBA32F;
-#endif
-		_rts[n] = std::make_shared<streamfx::obs::gs::rendertarget>(cf, GS_ZS_NONE);
-	}
+	static ::streamfx::gfx::blur::dual_filtering_factory instance(true);
+	return instance;
+}
+
+streamfx::gfx::blur::dual_filtering::dual_filtering(bool by_radius)
+	: _data(::streamfx::gfx::blur::dual_filtering_factory::get().data()),
+	  _rt_pool(streamfx::obs::gs::rendertarget_pool::get()), _by_radius(by_radius), _size(0), _iterations(0),
+	  _parameters({"pImage", "pImageSize", "pImageTexel", "pBase", "pBlend"})
+{
+	auto gctx     = streamfx::obs::gs::context();
+	_rendertarget = std::make_shared<streamfx::obs::gs::rendertarget>(GS_RGBA, GS_ZS_NONE);
 }
 
 streamfx::gfx::blur::dual_filtering::~dual_filtering() {}
@@ -217,8 +234,12 @@ double_t streamfx::gfx::blur::dual_filtering::get_size()
 
 void streamfx::gfx::blur::dual_filtering::set_size(double_t width)
 {
-	_size       = width;
-	_iterations = std::clamp<size_t>(static_cast<size_t>(round(width)), 0, ST_MAX_LEVELS);
+	_size = width;
+	if (_by_radius) {
+		_iterations = std::clamp<double_t>(std::log2(std::max<double_t>(width, 1.)), 0., ST_MAX_LEVELS);
+	} else {
+		_iterations = std::clamp<double_t>(width, 0., ST_MAX_LEVELS);
+	}
 }
 
 void streamfx::gfx::blur::dual_filtering::set_step_scale(double_t, double_t) {}
@@ -229,15 +250,35 @@ std::shared_ptr<::streamfx::obs::gs::texture> streamfx::gfx::blur::dual_filterin
 {
 	auto gctx = streamfx::obs::gs::context();
 
-#ifdef ENABLE_PROFILING
 	auto gdmp = streamfx::obs::gs::debug_marker(streamfx::obs::gs::debug_color_azure_radiance, "Dual-Filtering Blur");
-#endif
 
-	auto effect = _data->get_effect();
+	auto  effect     = _data->get_effect();
+	auto& parameters = _parameters.bind(effect);
 	if (!effect) {
 		return _input_texture;
 	}
 
+	uint32_t width  = _input_texture->get_width();
+	uint32_t height = _input_texture->get_height();
+
+	// Never reduce the image below a single texel.
+	std::size_t max_iterations = 0;
+	while ((max_iterations < ST_MAX_LEVELS) && ((width >> (max_iterations + 1)) > 0)
+		   && ((height >> (max_iterations + 1)) > 0)) {
+		max_iterations++;
+	}
+
+	// The whole iterations are applied as is, while a fractional part adds one more iteration which is blended in.
+	double_t    iterations_real = std::min<double_t>(_iterations, double_t(max_iterations));
+	std::size_t iterations      = static_cast<std::size_t>(std::ceil(iterations_real - 0.001));
+	float_t     blend           = float_t(iterations_real - std::floor(iterations_real));
+	if ((blend < 0.001f) || (blend > 0.999f)) { // Close enough to a whole number of iterations.
+		blend = 1.0f;
+	}
+	if (iterations == 0) { // Straight copy.
+		return _input_texture;
+	}
+
 	gs_blend_state_push();
 	gs_reset_blend_state();
 	gs_enable_color(true, true, true, true);
@@ -251,20 +292,18 @@ std::shared_ptr<::streamfx::obs::gs::texture> streamfx::gfx::blur::dual_filterin
 	gs_stencil_function(GS_STENCIL_BOTH, GS_ALWAYS);
 	gs_stencil_op(GS_STENCIL_BOTH, GS_ZERO, GS_ZERO, GS_ZERO);
 
-	uint32_t width      = _input_texture->get_width();
-	uint32_t height     = _input_texture->get_height();
-	size_t   iterations = _iterations;
+	// Level 0 is the original image when downsampling, and the persistent output when upsampling. All other levels
+	// are leased until everything has been rendered, so that instances of the same size share them.
+	std::vector<std::shared_ptr<streamfx::obs::gs::rendertarget>> rts(iterations + 1);
 
 	// Downsample
 	for (std::size_t n = 1; n <= iterations; n++) {
-#ifdef ENABLE_PROFILING
 		auto gdm = streamfx::obs::gs::debug_marker(streamfx::obs::gs::debug_color_azure_radiance, "Down %" PRIuMAX, n);
-#endif
 
 		// Select Texture
 		std::shared_ptr<streamfx::obs::gs::texture> tex;
 		if (n > 1) {
-			tex = _rts[n - 1]->get_texture();
+			tex = rts[n - 1]->get_texture();
 		} else { // Idx 0 is a simply considered as a straight copy of the original and not rendered to.
 			tex = _input_texture;
 		}
@@ -272,18 +311,15 @@ std::shared_ptr<::streamfx::obs::gs::texture> streamfx::gfx::blur::dual_filterin
 		// Reduce Size
 		uint32_t owidth  = width >> n;
 		uint32_t oheight = height >> n;
-		if ((owidth == 0) || (oheight == 0)) {
-			iterations = n - 1;
-			break;
-		}
 
 		// Apply
-		effect.get_parameter("pImage").set_texture(tex);
-		effect.get_parameter("pImageSize").set_float2(float_t(owidth), float_t(oheight));
-		effect.get_parameter("pImageTexel").set_float2(0.5f / owidth, 0.5f / oheight);
+		parameters[P_IMAGE].set_texture(tex);
+		parameters[P_IMAGE_SIZE].set_float2(float_t(owidth), float_t(oheight));
+		parameters[P_IMAGE_TEXEL].set_float2(0.5f / owidth, 0.5f / oheight);
 
+		rts[n] = _rt_pool->acquire(GS_RGBA, GS_ZS_NONE, owidth, oheight);
 		{
-			auto op = _rts[n]->render(owidth, oheight);
+			auto op = rts[n]->render(owidth, oheight);
 			gs_ortho(0., 1., 0., 1., 0., 1.);
 			while (gs_effect_loop(effect.get_object(), "Down")) {
 				streamfx::gs_draw_fullscreen_tri();
@@ -293,12 +329,10 @@ std::shared_ptr<::streamfx::obs::gs::texture> streamfx::gfx::blur::dual_filterin
 
 	// Upsample
 	for (std::size_t n = iterations; n > 0; n--) {
-#ifdef ENABLE_PROFILING
 		auto gdm = streamfx::obs::gs::debug_marker(streamfx::obs::gs::debug_color_azure_radiance, "Up %" PRIuMAX, n);
-#endif
 
 		// Select Texture
-		std::shared_ptr<streamfx::obs::gs::texture> tex = _rts[n]->get_texture();
+		std::shared_ptr<streamfx::obs::gs::texture> tex = rts[n]->get_texture();
 
 		// Get Size
 		uint32_t iwidth  = tex->get_width();
@@ -306,15 +340,31 @@ std::shared_ptr<::streamfx::obs::gs::texture> streamfx::gfx::blur::dual_filterin
 		uint32_t owidth  = width >> (n - 1);
 		uint32_t oheight = height >> (n - 1);
 
+		// The first step up blends with the level it replaces, which still holds the downsampled image.
+		bool                                        blended = (n == iterations) && (blend < 1.0f);
+		std::shared_ptr<streamfx::obs::gs::texture> base;
+		if (blended) {
+			base = (n > 1) ? rts[n - 1]->get_texture() : _input_texture;
+		}
+		if (n == 1) {
+			rts[n - 1] = _rendertarget;
+		} else if (blended) {
+			rts[n - 1] = _rt_pool->acquire(GS_RGBA, GS_ZS_NONE, owidth, oheight);
+		}
+
 		// Apply
-		effect.get_parameter("pImage").set_texture(tex);
-		effect.get_parameter("pImageSize").set_float2(float_t(iwidth), float_t(iheight));
-		effect.get_parameter("pImageTexel").set_float2(0.5f / iwidth, 0.5f / iheight);
+		parameters[P_IMAGE].set_texture(tex);
+		parameters[P_IMAGE_SIZE].set_float2(float_t(iwidth), float_t(iheight));
+		parameters[P_IMAGE_TEXEL].set_float2(0.5f / iwidth, 0.5f / iheight);
+		if (blended) {
+			parameters[P_BASE].set_texture(base);
+			parameters[P_BLEND].set_float(blend);
+		}
 
 		{
-			auto op = _rts[n - 1]->render(owidth, oheight);
+			auto op = rts[n - 1]->render(owidth, oheight);
 			gs_ortho(0., 1., 0., 1., 0., 1.);
-			while (gs_effect_loop(effect.get_object(), "Up")) {
+			while (gs_effect_loop(effect.get_object(), blended ? "UpBlend" : "Up")) {
 				streamfx::gs_draw_fullscreen_tri();
 			}
 		}
@@ -322,10 +372,10 @@ std::shared_ptr<::streamfx::obs::gs::texture> streamfx::gfx::blur::dual_filterin
 
 	gs_blend_state_pop();
 
-	return _rts[0]->get_texture();
+	return _rendertarget->get_texture();
 }
 
 std::shared_ptr<::streamfx::obs::gs::texture> streamfx::gfx::blur::dual_filtering::get()
 {
-	return _rts[0]->get_texture();
+	return _rendertarget->get_texture();
 }
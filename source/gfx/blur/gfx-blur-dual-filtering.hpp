@@ -21,6 +21,7 @@
 #include <vector>
 #include "gfx-blur-base.hpp"
 #include "obs/gs/gs-effect.hpp"
+#include "obs/gs/gs-rendertarget-pool.hpp"
 #include "obs/gs/gs-rendertarget.hpp"
 #include "obs/gs/gs-texture.hpp"
 
@@ -39,9 +40,10 @@ namespace streamfx::gfx {
 		class dual_filtering_factory : public ::streamfx::gfx::blur::ifactory {
 			std::mutex                                                _data_lock;
 			std::weak_ptr<::streamfx::gfx::blur::dual_filtering_data> _data;
+			bool                                                      _by_radius;
 
 			public:
-			dual_filtering_factory();
+			dual_filtering_factory(bool by_radius);
 			virtual ~dual_filtering_factory() override;
 
 			virtual bool is_type_supported(::streamfx::gfx::blur::type type) override;
@@ -78,20 +80,32 @@ namespace streamfx::gfx {
 
 			public: // Singleton
 			static ::streamfx::gfx::blur::dual_filtering_factory& get();
+
+			/// Same blur, but sized by radius in pixels instead of by iterations.
+			static ::streamfx::gfx::blur::dual_filtering_factory& get_radius();
 		};
 
+		/** Dual Filtering blur, which may also be sized by radius and with a fractional number of iterations.
+		 *
+		 * Each iteration halves the size of the image and doubles the blur radius. The fractional part of the
+		 * iterations blends between the results with and without the last iteration, so that the size can be animated
+		 * smoothly. Intermediate levels are leased from the render target pool for the duration of render().
+		 */
 		class dual_filtering : public ::streamfx::gfx::blur::base {
 			std::shared_ptr<::streamfx::gfx::blur::dual_filtering_data> _data;
+			std::shared_ptr<streamfx::obs::gs::rendertarget_pool>       _rt_pool;
 
-			double_t    _size;
-			std::size_t _iterations;
+			bool     _by_radius;
+			double_t _size;
+			double_t _iterations;
 
-			std::shared_ptr<streamfx::obs::gs::texture> _input_texture;
+			std::shared_ptr<streamfx::obs::gs::texture>      _input_texture;
+			std::shared_ptr<streamfx::obs::gs::rendertarget> _rendertarget;
 
-			std::vector<std::shared_ptr<streamfx::obs::gs::rendertarget>> _rts;
+			streamfx::obs::gs::effect_bindings _parameters;
 
 			public:
-			dual_filtering();
+			dual_filtering(bool by_radius = false);
 			virtual ~dual_filtering() override;
 
 			virtual void set_input(std::shared_ptr<::streamfx::obs::gs::texture> texture) override;
@@ -40,6 +40,17 @@
 #define ST_SEARCH_EXTENSION 1
 #define ST_SEARCH_RANGE ST_MAX_KERNEL_SIZE * 2
 
+namespace {
+	// Indices into the parameter bindings of streamfx::gfx::blur::gaussian_linear.
+	enum parameter : std::size_t {
+		P_IMAGE,
+		P_IMAGE_TEXEL,
+		P_STEP_SCALE,
+		P_SIZE,
+		P_KERNEL,
+	};
+} // namespace
+
 streamfx::gfx::blur::gaussian_linear_data::gaussian_linear_data()
 {
 	{
@@ -239,12 +250,13 @@ std::shared_ptr<::streamfx::gfx::blur::gaussian_linear_data> streamfx::gfx::blur
 }
 
 streamfx::gfx::blur::gaussian_linear::gaussian_linear()
-	: _data(::streamfx::gfx::blur::gaussian_linear_factory::get().data()), _size(1.), _step_scale({1., 1.})
+	: _data(::streamfx::gfx::blur::gaussian_linear_factory::get().data()), _size(1.), _step_scale({1., 1.}),
+	  _parameters({"pImage", "pImageTexel", "pStepScale", "pSize", "pKernel"}),
+	  _rt_pool(streamfx::obs::gs::rendertarget_pool::get())
 {
 	auto gctx = streamfx::obs::gs::context();
 
-	_rendertarget  = std::make_shared<streamfx::obs::gs::rendertarget>(GS_RGBA, GS_ZS_NONE);
-	_rendertarget2 = std::make_shared<streamfx::obs::gs::rendertarget>(GS_RGBA, GS_ZS_NONE);
+	_rendertarget = std::make_shared<streamfx::obs::gs::rendertarget>(GS_RGBA, GS_ZS_NONE);
 }
 
 streamfx::gfx::blur::gaussian_linear::~gaussian_linear() {}
@@ -299,12 +311,11 @@ std::shared_ptr<::streamfx::obs::gs::texture> streamfx::gfx::blur::gaussian_line
 {
 	auto gctx = streamfx::obs::gs::context();
 
-#ifdef ENABLE_PROFILING
 	auto gdmp = streamfx::obs::gs::debug_marker(streamfx::obs::gs::debug_color_azure_radiance, "Gaussian Linear Blur");
-#endif
 
-	streamfx::obs::gs::effect effect = _data->get_effect();
-	auto                      kernel = _data->get_kernel(size_t(_size));
+	streamfx::obs::gs::effect effect     = _data->get_effect();
+	auto&                     parameters = _parameters.bind(effect);
+	auto                      kernel     = _data->get_kernel(size_t(_size));
 
 	if (!effect || ((_step_scale.first + _step_scale.second) < std::numeric_limits<double_t>::epsilon())) {
 		return _input_texture;
@@ -327,48 +338,49 @@ std::shared_ptr<::streamfx::obs::gs::texture> streamfx::gfx::blur::gaussian_line
 	gs_stencil_function(GS_STENCIL_BOTH, GS_ALWAYS);
 	gs_stencil_op(GS_STENCIL_BOTH, GS_ZERO, GS_ZERO, GS_ZERO);
 
-	effect.get_parameter("pImage").set_texture(_input_texture);
-	effect.get_parameter("pStepScale").set_float2(float_t(_step_scale.first), float_t(_step_scale.second));
-	effect.get_parameter("pSize").set_float(float_t(_size));
-	effect.get_parameter("pKernel").set_value(kernel.data(), ST_MAX_KERNEL_SIZE);
+	parameters[P_IMAGE].set_texture(_input_texture);
+	parameters[P_STEP_SCALE].set_float2(float_t(_step_scale.first), float_t(_step_scale.second));
+	parameters[P_SIZE].set_float(float_t(_size));
+	parameters[P_KERNEL].set_value(kernel.data(), ST_MAX_KERNEL_SIZE);
+
+	// Only the last pass has to outlive render(), so the first one is drawn into a leased target if both are needed.
+	std::shared_ptr<::streamfx::obs::gs::rendertarget> intermediate;
 
 	// First Pass
 	if (_step_scale.first > std::numeric_limits<double_t>::epsilon()) {
-		effect.get_parameter("pImageTexel").set_float2(float_t(1.f / width), 0.f);
+		intermediate = _rendertarget;
+		if (_step_scale.second > std::numeric_limits<double_t>::epsilon()) {
+			intermediate = _rt_pool->acquire(GS_RGBA, GS_ZS_NONE, uint32_t(width), uint32_t(height));
+		}
+
+		parameters[P_IMAGE_TEXEL].set_float2(float_t(1.f / width), 0.f);
 
 		{
-#ifdef ENABLE_PROFILING
 			auto gdm = streamfx::obs::gs::debug_marker(streamfx::obs::gs::debug_color_azure_radiance, "Horizontal");
-#endif
 
-			auto op = _rendertarget2->render(uint32_t(width), uint32_t(height));
+			auto op = intermediate->render(uint32_t(width), uint32_t(height));
 			gs_ortho(0, 1., 0, 1., 0, 1.);
 			while (gs_effect_loop(effect.get_object(), "Draw")) {
 				streamfx::gs_draw_fullscreen_tri();
 			}
 		}
 
-		std::swap(_rendertarget, _rendertarget2);
-		effect.get_parameter("pImage").set_texture(_rendertarget->get_texture());
+		parameters[P_IMAGE].set_texture(intermediate->get_texture());
 	}
 
 	// Second Pass
 	if (_step_scale.second > std::numeric_limits<double_t>::epsilon()) {
-		effect.get_parameter("pImageTexel").set_float2(0.f, float_t(1.f / height));
+		parameters[P_IMAGE_TEXEL].set_float2(0.f, float_t(1.f / height));
 
 		{
-#ifdef ENABLE_PROFILING
 			auto gdm = streamfx::obs::gs::debug_marker(streamfx::obs::gs::debug_color_azure_radiance, "Vertical");
-#endif
 
-			auto op = _rendertarget2->render(uint32_t(width), uint32_t(height));
+			auto op = _rendertarget->render(uint32_t(width), uint32_t(height));
 			gs_ortho(0, 1., 0, 1., 0, 1.);
 			while (gs_effect_loop(effect.get_object(), "Draw")) {
 				streamfx::gs_draw_fullscreen_tri();
 			}
 		}
-
-		std::swap(_rendertarget, _rendertarget2);
 	}
 
 	gs_blend_state_pop();
@@ -404,13 +416,12 @@ std::shared_ptr<::streamfx::obs::gs::texture> streamfx::gfx::blur::gaussian_line
 {
 	auto gctx = streamfx::obs::gs::context();
 
-#ifdef ENABLE_PROFILING
 	auto gdmp = streamfx::obs::gs::debug_marker(streamfx::obs::gs::debug_color_azure_radiance,
 												"Gaussian Linear Directional Blur");
-#endif
 
-	streamfx::obs::gs::effect effect = _data->get_effect();
-	auto                      kernel = _data->get_kernel(size_t(_size));
+	streamfx::obs::gs::effect effect     = _data->get_effect();
+	auto&                     parameters = _parameters.bind(effect);
+	auto                      kernel     = _data->get_kernel(size_t(_size));
 
 	if (!effect || ((_step_scale.first + _step_scale.second) < std::numeric_limits<double_t>::epsilon())) {
 		return _input_texture;
@@ -433,12 +444,12 @@ std::shared_ptr<::streamfx::obs::gs::texture> streamfx::gfx::blur::gaussian_line
 	gs_stencil_function(GS_STENCIL_BOTH, GS_ALWAYS);
 	gs_stencil_op(GS_STENCIL_BOTH, GS_ZERO, GS_ZERO, GS_ZERO);
 
-	effect.get_parameter("pImage").set_texture(_input_texture);
-	effect.get_parameter("pImageTexel")
+	parameters[P_IMAGE].set_texture(_input_texture);
+	parameters[P_IMAGE_TEXEL]
 		.set_float2(float_t(1.f / width * cos(_angle)), float_t(1.f / height * sin(_angle)));
-	effect.get_parameter("pStepScale").set_float2(float_t(_step_scale.first), float_t(_step_scale.second));
-	effect.get_parameter("pSize").set_float(float_t(_size));
-	effect.get_parameter("pKernel").set_value(kernel.data(), ST_MAX_KERNEL_SIZE);
+	parameters[P_STEP_SCALE].set_float2(float_t(_step_scale.first), float_t(_step_scale.second));
+	parameters[P_SIZE].set_float(float_t(_size));
+	parameters[P_KERNEL].set_value(kernel.data(), ST_MAX_KERNEL_SIZE);
 
 	// First Pass
 	{
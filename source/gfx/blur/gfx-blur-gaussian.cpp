@@ -17,6 +17,7 @@
 
 #include "gfx-blur-gaussian.hpp"
 #include <algorithm>
+#include <array>
 #include <stdexcept>
 #include "obs/gs/gs-helper.hpp"
 #include "plugin.hpp"
@@ -35,77 +36,74 @@
 
 #define ST_KERNEL_SIZE 128u
 #define ST_OVERSAMPLE_MULTIPLIER 2
-#define ST_MAX_BLUR_SIZE ST_KERNEL_SIZE / ST_OVERSAMPLE_MULTIPLIER
-
-streamfx::gfx::blur::gaussian_data::gaussian_data()
-{
-	using namespace streamfx::util;
-
-	std::vector<double> kernel_dbl(ST_KERNEL_SIZE);
-	std::vector<float>  kernel(ST_KERNEL_SIZE);
-
+#define ST_MAX_BLUR_SIZE (ST_KERNEL_SIZE / ST_OVERSAMPLE_MULTIPLIER)
+
+namespace {
+	// Indices into the parameter bindings of streamfx::gfx::blur::gaussian.
+	enum parameter : std::size_t {
+		P_IMAGE,
+		P_IMAGE_TEXEL,
+		P_STEP_SCALE,
+		P_SIZE,
+		P_ANGLE,
+		P_CENTER,
+		P_KERNEL,
+	};
+
+	// std::exp is not constexpr. Only ever called with small negative values, for which the series converges quickly.
+	constexpr double_t kernel_exp(double_t x)
 	{
-		auto gctx = streamfx::obs::gs::context();
-
-		{
-			auto file = streamfx::data_file_path("effects/blur/gaussian.effect");
-			try {
-				_effect = streamfx::obs::gs::effect::create(file);
-			} catch (const std::exception& ex) {
-				DLOG_ERROR("Error loading '%s': %s", file.generic_u8string().c_str(), ex.what());
-			}
+		double_t sum  = 1.;
+		double_t term = 1.;
+		for (std::size_t n = 1; n < 24; n++) {
+			term *= x / static_cast<double_t>(n);
+			sum += term;
 		}
+		return sum;
 	}
 
-	//#define ST_USE_PASCAL_TRIANGLE
-
-	// Pre-calculate Kernel Information for all Kernel sizes
-	for (size_t size = 1; size <= ST_MAX_BLUR_SIZE; size++) {
-#ifdef ST_USE_PASCAL_TRIANGLE
-		// The Pascal Triangle can be used to generate Gaussian Kernels, which is
-		// significantly faster than doing the same task with searching. It is also
-		// much more accurate at the same time, so it is a 2-in-1 solution.
-
-		// Generate the required row and sum.
-		size_t offset   = size;
-		size_t row      = size * 2;
-		auto   triangle = math::pascal_triangle<double>(row);
-		double sum      = pow(2, row);
-
-		// Convert all integers to floats.
-		double accum = 0.;
-		for (size_t idx = offset; idx < std::min<size_t>(triangle.size(), ST_KERNEL_SIZE); idx++) {
-			double v                 = static_cast<double>(triangle[idx]) / sum;
-			kernel_dbl[idx - offset] = v;
-			// Accumulator needed as we end up with float inaccuracies above a certain threshold.
-			accum += v * (idx > offset ? 2 : 1);
-		}
+	// Kernels for all sizes from 1 to ST_MAX_BLUR_SIZE, each ST_KERNEL_SIZE entries long and padded with zeros.
+	constexpr std::array<float_t, ST_MAX_BLUR_SIZE * ST_KERNEL_SIZE> generate_kernels()
+	{
+		std::array<float_t, ST_MAX_BLUR_SIZE * ST_KERNEL_SIZE> kernels{};
+
+		for (std::size_t size = 1; size <= ST_MAX_BLUR_SIZE; size++) {
+			std::size_t oversample = std::min<std::size_t>(size * ST_OVERSAMPLE_MULTIPLIER, ST_KERNEL_SIZE);
+			double_t    weights[ST_KERNEL_SIZE]{};
+
+			// The weight at idx is exp(-idx^2 / (2 * size^2)), which is a^(idx^2) for a = exp(-1 / (2 * size^2)).
+			// Consecutive weights differ by a factor of a^(2 * idx + 1), so a single exp() per size is enough. The
+			// normalization factor of the gaussian function cancels out when dividing by the total.
+			double_t a      = kernel_exp(-0.5 / static_cast<double_t>(size * size));
+			double_t weight = 1.;
+			double_t step   = a;
+			double_t total  = 0.;
+			for (std::size_t idx = 0; idx < oversample; idx++) {
+				weights[idx] = weight;
+				total += weight * (idx > 0 ? 2 : 1);
+				weight *= step;
+				step *= a * a;
+			}
 
-		// Rescale all values back into useful ranges.
-		accum = 1. / accum;
-		for (size_t idx = offset; idx < ST_KERNEL_SIZE; idx++) {
-			kernel[idx - offset] = kernel_dbl[idx - offset] * accum;
-		}
-#else
-		size_t oversample = size * ST_OVERSAMPLE_MULTIPLIER;
-
-		// Generate initial weights and calculate a total from them.
-		double total = 0.;
-		for (size_t idx = 0; (idx < oversample) && (idx < ST_KERNEL_SIZE); idx++) {
-			kernel_dbl[idx] = math::gaussian<double>(static_cast<double>(idx), static_cast<double>(size));
-			total += kernel_dbl[idx] * (idx > 0 ? 2 : 1);
+			for (std::size_t idx = 0; idx < oversample; idx++) {
+				kernels[(size - 1) * ST_KERNEL_SIZE + idx] = static_cast<float_t>(weights[idx] / total);
+			}
 		}
 
-		// Scale the weights according to the total gathered, and convert to float.
-		for (size_t idx = 0; (idx < oversample) && (idx < ST_KERNEL_SIZE); idx++) {
-			kernel_dbl[idx] /= total;
-			kernel[idx] = static_cast<float>(kernel_dbl[idx]);
-		}
+		return kernels;
+	}
 
-#endif
+	constexpr auto kernels = generate_kernels();
+} // namespace
 
-		// Store Kernel
-		_kernels.insert_or_assign(size, kernel);
+streamfx::gfx::blur::gaussian_data::gaussian_data()
+{
+	auto gctx = streamfx::obs::gs::context();
+	auto file = streamfx::data_file_path("effects/blur/gaussian.effect");
+	try {
+		_effect = streamfx::obs::gs::effect::create(file);
+	} catch (const std::exception& ex) {
+		DLOG_ERROR("Error loading '%s': %s", file.generic_u8string().c_str(), ex.what());
 	}
 }
 
@@ -120,10 +118,10 @@ streamfx::obs::gs::effect streamfx::gfx::blur::gaussian_data::get_effect()
 	return _effect;
 }
 
-std::vector<float_t> const& streamfx::gfx::blur::gaussian_data::get_kernel(std::size_t width)
+streamfx::util::span<const float_t> streamfx::gfx::blur::gaussian_data::get_kernel(std::size_t width)
 {
 	width = std::clamp<size_t>(width, 1, ST_MAX_BLUR_SIZE);
-	return _kernels.at(width);
+	return {kernels.data() + (width - 1) * ST_KERNEL_SIZE, ST_KERNEL_SIZE};
 }
 
 streamfx::gfx::blur::gaussian_factory::gaussian_factory() {}
@@ -266,11 +264,12 @@ std::shared_ptr<::streamfx::gfx::blur::gaussian_data> streamfx::gfx::blur::gauss
 }
 
 streamfx::gfx::blur::gaussian::gaussian()
-	: _data(::streamfx::gfx::blur::gaussian_factory::get().data()), _size(1.), _step_scale({1., 1.})
+	: _data(::streamfx::gfx::blur::gaussian_factory::get().data()), _size(1.), _step_scale({1., 1.}),
+	  _parameters({"pImage", "pImageTexel", "pStepScale", "pSize", "pAngle", "pCenter", "pKernel"}),
+	  _rt_pool(streamfx::obs::gs::rendertarget_pool::get())
 {
-	auto gctx      = streamfx::obs::gs::context();
-	_rendertarget  = std::make_shared<streamfx::obs::gs::rendertarget>(GS_RGBA, GS_ZS_NONE);
-	_rendertarget2 = std::make_shared<streamfx::obs::gs::rendertarget>(GS_RGBA, GS_ZS_NONE);
+	auto gctx     = streamfx::obs::gs::context();
+	_rendertarget = std::make_shared<streamfx::obs::gs::rendertarget>(GS_RGBA, GS_ZS_NONE);
 }
 
 streamfx::gfx::blur::gaussian::~gaussian() {}
@@ -325,11 +324,10 @@ std::shared_ptr<::streamfx::obs::gs::texture> streamfx::gfx::blur::gaussian::ren
 {
 	auto gctx = streamfx::obs::gs::context();
 
-#ifdef ENABLE_PROFILING
 	auto gdmp = streamfx::obs::gs::debug_marker(streamfx::obs::gs::debug_color_azure_radiance, "Gaussian Blur");
-#endif
 
-	streamfx::obs::gs::effect effect = _data->get_effect();
+	streamfx::obs::gs::effect effect     = _data->get_effect();
+	auto&                     parameters = _parameters.bind(effect);
 
 	if (!effect || ((_step_scale.first + _step_scale.second) < std::numeric_limits<double_t>::epsilon())) {
 		return _input_texture;
@@ -353,48 +351,51 @@ std::shared_ptr<::streamfx::obs::gs::texture> streamfx::gfx::blur::gaussian::ren
 	gs_stencil_function(GS_STENCIL_BOTH, GS_ALWAYS);
 	gs_stencil_op(GS_STENCIL_BOTH, GS_ZERO, GS_ZERO, GS_ZERO);
 
-	effect.get_parameter("pStepScale").set_float2(float_t(_step_scale.first), float_t(_step_scale.second));
-	effect.get_parameter("pSize").set_float(float_t(_size * ST_OVERSAMPLE_MULTIPLIER));
-	effect.get_parameter("pKernel").set_value(kernel.data(), ST_KERNEL_SIZE);
+	parameters[P_STEP_SCALE].set_float2(float_t(_step_scale.first), float_t(_step_scale.second));
+	parameters[P_SIZE].set_float(float_t(_size * ST_OVERSAMPLE_MULTIPLIER));
+	parameters[P_KERNEL].set_value(kernel.data(), ST_KERNEL_SIZE);
+
+	// Only the last pass has to outlive render(), so the first one is drawn into a leased target if both are needed.
+	std::shared_ptr<::streamfx::obs::gs::rendertarget> intermediate;
+	std::shared_ptr<::streamfx::obs::gs::texture>      texture = _input_texture;
 
 	// First Pass
 	if (_step_scale.first > std::numeric_limits<double_t>::epsilon()) {
-		effect.get_parameter("pImage").set_texture(_input_texture);
-		effect.get_parameter("pImageTexel").set_float2(float_t(1.f / width), 0.f);
+		intermediate = _rendertarget;
+		if (_step_scale.second > std::numeric_limits<double_t>::epsilon()) {
+			intermediate = _rt_pool->acquire(GS_RGBA, GS_ZS_NONE, uint32_t(width), uint32_t(height));
+		}
+
+		parameters[P_IMAGE].set_texture(texture);
+		parameters[P_IMAGE_TEXEL].set_float2(float_t(1.f / width), 0.f);
 
 		{
-#ifdef ENABLE_PROFILING
 			auto gdm = streamfx::obs::gs::debug_marker(streamfx::obs::gs::debug_color_azure_radiance, "Horizontal");
-#endif
 
-			auto op = _rendertarget2->render(uint32_t(width), uint32_t(height));
+			auto op = intermediate->render(uint32_t(width), uint32_t(height));
 			gs_ortho(0, 1., 0, 1., 0, 1.);
 			while (gs_effect_loop(effect.get_object(), "Draw")) {
 				streamfx::gs_draw_fullscreen_tri();
 			}
 		}
 
-		std::swap(_rendertarget, _rendertarget2);
+		texture = intermediate->get_texture();
 	}
 
 	// Second Pass
 	if (_step_scale.second > std::numeric_limits<double_t>::epsilon()) {
-		effect.get_parameter("pImage").set_texture(_rendertarget->get_texture());
-		effect.get_parameter("pImageTexel").set_float2(0.f, float_t(1.f / height));
+		parameters[P_IMAGE].set_texture(texture);
+		parameters[P_IMAGE_TEXEL].set_float2(0.f, float_t(1.f / height));
 
 		{
-#ifdef ENABLE_PROFILING
 			auto gdm = streamfx::obs::gs::debug_marker(streamfx::obs::gs::debug_color_azure_radiance, "Vertical");
-#endif
 
-			auto op = _rendertarget2->render(uint32_t(width), uint32_t(height));
+			auto op = _rendertarget->render(uint32_t(width), uint32_t(height));
 			gs_ortho(0, 1., 0, 1., 0, 1.);
 			while (gs_effect_loop(effect.get_object(), "Draw")) {
 				streamfx::gs_draw_fullscreen_tri();
 			}
 		}
-
-		std::swap(_rendertarget, _rendertarget2);
 	}
 
 	gs_blend_state_pop();
@@ -430,12 +431,11 @@ std::shared_ptr<::streamfx::obs::gs::texture> streamfx::gfx::blur::gaussian_dire
 {
 	auto gctx = streamfx::obs::gs::context();
 
-#ifdef ENABLE_PROFILING
 	auto gdmp =
 		streamfx::obs::gs::debug_marker(streamfx::obs::gs::debug_color_azure_radiance, "Gaussian Directional Blur");
-#endif
 
-	streamfx::obs::gs::effect effect = _data->get_effect();
+	streamfx::obs::gs::effect effect     = _data->get_effect();
+	auto&                     parameters = _parameters.bind(effect);
 
 	if (!effect || ((_step_scale.first + _step_scale.second) < std::numeric_limits<double_t>::epsilon())) {
 		return _input_texture;
@@ -459,12 +459,12 @@ std::shared_ptr<::streamfx::obs::gs::texture> streamfx::gfx::blur::gaussian_dire
 	gs_stencil_function(GS_STENCIL_BOTH, GS_ALWAYS);
 	gs_stencil_op(GS_STENCIL_BOTH, GS_ZERO, GS_ZERO, GS_ZERO);
 
-	effect.get_parameter("pImage").set_texture(_input_texture);
-	effect.get_parameter("pImageTexel")
+	parameters[P_IMAGE].set_texture(_input_texture);
+	parameters[P_IMAGE_TEXEL]
 		.set_float2(float_t(1.f / width * cos(m_angle)), float_t(1.f / height * sin(m_angle)));
-	effect.get_parameter("pStepScale").set_float2(float_t(_step_scale.first), float_t(_step_scale.second));
-	effect.get_parameter("pSize").set_float(float_t(_size * ST_OVERSAMPLE_MULTIPLIER));
-	effect.get_parameter("pKernel").set_value(kernel.data(), ST_KERNEL_SIZE);
+	parameters[P_STEP_SCALE].set_float2(float_t(_step_scale.first), float_t(_step_scale.second));
+	parameters[P_SIZE].set_float(float_t(_size * ST_OVERSAMPLE_MULTIPLIER));
+	parameters[P_KERNEL].set_value(kernel.data(), ST_KERNEL_SIZE);
 
 	{
 		auto op = _rendertarget->render(uint32_t(width), uint32_t(height));
@@ -488,12 +488,11 @@ std::shared_ptr<::streamfx::obs::gs::texture> streamfx::gfx::blur::gaussian_rota
 {
 	auto gctx = streamfx::obs::gs::context();
 
-#ifdef ENABLE_PROFILING
 	auto gdmp =
 		streamfx::obs::gs::debug_marker(streamfx::obs::gs::debug_color_azure_radiance, "Gaussian Rotational Blur");
-#endif
 
-	streamfx::obs::gs::effect effect = _data->get_effect();
+	streamfx::obs::gs::effect effect     = _data->get_effect();
+	auto&                     parameters = _parameters.bind(effect);
 
 	if (!effect || ((_step_scale.first + _step_scale.second) < std::numeric_limits<double_t>::epsilon())) {
 		return _input_texture;
@@ -517,13 +516,13 @@ std::shared_ptr<::streamfx::obs::gs::texture> streamfx::gfx::blur::gaussian_rota
 	gs_stencil_function(GS_STENCIL_BOTH, GS_ALWAYS);
 	gs_stencil_op(GS_STENCIL_BOTH, GS_ZERO, GS_ZERO, GS_ZERO);
 
-	effect.get_parameter("pImage").set_texture(_input_texture);
-	effect.get_parameter("pImageTexel").set_float2(float_t(1.f / width), float_t(1.f / height));
-	effect.get_parameter("pStepScale").set_float2(float_t(_step_scale.first), float_t(_step_scale.second));
-	effect.get_parameter("pSize").set_float(float_t(_size * ST_OVERSAMPLE_MULTIPLIER));
-	effect.get_parameter("pAngle").set_float(float_t(m_angle / _size));
-	effect.get_parameter("pCenter").set_float2(float_t(m_center.first), float_t(m_center.second));
-	effect.get_parameter("pKernel").set_value(kernel.data(), ST_KERNEL_SIZE);
+	parameters[P_IMAGE].set_texture(_input_texture);
+	parameters[P_IMAGE_TEXEL].set_float2(float_t(1.f / width), float_t(1.f / height));
+	parameters[P_STEP_SCALE].set_float2(float_t(_step_scale.first), float_t(_step_scale.second));
+	parameters[P_SIZE].set_float(float_t(_size * ST_OVERSAMPLE_MULTIPLIER));
+	parameters[P_ANGLE].set_float(float_t(m_angle / _size));
+	parameters[P_CENTER].set_float2(float_t(m_center.first), float_t(m_center.second));
+	parameters[P_KERNEL].set_value(kernel.data(), ST_KERNEL_SIZE);
 
 	// First Pass
 	{
@@ -570,12 +569,11 @@ std::shared_ptr<::streamfx::obs::gs::texture> streamfx::gfx::blur::gaussian_zoom
 {
 	auto gctx = streamfx::obs::gs::context();
 
-#ifdef ENABLE_PROFILING
 	auto gdmp = streamfx::obs::gs::debug_marker(streamfx::obs::gs::debug_color_azure_radiance, "Gaussian Zoom Blur");
-#endif
 
-	streamfx::obs::gs::effect effect = _data->get_effect();
-	auto                      kernel = _data->get_kernel(size_t(_size));
+	streamfx::obs::gs::effect effect     = _data->get_effect();
+	auto&                     parameters = _parameters.bind(effect);
+	auto                      kernel     = _data->get_kernel(size_t(_size));
 
 	if (!effect || ((_step_scale.first + _step_scale.second) < std::numeric_limits<double_t>::epsilon())) {
 		return _input_texture;
@@ -598,12 +596,12 @@ std::shared_ptr<::streamfx::obs::gs::texture> streamfx::gfx::blur::gaussian_zoom
 	gs_stencil_function(GS_STENCIL_BOTH, GS_ALWAYS);
 	gs_stencil_op(GS_STENCIL_BOTH, GS_ZERO, GS_ZERO, GS_ZERO);
 
-	effect.get_parameter("pImage").set_texture(_input_texture);
-	effect.get_parameter("pImageTexel").set_float2(float_t(1.f / width), float_t(1.f / height));
-	effect.get_parameter("pStepScale").set_float2(float_t(_step_scale.first), float_t(_step_scale.second));
-	effect.get_parameter("pSize").set_float(float_t(_size));
-	effect.get_parameter("pCenter").set_float2(float_t(m_center.first), float_t(m_center.second));
-	effect.get_parameter("pKernel").set_value(kernel.data(), ST_KERNEL_SIZE);
+	parameters[P_IMAGE].set_texture(_input_texture);
+	parameters[P_IMAGE_TEXEL].set_float2(float_t(1.f / width), float_t(1.f / height));
+	parameters[P_STEP_SCALE].set_float2(float_t(_step_scale.first), float_t(_step_scale.second));
+	parameters[P_SIZE].set_float(float_t(_size));
+	parameters[P_CENTER].set_float2(float_t(m_center.first), float_t(m_center.second));
+	parameters[P_KERNEL].set_value(kernel.data(), ST_KERNEL_SIZE);
 
 	// First Pass
 	{
@@ -0,0 +1,325 @@
+// Copyright (c) 2021 Michael Fabian Dirks <info@xaymar.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "gfx-blur-pyramid.hpp"
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+#include "obs/gs/gs-helper.hpp"
+#include "plugin.hpp"
+
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable : 4201)
+#endif
+#include <obs.h>
+#include <obs-module.h>
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+// Pyramid Blur
+//
+// The cost of a regular blur grows with its radius, as every pixel has to look at every texel
+//  within it. Halving the image also halves the radius in texels, so we downsample until the
+//  remaining radius is at most ST_MAX_LEVEL_RADIUS, blur there, and then upsample again.
+//
+// That means that for a blur size of:
+//    8: No downsampling, blur with radius 8.
+//   16: 1 Level (2x), blur with radius 8.
+//   24: 2 Levels (4x), blur with radius 6.
+//  100: 4 Levels (16x), blur with radius 6.25.
+//  ...
+
+#define ST_MAX_LEVEL_RADIUS 8.
+
+#define ST_MAX_SIZE 2048.
+
+namespace {
+	// Indices into the parameter bindings of streamfx::gfx::blur::pyramid.
+	enum parameter : std::size_t {
+		P_IMAGE,
+		P_IMAGE_TEXEL,
+		P_SIZE,
+	};
+} // namespace
+
+streamfx::gfx::blur::pyramid_data::pyramid_data()
+{
+	auto gctx = streamfx::obs::gs::context();
+	{
+		auto file = streamfx::data_file_path("effects/blur/pyramid.effect");
+		try {
+			_effect = streamfx::obs::gs::effect::create(file);
+		} catch (const std::exception& ex) {
+			DLOG_ERROR("Error loading '%s': %s", file.generic_u8string().c_str(), ex.what());
+		}
+	}
+}
+
+streamfx::gfx::blur::pyramid_data::~pyramid_data()
+{
+	auto gctx = streamfx::obs::gs::context();
+	_effect.reset();
+}
+
+streamfx::obs::gs::effect streamfx::gfx::blur::pyramid_data::get_effect()
+{
+	return _effect;
+}
+
+streamfx::gfx::blur::pyramid_factory::pyramid_factory() {}
+
+streamfx::gfx::blur::pyramid_factory::~pyramid_factory() {}
+
+bool streamfx::gfx::blur::pyramid_factory::is_type_supported(::streamfx::gfx::blur::type type)
+{
+	switch (type) {
+	case ::streamfx::gfx::blur::type::Area:
+		return true;
+	default:
+		return false;
+	}
+}
+
+std::shared_ptr<::streamfx::gfx::blur::base>
+	streamfx::gfx::blur::pyramid_factory::create(::streamfx::gfx::blur::type type)
+{
+	switch (type) {
+	case ::streamfx::gfx::blur::type::Area:
+		return std::make_shared<::streamfx::gfx::blur::pyramid>();
+	default:
+		throw std::runtime_error("Invalid type.");
+	}
+}
+
+double_t streamfx::gfx::blur::pyramid_factory::get_min_size(::streamfx::gfx::blur::type)
+{
+	return double_t(1.);
+}
+
+double_t streamfx::gfx::blur::pyramid_factory::get_step_size(::streamfx::gfx::blur::type)
+{
+	return double_t(1.);
+}
+
+double_t streamfx::gfx::blur::pyramid_factory::get_max_size(::streamfx::gfx::blur::type)
+{
+	return double_t(ST_MAX_SIZE);
+}
+
+double_t streamfx::gfx::blur::pyramid_factory::get_min_angle(::streamfx::gfx::blur::type)
+{
+	return double_t(0);
+}
+
+double_t streamfx::gfx::blur::pyramid_factory::get_step_angle(::streamfx::gfx::blur::type)
+{
+	return double_t(0);
+}
+
+double_t streamfx::gfx::blur::pyramid_factory::get_max_angle(::streamfx::gfx::blur::type)
+{
+	return double_t(0);
+}
+
+bool streamfx::gfx::blur::pyramid_factory::is_step_scale_supported(::streamfx::gfx::blur::type)
+{
+	return false;
+}
+
+double_t streamfx::gfx::blur::pyramid_factory::get_min_step_scale_x(::streamfx::gfx::blur::type)
+{
+	return double_t(0);
+}
+
+double_t streamfx::gfx::blur::pyramid_factory::get_step_step_scale_x(::streamfx::gfx::blur::type)
+{
+	return double_t(0);
+}
+
+double_t streamfx::gfx::blur::pyramid_factory::get_max_step_scale_x(::streamfx::gfx::blur::type)
+{
+	return double_t(0);
+}
+
+double_t streamfx::gfx::blur::pyramid_factory::get_min_step_scale_y(::streamfx::gfx::blur::type)
+{
+	return double_t(0);
+}
+
+double_t streamfx::gfx::blur::pyramid_factory::get_step_step_scale_y(::streamfx::gfx::blur::type)
+{
+	return double_t(0);
+}
+
+double_t streamfx::gfx::blur::pyramid_factory::get_max_step_scale_y(::streamfx::gfx::blur::type)
+{
+	return double_t(0);
+}
+
+std::shared_ptr<::streamfx::gfx::blur::pyramid_data> streamfx::gfx::blur::pyramid_factory::data()
+{
+	std::unique_lock<std::mutex>                         ulock(_data_lock);
+	std::shared_ptr<::streamfx::gfx::blur::pyramid_data> data = _data.lock();
+	if (!data) {
+		data  = std::make_shared<::streamfx::gfx::blur::pyramid_data>();
+		_data = data;
+	}
+	return data;
+}
+
+::streamfx::gfx::blur::pyramid_factory& streamfx::gfx::blur::pyramid_factory::get()
+{
+	static ::streamfx::gfx::blur::pyramid_factory instance;
+	return instance;
+}
+
+streamfx::gfx::blur::pyramid::pyramid()
+	: _data(::streamfx::gfx::blur::pyramid_factory::get().data()),
+	  _rt_pool(streamfx::obs::gs::rendertarget_pool::get()), _size(0), _parameters({"pImage", "pImageTexel", "pSize"})
+{
+	auto gctx     = streamfx::obs::gs::context();
+	_rendertarget = std::make_shared<streamfx::obs::gs::rendertarget>(GS_RGBA, GS_ZS_NONE);
+}
+
+streamfx::gfx::blur::pyramid::~pyramid() {}
+
+void streamfx::gfx::blur::pyramid::set_input(std::shared_ptr<::streamfx::obs::gs::texture> texture)
+{
+	_input_texture = texture;
+}
+
+::streamfx::gfx::blur::type streamfx::gfx::blur::pyramid::get_type()
+{
+	return ::streamfx::gfx::blur::type::Area;
+}
+
+double_t streamfx::gfx::blur::pyramid::get_size()
+{
+	return _size;
+}
+
+void streamfx::gfx::blur::pyramid::set_size(double_t width)
+{
+	_size = std::clamp(width, 0., ST_MAX_SIZE);
+}
+
+void streamfx::gfx::blur::pyramid::set_step_scale(double_t, double_t) {}
+
+void streamfx::gfx::blur::pyramid::get_step_scale(double_t&, double_t&) {}
+
+std::shared_ptr<::streamfx::obs::gs::texture> streamfx::gfx::blur::pyramid::render()
+{
+	auto gctx = streamfx::obs::gs::context();
+
+	auto gdmp = streamfx::obs::gs::debug_marker(streamfx::obs::gs::debug_color_azure_radiance, "Pyramid Blur");
+
+	auto  effect     = _data->get_effect();
+	auto& parameters = _parameters.bind(effect);
+	if (!effect || !_input_texture) {
+		return _input_texture;
+	}
+
+	gs_blend_state_push();
+	gs_reset_blend_state();
+	gs_enable_color(true, true, true, true);
+	gs_enable_blending(false);
+	gs_enable_depth_test(false);
+	gs_enable_stencil_test(false);
+	gs_enable_stencil_write(false);
+	gs_set_cull_mode(GS_NEITHER);
+	gs_depth_function(GS_ALWAYS);
+	gs_blend_function(GS_BLEND_ONE, GS_BLEND_ZERO);
+	gs_stencil_function(GS_STENCIL_BOTH, GS_ALWAYS);
+	gs_stencil_op(GS_STENCIL_BOTH, GS_ZERO, GS_ZERO, GS_ZERO);
+
+	uint32_t width  = _input_texture->get_width();
+	uint32_t height = _input_texture->get_height();
+
+	// Halve until the remaining radius fits, but never below a single texel.
+	std::size_t levels = 0;
+	double_t    radius = _size;
+	while ((radius > ST_MAX_LEVEL_RADIUS) && ((width >> (levels + 1)) > 0) && ((height >> (levels + 1)) > 0)) {
+		radius /= 2.;
+		levels++;
+	}
+
+	// Intermediate levels stay leased until everything is rendered, as each pass reads from the previous one.
+	std::vector<std::shared_ptr<streamfx::obs::gs::rendertarget>> leases;
+	std::shared_ptr<streamfx::obs::gs::texture>                   tex = _input_texture;
+
+	auto pass = [&](const char* technique, std::size_t level, bool last) {
+		uint32_t owidth  = std::max<uint32_t>(width >> level, 1);
+		uint32_t oheight = std::max<uint32_t>(height >> level, 1);
+
+		std::shared_ptr<streamfx::obs::gs::rendertarget> rt = _rendertarget;
+		if (!last) {
+			rt = _rt_pool->acquire(GS_RGBA, GS_ZS_NONE, owidth, oheight);
+			leases.push_back(rt);
+		}
+
+		parameters[P_IMAGE].set_texture(tex);
+		{
+			auto op = rt->render(owidth, oheight);
+			gs_ortho(0., 1., 0., 1., 0., 1.);
+			while (gs_effect_loop(effect.get_object(), technique)) {
+				streamfx::gs_draw_fullscreen_tri();
+			}
+		}
+		tex = rt->get_texture();
+	};
+
+	// Downsample
+	for (std::size_t n = 1; n <= levels; n++) {
+		auto gdm = streamfx::obs::gs::debug_marker(streamfx::obs::gs::debug_color_azure_radiance, "Down %" PRIuMAX, n);
+
+		parameters[P_IMAGE_TEXEL].set_float2(1.f / tex->get_width(), 1.f / tex->get_height());
+		pass("Down", n, false);
+	}
+
+	// Blur
+	{
+		auto gdm = streamfx::obs::gs::debug_marker(streamfx::obs::gs::debug_color_azure_radiance, "Blur");
+
+		parameters[P_SIZE].set_float(float_t(radius));
+		parameters[P_IMAGE_TEXEL].set_float2(1.f / tex->get_width(), 0.f);
+		pass("Blur", levels, false);
+		parameters[P_IMAGE_TEXEL].set_float2(0.f, 1.f / tex->get_height());
+		pass("Blur", levels, levels == 0);
+	}
+
+	// Upsample
+	for (std::size_t n = levels; n > 0; n--) {
+		auto gdm = streamfx::obs::gs::debug_marker(streamfx::obs::gs::debug_color_azure_radiance, "Up %" PRIuMAX, n);
+
+		parameters[P_IMAGE_TEXEL].set_float2(1.f / tex->get_width(), 1.f / tex->get_height());
+		pass("Up", n - 1, n == 1);
+	}
+
+	gs_blend_state_pop();
+
+	return _rendertarget->get_texture();
+}
+
+std::shared_ptr<::streamfx::obs::gs::texture> streamfx::gfx::blur::pyramid::get()
+{
+	return _rendertarget->get_texture();
+}
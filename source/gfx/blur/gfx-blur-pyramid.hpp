@@ -0,0 +1,123 @@
+// Copyright (c) 2021 Michael Fabian Dirks <info@xaymar.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+#include "common.hpp"
+#include <mutex>
+#include "gfx-blur-base.hpp"
+#include "obs/gs/gs-effect.hpp"
+#include "obs/gs/gs-rendertarget-pool.hpp"
+#include "obs/gs/gs-rendertarget.hpp"
+#include "obs/gs/gs-texture.hpp"
+
+namespace streamfx::gfx {
+	namespace blur {
+		class pyramid_data {
+			streamfx::obs::gs::effect _effect;
+
+			public:
+			pyramid_data();
+			virtual ~pyramid_data();
+
+			streamfx::obs::gs::effect get_effect();
+		};
+
+		class pyramid_factory : public ::streamfx::gfx::blur::ifactory {
+			std::mutex                                         _data_lock;
+			std::weak_ptr<::streamfx::gfx::blur::pyramid_data> _data;
+
+			public:
+			pyramid_factory();
+			virtual ~pyramid_factory() override;
+
+			virtual bool is_type_supported(::streamfx::gfx::blur::type type) override;
+
+			virtual std::shared_ptr<::streamfx::gfx::blur::base> create(::streamfx::gfx::blur::type type) override;
+
+			virtual double_t get_min_size(::streamfx::gfx::blur::type type) override;
+
+			virtual double_t get_step_size(::streamfx::gfx::blur::type type) override;
+
+			virtual double_t get_max_size(::streamfx::gfx::blur::type type) override;
+
+			virtual double_t get_min_angle(::streamfx::gfx::blur::type type) override;
+
+			virtual double_t get_step_angle(::streamfx::gfx::blur::type type) override;
+
+			virtual double_t get_max_angle(::streamfx::gfx::blur::type type) override;
+
+			virtual bool is_step_scale_supported(::streamfx::gfx::blur::type type) override;
+
+			virtual double_t get_min_step_scale_x(::streamfx::gfx::blur::type type) override;
+
+			virtual double_t get_step_step_scale_x(::streamfx::gfx::blur::type type) override;
+
+			virtual double_t get_max_step_scale_x(::streamfx::gfx::blur::type type) override;
+
+			virtual double_t get_min_step_scale_y(::streamfx::gfx::blur::type type) override;
+
+			virtual double_t get_step_step_scale_y(::streamfx::gfx::blur::type type) override;
+
+			virtual double_t get_max_step_scale_y(::streamfx::gfx::blur::type type) override;
+
+			std::shared_ptr<::streamfx::gfx::blur::pyramid_data> data();
+
+			public: // Singleton
+			static ::streamfx::gfx::blur::pyramid_factory& get();
+		};
+
+		/** Gaussian blur on a downsampled pyramid, for radii far larger than what the other blurs can handle.
+		 *
+		 * The image is halved until the remaining radius is small, blurred at that level, and upsampled back with a
+		 * tent filter. Intermediate levels are leased from the render target pool for the duration of render().
+		 */
+		class pyramid : public ::streamfx::gfx::blur::base {
+			std::shared_ptr<::streamfx::gfx::blur::pyramid_data>  _data;
+			std::shared_ptr<streamfx::obs::gs::rendertarget_pool> _rt_pool;
+
+			double_t _size;
+
+			std::shared_ptr<streamfx::obs::gs::texture>      _input_texture;
+			std::shared_ptr<streamfx::obs::gs::rendertarget> _rendertarget;
+
+			streamfx::obs::gs::effect_bindings _parameters;
+
+			public:
+			pyramid();
+			virtual ~pyramid() override;
+
+			virtual void set_input(std::shared_ptr<::streamfx::obs::gs::texture> texture) override;
+
+			virtual ::streamfx::gfx::blur::type get_type() override;
+
+			virtual double_t get_size() override;
+
+			virtual void set_size(double_t width) override;
+
+			virtual void set_step_scale(double_t x, double_t y) override;
+
+			virtual void get_step_scale(double_t& x, double_t& y) override;
+
+			virtual std::shared_ptr<::streamfx::obs::gs::texture> render() override;
+
+			virtual std::shared_ptr<::streamfx::obs::gs::texture> get() override;
+		};
+	} // namespace blur
+} // namespace streamfx::gfx
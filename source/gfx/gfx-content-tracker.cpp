@@ -0,0 +1,222 @@
+// Copyright (c) 2021 Michael Fabian Dirks <info@xaymar.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "gfx-content-tracker.hpp"
+#include <stdexcept>
+#include "obs/gs/gs-helper.hpp"
+#include "plugin.hpp"
+#include "util/util-logging.hpp"
+
+#ifdef _DEBUG
+#define ST_PREFIX "<%s> "
+#define D_LOG_ERROR(x, ...) P_LOG_ERROR(ST_PREFIX##x, __FUNCTION_SIG__, __VA_ARGS__)
+#define D_LOG_WARNING(x, ...) P_LOG_WARN(ST_PREFIX##x, __FUNCTION_SIG__, __VA_ARGS__)
+#define D_LOG_INFO(x, ...) P_LOG_INFO(ST_PREFIX##x, __FUNCTION_SIG__, __VA_ARGS__)
+#define D_LOG_DEBUG(x, ...) P_LOG_DEBUG(ST_PREFIX##x, __FUNCTION_SIG__, __VA_ARGS__)
+#else
+#define ST_PREFIX "<gfx::content_tracker> "
+#define D_LOG_ERROR(...) P_LOG_ERROR(ST_PREFIX __VA_ARGS__)
+#define D_LOG_WARNING(...) P_LOG_WARN(ST_PREFIX __VA_ARGS__)
+#define D_LOG_INFO(...) P_LOG_INFO(ST_PREFIX __VA_ARGS__)
+#define D_LOG_DEBUG(...) P_LOG_DEBUG(ST_PREFIX __VA_ARGS__)
+#endif
+
+// Each pass reduces blocks of this many texels in both directions to a single texel, must match the effect.
+#define ST_BLOCK_SIZE 4
+
+// Passes continue until the fingerprint is at most this large in both directions.
+#define ST_MAX_FINGERPRINT_SIZE 8
+
+// Time in nanoseconds that content has to stay identical for before it counts as unchanged. Sources that repeat
+// frames do so for a fraction of this, so they never count as unchanged.
+#define ST_STATIC_DURATION 500000000ull
+
+namespace {
+	enum parameter : std::size_t {
+		P_IMAGE,
+		P_IMAGE_SIZE,
+		P_OUTPUT_SIZE,
+	};
+
+	// Frame times are exact multiples of the frame interval, so half an interval is plenty of tolerance.
+	bool is_consecutive(uint64_t previous, uint64_t current, uint64_t frame_interval)
+	{
+		return (frame_interval > 0) && (current > previous) && ((current - previous) <= (frame_interval * 3 / 2));
+	}
+} // namespace
+
+streamfx::gfx::content_tracker::~content_tracker()
+{
+	auto gctx = streamfx::obs::gs::context();
+	for (auto& item : _readbacks) {
+		if (item.surface) {
+			gs_stagesurface_destroy(item.surface);
+		}
+	}
+}
+
+streamfx::gfx::content_tracker::content_tracker()
+	: _rt_pool(streamfx::obs::gs::rendertarget_pool::get()), _effect(),
+	  _parameters({"image", "imageSize", "outputSize"}), _readbacks(), _index(0), _fingerprint(),
+	  _fingerprint_frame(0), _static_since(0), _unchanged(false)
+{
+	auto gctx = streamfx::obs::gs::context();
+	auto file = streamfx::data_file_path("effects/fingerprint.effect");
+	try {
+		_effect = streamfx::obs::gs::effect::create(file);
+	} catch (const std::exception& ex) {
+		D_LOG_ERROR("Error loading '%s': %s", file.generic_u8string().c_str(), ex.what());
+	}
+}
+
+bool streamfx::gfx::content_tracker::track(std::shared_ptr<streamfx::obs::gs::texture> texture)
+{
+	if (!_effect || !texture) {
+		reset();
+		return false;
+	}
+
+	uint64_t       frame          = obs_get_video_frame_time();
+	uint64_t       frame_interval = 0;
+	obs_video_info ovi;
+	if (obs_get_video_info(&ovi) && (ovi.fps_num > 0)) {
+		frame_interval = (1000000000ull * ovi.fps_den) / ovi.fps_num;
+	}
+
+	try {
+		// The fingerprint staged on the previous frame should be done by now, so reading it back won't stall.
+		if (auto& previous = _readbacks[(_index + 1) % _readbacks.size()]; previous.pending) {
+			compare(previous, frame_interval);
+			_unchanged = _unchanged && is_consecutive(previous.frame, frame, frame_interval);
+		} else {
+			_unchanged = false;
+		}
+
+		auto& current = _readbacks[_index];
+		stage(current, texture);
+		current.frame = frame;
+		_index        = (_index + 1) % _readbacks.size();
+	} catch (...) {
+		// Not being able to tell only means that nothing is reused.
+		reset();
+	}
+
+	return _unchanged;
+}
+
+void streamfx::gfx::content_tracker::reset()
+{
+	for (auto& item : _readbacks) {
+		item.pending = false;
+	}
+	_fingerprint.clear();
+	_unchanged = false;
+}
+
+void streamfx::gfx::content_tracker::compare(readback& item, uint64_t frame_interval)
+{
+	std::vector<float_t> fingerprint;
+	fingerprint.reserve(2 + (size_t(item.width) * item.height * 4));
+	fingerprint.push_back(float_t(item.width));
+	fingerprint.push_back(float_t(item.height));
+
+	uint8_t* data     = nullptr;
+	uint32_t linesize = 0;
+	item.pending      = false;
+	if (!gs_stagesurface_map(item.surface, &data, &linesize)) {
+		throw std::runtime_error("Failed to map staging surface.");
+	}
+	for (uint32_t y = 0; y < item.height; y++) {
+		auto row = reinterpret_cast<const float_t*>(data + (size_t(linesize) * y));
+		fingerprint.insert(fingerprint.end(), row, row + (size_t(item.width) * 4));
+	}
+	gs_stagesurface_unmap(item.surface);
+
+	bool identical = (fingerprint == _fingerprint) && is_consecutive(_fingerprint_frame, item.frame, frame_interval);
+	if (!identical) {
+		_static_since = item.frame;
+	}
+	_unchanged         = identical && ((item.frame - _static_since) >= ST_STATIC_DURATION);
+	_fingerprint       = std::move(fingerprint);
+	_fingerprint_frame = item.frame;
+}
+
+void streamfx::gfx::content_tracker::stage(readback& item, std::shared_ptr<streamfx::obs::gs::texture> texture)
+{
+	auto& parameters = _parameters.bind(_effect);
+
+	gs_blend_state_push();
+	gs_reset_blend_state();
+	gs_enable_blending(false);
+	gs_blend_function(GS_BLEND_ONE, GS_BLEND_ZERO);
+	gs_enable_color(true, true, true, true);
+	gs_enable_depth_test(false);
+	gs_enable_stencil_test(false);
+	gs_set_cull_mode(GS_NEITHER);
+
+	// Keep the lease on the last pass, as that is what gets staged.
+	std::shared_ptr<streamfx::obs::gs::rendertarget> rt;
+	const char*                                      technique = "Hash";
+	uint32_t                                         width     = texture->get_width();
+	uint32_t                                         height    = texture->get_height();
+	try {
+		do {
+			uint32_t output_width  = (width + ST_BLOCK_SIZE - 1) / ST_BLOCK_SIZE;
+			uint32_t output_height = (height + ST_BLOCK_SIZE - 1) / ST_BLOCK_SIZE;
+
+			auto next = _rt_pool->acquire(GS_RGBA32F, GS_ZS_NONE, output_width, output_height);
+			{
+				auto op = next->render(output_width, output_height);
+				gs_ortho(0, 1, 0, 1, -1, 1);
+
+				parameters[P_IMAGE].set_texture(texture);
+				parameters[P_IMAGE_SIZE].set_float2(float_t(width), float_t(height));
+				parameters[P_OUTPUT_SIZE].set_float2(float_t(output_width), float_t(output_height));
+				while (gs_effect_loop(_effect.get_object(), technique)) {
+					streamfx::gs_draw_fullscreen_tri();
+				}
+			}
+
+			rt        = next;
+			texture   = rt->get_texture();
+			width     = output_width;
+			height    = output_height;
+			technique = "Reduce";
+		} while ((width > ST_MAX_FINGERPRINT_SIZE) || (height > ST_MAX_FINGERPRINT_SIZE));
+	} catch (...) {
+		gs_blend_state_pop();
+		throw;
+	}
+	gs_blend_state_pop();
+
+	if (!item.surface || (item.width != width) || (item.height != height)) {
+		if (item.surface) {
+			gs_stagesurface_destroy(item.surface);
+		}
+		item.surface = gs_stagesurface_create(width, height, GS_RGBA32F);
+		item.width   = width;
+		item.height  = height;
+		if (!item.surface) {
+			throw std::runtime_error("Failed to create staging surface.");
+		}
+	}
+	gs_stage_texture(item.surface, texture->get_object());
+	item.pending = true;
+}
@@ -0,0 +1,81 @@
+// Copyright (c) 2021 Michael Fabian Dirks <info@xaymar.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+#include "common.hpp"
+#include <array>
+#include <memory>
+#include <vector>
+#include "obs/gs/gs-effect.hpp"
+#include "obs/gs/gs-rendertarget-pool.hpp"
+#include "obs/gs/gs-texture.hpp"
+
+namespace streamfx::gfx {
+	/** Detects whether the content of a texture stays the same from frame to frame.
+	 *
+	 * Each tracked texture is reduced on the GPU into a tiny fingerprint, which is read back on the next frame so that
+	 * the CPU never waits on the GPU. Because of that, a change is only noticed one frame after it happened.
+	 *
+	 * Content only counts as unchanged once it has been identical for a while, so that sources which merely repeat
+	 * frames (30 fps cameras or 24p media on a 60 fps canvas) are never reused from. Output reused based on this is
+	 * still one frame stale on the first change after content was static for that long, which is only visible for
+	 * content that changes less than a few times per second, like slideshows.
+	 */
+	class content_tracker {
+		struct readback {
+			gs_stagesurf_t* surface;
+			uint32_t        width;
+			uint32_t        height;
+			uint64_t        frame;
+			bool            pending;
+		};
+
+		std::shared_ptr<streamfx::obs::gs::rendertarget_pool> _rt_pool;
+		streamfx::obs::gs::effect                             _effect;
+		streamfx::obs::gs::effect_bindings                    _parameters;
+
+		std::array<readback, 2> _readbacks;
+		std::size_t             _index;
+
+		std::vector<float_t> _fingerprint;
+		uint64_t             _fingerprint_frame;
+		uint64_t             _static_since;
+		bool                 _unchanged;
+
+		public:
+		~content_tracker();
+		content_tracker();
+
+		/** Fingerprint the texture for the current frame, call this at most once per frame.
+		 *
+		 * @return true if the content has been identical in all consecutive frames for a while, in which case anything
+		 *         that was produced from it in those frames can be reused.
+		 */
+		bool track(std::shared_ptr<streamfx::obs::gs::texture> texture);
+
+		/** Forget everything seen so far, so that the next frames count as changed. */
+		void reset();
+
+		private:
+		void compare(readback& item, uint64_t frame_interval);
+
+		void stage(readback& item, std::shared_ptr<streamfx::obs::gs::texture> texture);
+	};
+} // namespace streamfx::gfx
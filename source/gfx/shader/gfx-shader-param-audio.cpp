@@ -0,0 +1,312 @@
+// Copyright (c) 2021 Michael Fabian Dirks <info@xaymar.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "gfx-shader-param-audio.hpp"
+#include <map>
+#include <stdexcept>
+#include "gfx-shader.hpp"
+#include "obs/obs-source-tracker.hpp"
+#include "plugin.hpp"
+
+// UI:
+// Name/Key = Source
+
+#define ST_FFT_SIZE 2048
+#define ST_RING_SIZE 8192 // Must be a power of two, and leave room for the audio thread to keep writing.
+#define ST_FREQUENCY_LOW 20.0
+#define ST_RESULT_FRESH 4 // Flags the middle result as not yet seen by the render thread.
+
+static constexpr std::string_view _annotation_audio_data  = "audio_data";
+static constexpr std::string_view _annotation_audio_bands = "audio_bands";
+
+streamfx::gfx::shader::audio_data_type streamfx::gfx::shader::get_audio_data_type_from_string(std::string v)
+{
+	std::map<std::string, audio_data_type> matches = {
+		{"spectrum", audio_data_type::Spectrum},
+		{"rms", audio_data_type::RMS},
+		{"peak", audio_data_type::Peak},
+	};
+
+	auto fnd = matches.find(v);
+	if (fnd != matches.end())
+		return fnd->second;
+
+	return audio_data_type::Spectrum;
+}
+
+streamfx::gfx::shader::audio_analyzer::audio_analyzer(std::size_t bands)
+	: _ring(ST_RING_SIZE), _ring_written(0), _fft(ST_FFT_SIZE), _samples(ST_FFT_SIZE), _magnitudes(ST_FFT_SIZE / 2),
+	  _band_ranges(bands), _busy(false), _results(), _result_back(0), _result_front(1), _result_middle(2)
+{
+	for (auto& result : _results) {
+		result.bands.assign(bands, 0.f);
+		result.rms  = 0.f;
+		result.peak = 0.f;
+	}
+
+	// Spread the bands logarithmically over the audible range, as that is how we hear them.
+	double rate = 48000.;
+	if (obs_audio_info oai; obs_get_audio_info(&oai)) {
+		rate = static_cast<double>(oai.samples_per_sec);
+	}
+	double      nyquist = rate / 2.;
+	double      low     = std::min(ST_FREQUENCY_LOW, nyquist / 2.);
+	double      bin_hz  = rate / static_cast<double>(ST_FFT_SIZE);
+	std::size_t half    = _magnitudes.size();
+	for (std::size_t idx = 0; idx < bands; idx++) {
+		double f0 = low * pow(nyquist / low, static_cast<double>(idx) / static_cast<double>(bands));
+		double f1 = low * pow(nyquist / low, static_cast<double>(idx + 1) / static_cast<double>(bands));
+
+		// Skip the DC offset, and make sure that every band covers at least one bin.
+		std::size_t k0    = std::clamp<std::size_t>(static_cast<std::size_t>(f0 / bin_hz), 1, half - 1);
+		std::size_t k1    = std::clamp<std::size_t>(static_cast<std::size_t>(ceil(f1 / bin_hz)), k0 + 1, half);
+		_band_ranges[idx] = {k0, k1};
+	}
+}
+
+void streamfx::gfx::shader::audio_analyzer::capture(void* ptr, obs_source_t*, const struct audio_data* audio,
+													 bool muted)
+{
+	auto self = reinterpret_cast<audio_analyzer*>(ptr);
+
+	std::size_t channels = 0;
+	while ((channels < MAX_AV_PLANES) && (audio->data[channels] != nullptr))
+		channels++;
+
+	// Mix down to mono, all that matters for analysis is what is audible.
+	uint64_t pos = self->_ring_written.load(std::memory_order_relaxed);
+	for (uint32_t idx = 0; idx < audio->frames; idx++) {
+		float v = 0.f;
+		if (!muted && (channels > 0)) {
+			for (std::size_t ch = 0; ch < channels; ch++) {
+				v += reinterpret_cast<const float*>(audio->data[ch])[idx];
+			}
+			v /= static_cast<float>(channels);
+		}
+		self->_ring[(pos + idx) & (ST_RING_SIZE - 1)].store(v, std::memory_order_relaxed);
+	}
+	self->_ring_written.store(pos + audio->frames, std::memory_order_release);
+}
+
+void streamfx::gfx::shader::audio_analyzer::schedule(std::shared_ptr<audio_analyzer> self)
+{
+	if (self->_busy.exchange(true))
+		return;
+
+	streamfx::threadpool()->push(&audio_analyzer::task_analyze, self, streamfx::util::threadpool_priority::HIGH);
+}
+
+const streamfx::gfx::shader::audio_result& streamfx::gfx::shader::audio_analyzer::fetch()
+{
+	if (_result_middle.load(std::memory_order_acquire) & ST_RESULT_FRESH) {
+		_result_front = _result_middle.exchange(_result_front, std::memory_order_acq_rel) & ~ST_RESULT_FRESH;
+	}
+	return _results[_result_front];
+}
+
+void streamfx::gfx::shader::audio_analyzer::task_analyze(streamfx::util::threadpool_data_t data)
+{
+	auto self = std::static_pointer_cast<audio_analyzer>(data);
+	self->analyze();
+	self->_busy = false;
+}
+
+void streamfx::gfx::shader::audio_analyzer::analyze()
+{
+	std::size_t size = _samples.size();
+
+	// Copy the newest samples, with silence in front of them if there aren't enough yet.
+	uint64_t end = _ring_written.load(std::memory_order_acquire);
+	for (std::size_t idx = 0; idx < size; idx++) {
+		if ((end + idx) < size) {
+			_samples[idx] = 0.f;
+		} else {
+			_samples[idx] = _ring[(end - size + idx) & (ST_RING_SIZE - 1)].load(std::memory_order_relaxed);
+		}
+	}
+
+	// The audio thread overwrote part of what was just copied, try again next time.
+	std::atomic_thread_fence(std::memory_order_acquire);
+	if ((_ring_written.load(std::memory_order_acquire) - end) > (ST_RING_SIZE - size))
+		return;
+
+	auto& result = _results[_result_back];
+
+	float sum  = 0.f;
+	float peak = 0.f;
+	for (float v : _samples) {
+		sum += v * v;
+		peak = std::max(peak, std::fabs(v));
+	}
+	result.rms  = std::sqrt(sum / static_cast<float>(size));
+	result.peak = peak;
+
+	_fft.transform(_samples.data(), _magnitudes.data());
+	for (std::size_t idx = 0; idx < _band_ranges.size(); idx++) {
+		float value = 0.f;
+		for (std::size_t bin = _band_ranges[idx].first; bin < _band_ranges[idx].second; bin++) {
+			value = std::max(value, _magnitudes[bin]);
+		}
+		result.bands[idx] = value;
+	}
+
+	_result_back =
+		_result_middle.exchange(_result_back | ST_RESULT_FRESH, std::memory_order_acq_rel) & ~ST_RESULT_FRESH;
+}
+
+streamfx::gfx::shader::audio_parameter::audio_parameter(streamfx::gfx::shader::shader*      parent,
+														streamfx::obs::gs::effect_parameter param, std::string prefix)
+	: parameter(parent, param, prefix), _data_type(audio_data_type::Spectrum), _bands(), _source_name(), _dirty(true),
+	  _dirty_ts(std::chrono::high_resolution_clock::now()), _source(), _analyzer(), _values(), _texture()
+{
+	if (auto anno = get_parameter().get_annotation(_annotation_audio_data); anno) {
+		_data_type = get_audio_data_type_from_string(anno.get_default_string());
+	}
+
+	// Textures default to a reasonable amount of bands, vectors and arrays to one per element.
+	bool is_texture = get_parameter().get_type() == streamfx::obs::gs::effect_parameter::type::Texture;
+	_bands          = is_texture ? 64 : get_size();
+	if (auto anno = get_parameter().get_annotation(_annotation_audio_bands); anno) {
+		if (int32_t v = anno.get_default_int(); v > 0)
+			_bands = static_cast<std::size_t>(v);
+	}
+	_bands = std::clamp<std::size_t>(_bands, 1, ST_FFT_SIZE / 2);
+
+	// Anything but a texture must be uploaded with exactly as many values as it has elements, so bands beyond those
+	// can't be shown, and elements beyond the bands stay zero.
+	if (is_texture) {
+		_values.resize(_bands, 0.f);
+	} else {
+		_values.resize(std::max<std::size_t>(get_size(), 1), 0.f);
+		_bands = std::min(_bands, _values.size());
+	}
+}
+
+streamfx::gfx::shader::audio_parameter::~audio_parameter()
+{
+	release();
+}
+
+void streamfx::gfx::shader::audio_parameter::defaults(obs_data_t* settings)
+{
+	obs_data_set_default_string(settings, get_key().data(), "");
+}
+
+void streamfx::gfx::shader::audio_parameter::properties(obs_properties_t* props, obs_data_t* settings)
+{
+	if (!is_visible())
+		return;
+
+	auto p = obs_properties_add_list(props, get_key().data(), has_name() ? get_name().data() : get_key().data(),
+									 OBS_COMBO_TYPE_LIST, OBS_COMBO_FORMAT_STRING);
+	if (has_description())
+		obs_property_set_long_description(p, get_description().data());
+
+	obs_property_list_add_string(p, "", "");
+	obs::source_tracker::get()->enumerate(
+		[&p](std::string name, obs_source_t*) {
+			obs_property_list_add_string(p, name.c_str(), name.c_str());
+			return false;
+		},
+		obs::source_tracker::filter_audio_sources);
+}
+
+void streamfx::gfx::shader::audio_parameter::update(obs_data_t* settings)
+{
+	// Value is assigned elsewhere.
+	if (is_automatic())
+		return;
+
+	if (std::string source_name = obs_data_get_string(settings, get_key().data()); _source_name != source_name) {
+		_source_name = source_name;
+		_dirty       = true;
+		_dirty_ts    = std::chrono::high_resolution_clock::now() - std::chrono::milliseconds(1);
+	}
+}
+
+void streamfx::gfx::shader::audio_parameter::assign()
+{
+	if (is_automatic())
+		return;
+
+	// If the data has been marked dirty, and the future timestamp minus the now is smaller than 0ms.
+	if (_dirty && ((_dirty_ts - std::chrono::high_resolution_clock::now()) < std::chrono::milliseconds(0))) {
+		try {
+			release();
+
+			if (!_source_name.empty()) {
+				auto source = std::shared_ptr<obs_source_t>(obs_get_source_by_name(_source_name.c_str()),
+															[](obs_source_t* v) { obs_source_release(v); });
+				if (!source) {
+					throw std::runtime_error("Specified Source does not exist.");
+				}
+
+				auto analyzer = std::make_shared<audio_analyzer>(_bands);
+				obs_source_add_audio_capture_callback(source.get(), &audio_analyzer::capture, analyzer.get());
+
+				_analyzer = analyzer;
+				_source   = source;
+			}
+
+			_dirty = false;
+		} catch (...) {
+			_dirty_ts = std::chrono::high_resolution_clock::now() + std::chrono::milliseconds(5000);
+		}
+	}
+
+	// Analyze the audio for the next frame, and use what was finished by now for this one.
+	const audio_result* result = nullptr;
+	if (_analyzer) {
+		audio_analyzer::schedule(_analyzer);
+		result = &_analyzer->fetch();
+	}
+
+	if (get_parameter().get_type() == streamfx::obs::gs::effect_parameter::type::Texture) {
+		if (!_texture) {
+			_texture = std::make_shared<streamfx::obs::gs::texture>(
+				static_cast<uint32_t>(_bands), 1u, GS_R32F, 1u, nullptr, streamfx::obs::gs::texture::flags::Dynamic);
+		}
+
+		const float* data = result ? result->bands.data() : _values.data();
+		gs_texture_set_image(_texture->get_object(), reinterpret_cast<const uint8_t*>(data),
+							 static_cast<uint32_t>(_bands * sizeof(float)), false);
+		get_parameter().set_texture(_texture, false);
+	} else {
+		if (!result) {
+			std::fill(_values.begin(), _values.end(), 0.f);
+		} else if (_data_type == audio_data_type::Spectrum) {
+			std::copy(result->bands.begin(), result->bands.end(), _values.begin());
+		} else {
+			float value = (_data_type == audio_data_type::RMS) ? result->rms : result->peak;
+			std::fill(_values.begin(), _values.end(), value);
+		}
+		get_parameter().set_value(_values.data(), _values.size());
+	}
+}
+
+void streamfx::gfx::shader::audio_parameter::release()
+{
+	// Once removed, the audio thread no longer uses the analyzer.
+	if (_source && _analyzer) {
+		obs_source_remove_audio_capture_callback(_source.get(), &audio_analyzer::capture, _analyzer.get());
+	}
+	_analyzer.reset();
+	_source.reset();
+}
@@ -0,0 +1,123 @@
+// Copyright (c) 2021 Michael Fabian Dirks <info@xaymar.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+#include "common.hpp"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <vector>
+#include "gfx-shader-param.hpp"
+#include "obs/gs/gs-texture.hpp"
+#include "util/util-fft.hpp"
+
+namespace streamfx::gfx {
+	namespace shader {
+		enum class audio_data_type {
+			Spectrum,
+			RMS,
+			Peak,
+		};
+
+		audio_data_type get_audio_data_type_from_string(std::string v);
+
+		struct audio_result {
+			std::vector<float> bands;
+			float              rms;
+			float              peak;
+		};
+
+		/** Spectrum, RMS and peak of the most recent audio of a source.
+		 *
+		 * The audio thread only appends to a ring buffer, the analysis runs on the thread pool, and the render thread
+		 * picks up the newest finished result. None of them ever wait on each other.
+		 */
+		class audio_analyzer {
+			// Ring buffer of mono samples, written by the audio thread only.
+			std::vector<std::atomic<float>> _ring;
+			std::atomic<uint64_t>           _ring_written;
+
+			// Analysis, used by the thread pool only.
+			streamfx::util::fft                              _fft;
+			std::vector<float>                               _samples;
+			std::vector<float>                               _magnitudes;
+			std::vector<std::pair<std::size_t, std::size_t>> _band_ranges;
+			std::atomic<bool>                                _busy;
+
+			// Triple buffered results, so that neither side has to wait for the other.
+			std::array<audio_result, 3> _results;
+			std::size_t                 _result_back;
+			std::size_t                 _result_front;
+			std::atomic<std::size_t>    _result_middle;
+
+			public:
+			audio_analyzer(std::size_t bands);
+
+			static void capture(void* ptr, obs_source_t* source, const struct audio_data* audio, bool muted);
+
+			/** Queue an analysis of the most recent audio, unless one is still running. */
+			static void schedule(std::shared_ptr<audio_analyzer> self);
+
+			/** Newest finished result. Must only be called from the render thread. */
+			const audio_result& fetch();
+
+			private:
+			static void task_analyze(streamfx::util::threadpool_data_t data);
+
+			void analyze();
+		};
+
+		/** Parameter with `type = "audio"`, fed from an audio source selected by the user.
+		 *
+		 * Textures receive `audio_bands` spectrum bands as a single row of floats. Floats, vectors and arrays receive
+		 * either the spectrum or, depending on `audio_data`, the RMS or peak level in every element.
+		 */
+		struct audio_parameter : public parameter {
+			// Descriptor
+			audio_data_type _data_type;
+			std::size_t     _bands;
+
+			// Data
+			std::string                                    _source_name;
+			bool                                           _dirty;
+			std::chrono::high_resolution_clock::time_point _dirty_ts;
+			std::shared_ptr<obs_source_t>                  _source;
+			std::shared_ptr<audio_analyzer>                _analyzer;
+			std::vector<float>                             _values;
+			std::shared_ptr<streamfx::obs::gs::texture>    _texture;
+
+			public:
+			audio_parameter(streamfx::gfx::shader::shader* parent, streamfx::obs::gs::effect_parameter param,
+							std::string prefix);
+			virtual ~audio_parameter();
+
+			void defaults(obs_data_t* settings) override;
+
+			void properties(obs_properties_t* props, obs_data_t* settings) override;
+
+			void update(obs_data_t* settings) override;
+
+			void assign() override;
+
+			private:
+			void release();
+		};
+	} // namespace shader
+} // namespace streamfx::gfx
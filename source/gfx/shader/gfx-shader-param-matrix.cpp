@@ -0,0 +1,237 @@
+// Copyright (c) 2021 Michael Fabian Dirks <info@xaymar.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "gfx-shader-param-matrix.hpp"
+#include "strings.hpp"
+#include <cstdio>
+#include "gfx-shader.hpp"
+
+// UI:
+// Name/Key {
+//   Position X/Y/Z, Rotation X/Y/Z, Scale X/Y/Z
+//   Animation = None/Linear/...
+//   Duration, Reverse at End
+//   End Position X/Y/Z, End Rotation X/Y/Z, End Scale X/Y/Z
+// }
+
+#define ST_I18N "Shader.Parameter.Matrix"
+#define ST_I18N_POSITION ST_I18N ".Position"
+#define ST_I18N_ROTATION ST_I18N ".Rotation"
+#define ST_I18N_SCALE ST_I18N ".Scale"
+#define ST_KEY_ANIMATION ".Animation"
+#define ST_I18N_ANIMATION ST_I18N ".Animation"
+#define ST_I18N_ANIMATION_NONE ST_I18N_ANIMATION ".None"
+#define ST_I18N_ANIMATION_LINEAR ST_I18N_ANIMATION ".Linear"
+#define ST_I18N_ANIMATION_EASEIN ST_I18N_ANIMATION ".EaseIn"
+#define ST_I18N_ANIMATION_EASEOUT ST_I18N_ANIMATION ".EaseOut"
+#define ST_I18N_ANIMATION_EASEINOUT ST_I18N_ANIMATION ".EaseInOut"
+#define ST_KEY_DURATION ".Duration"
+#define ST_I18N_DURATION ST_I18N ".Duration"
+#define ST_KEY_PINGPONG ".PingPong"
+#define ST_I18N_PINGPONG ST_I18N ".PingPong"
+#define ST_KEY_END ".End"
+#define ST_I18N_END ST_I18N ".End"
+
+// Layout of _keys: start transform, animation, duration, ping-pong, end transform.
+#define ST_KEY_IDX_START 0
+#define ST_KEY_IDX_ANIMATION 9
+#define ST_KEY_IDX_DURATION 10
+#define ST_KEY_IDX_PINGPONG 11
+#define ST_KEY_IDX_END 12
+
+static constexpr std::string_view _transform_keys[] = {
+	".Position.X", ".Position.Y", ".Position.Z", ".Rotation.X", ".Rotation.Y",
+	".Rotation.Z", ".Scale.X",    ".Scale.Y",    ".Scale.Z",
+};
+static constexpr const char* _transform_i18n[] = {
+	ST_I18N_POSITION, ST_I18N_POSITION, ST_I18N_POSITION, ST_I18N_ROTATION, ST_I18N_ROTATION,
+	ST_I18N_ROTATION, ST_I18N_SCALE,    ST_I18N_SCALE,    ST_I18N_SCALE,
+};
+static constexpr const char* _transform_axis[] = {"X", "Y", "Z", "X", "Y", "Z", "X", "Y", "Z"};
+
+static void build_matrix(matrix4& matrix, const streamfx::gfx::shader::matrix_transform_t& transform)
+{
+	matrix4_identity(&matrix);
+	matrix4_scale3f(&matrix, &matrix, transform[6], transform[7], transform[8]);
+	matrix4_rotate_aa4f(&matrix, &matrix, 1, 0, 0, static_cast<float_t>(D_DEG_TO_RAD(transform[3])));
+	matrix4_rotate_aa4f(&matrix, &matrix, 0, 1, 0, static_cast<float_t>(D_DEG_TO_RAD(transform[4])));
+	matrix4_rotate_aa4f(&matrix, &matrix, 0, 0, 1, static_cast<float_t>(D_DEG_TO_RAD(transform[5])));
+	matrix4_translate3f(&matrix, &matrix, transform[0], transform[1], transform[2]);
+}
+
+static float_t apply_curve(streamfx::gfx::shader::matrix_animation animation, float_t v)
+{
+	switch (animation) {
+	case streamfx::gfx::shader::matrix_animation::EaseIn:
+		return v * v;
+	case streamfx::gfx::shader::matrix_animation::EaseOut:
+		return 1.f - (1.f - v) * (1.f - v);
+	case streamfx::gfx::shader::matrix_animation::EaseInOut:
+		return v * v * (3.f - 2.f * v);
+	default:
+		return v;
+	}
+}
+
+streamfx::gfx::shader::matrix_parameter::matrix_parameter(streamfx::gfx::shader::shader*      parent,
+														  streamfx::obs::gs::effect_parameter param,
+														  std::string                         prefix)
+	: parameter(parent, param, prefix), _keys(), _start(), _end(), _animation(matrix_animation::None), _duration(1.f),
+	  _ping_pong(false), _progress(-1.f)
+{
+	_keys.reserve(ST_KEY_IDX_END + 9);
+	for (auto key : _transform_keys) {
+		_keys.push_back(std::string(get_key()) + std::string(key));
+	}
+	_keys.push_back(std::string(get_key()) + ST_KEY_ANIMATION);
+	_keys.push_back(std::string(get_key()) + ST_KEY_DURATION);
+	_keys.push_back(std::string(get_key()) + ST_KEY_PINGPONG);
+	for (auto key : _transform_keys) {
+		_keys.push_back(std::string(get_key()) + ST_KEY_END + std::string(key));
+	}
+
+	_start = {0, 0, 0, 0, 0, 0, 1, 1, 1};
+	_end   = _start;
+	build_matrix(_matrix, _start);
+}
+
+streamfx::gfx::shader::matrix_parameter::~matrix_parameter() {}
+
+void streamfx::gfx::shader::matrix_parameter::defaults(obs_data_t* settings)
+{
+	for (std::size_t idx = 0; idx < 9; idx++) {
+		double_t v = (idx >= 6) ? 1. : 0.;
+		obs_data_set_default_double(settings, _keys[ST_KEY_IDX_START + idx].c_str(), v);
+		obs_data_set_default_double(settings, _keys[ST_KEY_IDX_END + idx].c_str(), v);
+	}
+	obs_data_set_default_int(settings, _keys[ST_KEY_IDX_ANIMATION].c_str(),
+							 static_cast<long long>(matrix_animation::None));
+	obs_data_set_default_double(settings, _keys[ST_KEY_IDX_DURATION].c_str(), 1.);
+	obs_data_set_default_bool(settings, _keys[ST_KEY_IDX_PINGPONG].c_str(), false);
+}
+
+bool streamfx::gfx::shader::matrix_parameter::modified_animation(void* priv, obs_properties_t* props, obs_property_t*,
+																 obs_data_t* settings)
+{
+	auto self = reinterpret_cast<streamfx::gfx::shader::matrix_parameter*>(priv);
+
+	bool animated = static_cast<matrix_animation>(obs_data_get_int(settings, self->_keys[ST_KEY_IDX_ANIMATION].c_str()))
+					!= matrix_animation::None;
+	for (std::size_t idx = ST_KEY_IDX_DURATION; idx < self->_keys.size(); idx++) {
+		obs_property_set_visible(obs_properties_get(props, self->_keys[idx].c_str()), animated);
+	}
+	return true;
+}
+
+void streamfx::gfx::shader::matrix_parameter::properties(obs_properties_t* props, obs_data_t* settings)
+{
+	if (!is_visible())
+		return;
+
+	obs_properties_t* pr = obs_properties_create();
+	{
+		auto p = obs_properties_add_group(props, get_key().data(), has_name() ? get_name().data() : get_key().data(),
+										  OBS_GROUP_NORMAL, pr);
+		if (has_description())
+			obs_property_set_long_description(p, get_description().data());
+	}
+
+	char name[256];
+	for (std::size_t idx = 0; idx < 9; idx++) {
+		snprintf(name, sizeof(name), "%s %s", D_TRANSLATE(_transform_i18n[idx]), _transform_axis[idx]);
+		obs_properties_add_float(pr, _keys[ST_KEY_IDX_START + idx].c_str(), name, -100000., 100000., 0.01);
+	}
+
+	{
+		auto p = obs_properties_add_list(pr, _keys[ST_KEY_IDX_ANIMATION].c_str(), D_TRANSLATE(ST_I18N_ANIMATION),
+										 OBS_COMBO_TYPE_LIST, OBS_COMBO_FORMAT_INT);
+		obs_property_set_modified_callback2(p, modified_animation, this);
+		obs_property_list_add_int(p, D_TRANSLATE(ST_I18N_ANIMATION_NONE), static_cast<int64_t>(matrix_animation::None));
+		obs_property_list_add_int(p, D_TRANSLATE(ST_I18N_ANIMATION_LINEAR),
+								  static_cast<int64_t>(matrix_animation::Linear));
+		obs_property_list_add_int(p, D_TRANSLATE(ST_I18N_ANIMATION_EASEIN),
+								  static_cast<int64_t>(matrix_animation::EaseIn));
+		obs_property_list_add_int(p, D_TRANSLATE(ST_I18N_ANIMATION_EASEOUT),
+								  static_cast<int64_t>(matrix_animation::EaseOut));
+		obs_property_list_add_int(p, D_TRANSLATE(ST_I18N_ANIMATION_EASEINOUT),
+								  static_cast<int64_t>(matrix_animation::EaseInOut));
+	}
+	{
+		auto p = obs_properties_add_float_slider(pr, _keys[ST_KEY_IDX_DURATION].c_str(), D_TRANSLATE(ST_I18N_DURATION),
+												 0.01, 3600., 0.01);
+		obs_property_float_set_suffix(p, " s");
+	}
+	obs_properties_add_bool(pr, _keys[ST_KEY_IDX_PINGPONG].c_str(), D_TRANSLATE(ST_I18N_PINGPONG));
+
+	for (std::size_t idx = 0; idx < 9; idx++) {
+		snprintf(name, sizeof(name), "%s %s %s", D_TRANSLATE(ST_I18N_END), D_TRANSLATE(_transform_i18n[idx]),
+				 _transform_axis[idx]);
+		obs_properties_add_float(pr, _keys[ST_KEY_IDX_END + idx].c_str(), name, -100000., 100000., 0.01);
+	}
+
+	modified_animation(this, pr, nullptr, settings);
+}
+
+void streamfx::gfx::shader::matrix_parameter::update(obs_data_t* settings)
+{
+	// Value is assigned elsewhere.
+	if (is_automatic())
+		return;
+
+	for (std::size_t idx = 0; idx < 9; idx++) {
+		_start[idx] = static_cast<float_t>(obs_data_get_double(settings, _keys[ST_KEY_IDX_START + idx].c_str()));
+		_end[idx]   = static_cast<float_t>(obs_data_get_double(settings, _keys[ST_KEY_IDX_END + idx].c_str()));
+	}
+	_animation = static_cast<matrix_animation>(obs_data_get_int(settings, _keys[ST_KEY_IDX_ANIMATION].c_str()));
+	_duration  = static_cast<float_t>(obs_data_get_double(settings, _keys[ST_KEY_IDX_DURATION].c_str()));
+	_duration  = std::max(_duration, 0.01f);
+	_ping_pong = obs_data_get_bool(settings, _keys[ST_KEY_IDX_PINGPONG].c_str());
+
+	// Build the matrix now, so that rendering only has to upload it. Animations rebuild it on their next frame.
+	_progress = -1.f;
+	build_matrix(_matrix, _start);
+}
+
+void streamfx::gfx::shader::matrix_parameter::assign()
+{
+	if (is_automatic())
+		return;
+
+	if (_animation != matrix_animation::None) {
+		float_t cycles   = get_parent()->get_time() / _duration;
+		float_t progress = cycles - std::floor(cycles);
+		if (_ping_pong && ((static_cast<int64_t>(std::floor(cycles)) % 2) == 1)) {
+			progress = 1.f - progress;
+		}
+		progress = apply_curve(_animation, progress);
+
+		if (progress != _progress) {
+			_progress = progress;
+
+			matrix_transform_t transform;
+			for (std::size_t idx = 0; idx < transform.size(); idx++) {
+				transform[idx] = _start[idx] + (_end[idx] - _start[idx]) * progress;
+			}
+			build_matrix(_matrix, transform);
+		}
+	}
+
+	get_parameter().set_matrix(_matrix);
+}
@@ -0,0 +1,75 @@
+// Copyright (c) 2021 Michael Fabian Dirks <info@xaymar.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+#include "common.hpp"
+#include <array>
+#include <vector>
+#include "gfx-shader-param.hpp"
+
+namespace streamfx::gfx {
+	namespace shader {
+		enum class matrix_animation {
+			None,
+			Linear,
+			EaseIn,
+			EaseOut,
+			EaseInOut,
+		};
+
+		// Position, rotation (in degrees) and scale, three values each.
+		typedef std::array<float_t, 9> matrix_transform_t;
+
+		/** Parameter for float4x4 uniforms with `type = "matrix"`, edited as position, rotation and scale.
+		 *
+		 * The matrix is only rebuilt when the settings change, or when an animation between a start and an end
+		 * transform has progressed since the last frame.
+		 */
+		struct matrix_parameter : public parameter {
+			std::vector<std::string> _keys;
+
+			// Data
+			matrix_transform_t _start;
+			matrix_transform_t _end;
+			matrix_animation   _animation;
+			float_t            _duration;
+			bool               _ping_pong;
+
+			// Cache
+			float_t _progress;
+			matrix4 _matrix;
+
+			public:
+			matrix_parameter(streamfx::gfx::shader::shader* parent, streamfx::obs::gs::effect_parameter param,
+							 std::string prefix);
+			virtual ~matrix_parameter();
+
+			void defaults(obs_data_t* settings) override;
+
+			static bool modified_animation(void*, obs_properties_t*, obs_property_t*, obs_data_t*);
+
+			void properties(obs_properties_t* props, obs_data_t* settings) override;
+
+			void update(obs_data_t* settings) override;
+
+			void assign() override;
+		};
+	} // namespace shader
+} // namespace streamfx::gfx
@@ -338,12 +338,10 @@ void streamfx::gfx::shader::texture_parameter::assign()
 
 	// If this is a source and active or visible, capture it.
 	if ((_type == texture_type::Source) && (_active || _visible) && _source_rendertarget) {
-#ifdef ENABLE_PROFILING
 		::streamfx::obs::gs::debug_marker profiler1{::streamfx::obs::gs::debug_color_capture, "Parameter '%s'",
 													get_key().data()};
 		::streamfx::obs::gs::debug_marker profiler2{::streamfx::obs::gs::debug_color_capture, "Capture '%s'",
 													obs_source_get_name(_source.get())};
-#endif
 		uint32_t width  = obs_source_get_width(_source.get());
 		uint32_t height = obs_source_get_height(_source.get());
 
@@ -18,7 +18,9 @@
 #include "gfx-shader-param.hpp"
 #include <algorithm>
 #include <sstream>
+#include "gfx-shader-param-audio.hpp"
 #include "gfx-shader-param-basic.hpp"
+#include "gfx-shader-param-matrix.hpp"
 #include "gfx-shader-param-texture.hpp"
 
 #define ST_ANNO_ORDER "order"
@@ -46,7 +48,7 @@ streamfx::gfx::shader::parameter_type
 	case eptype::Float2:
 	case eptype::Float3:
 	case eptype::Float4:
-	case eptype::Matrix:
+	case eptype::Matrix: // The matrix UI is opt-in with 'type = "matrix"', so existing scenes keep their values.
 		return parameter_type::Float;
 	case eptype::String:
 		return parameter_type::String;
@@ -104,6 +106,12 @@ streamfx::gfx::shader::parameter_type streamfx::gfx::shader::get_type_from_strin
 	if ((v == "sampler")) {
 		return parameter_type::Sampler;
 	}
+	if ((v == "audio")) {
+		return parameter_type::Audio;
+	}
+	if ((v == "matrix")) {
+		return parameter_type::Matrix;
+	}
 	/* To decide on in the future:
 	 * - Double support?
 	 * - Half Support?
@@ -194,7 +202,7 @@ std::shared_ptr<streamfx::gfx::shader::parameter>
 	parameter_type real_type = get_type_from_effect_type(param.get_type());
 	if (auto anno = param.get_annotation(ST_ANNO_TYPE); anno) {
 		// We have a type override.
-		real_type = get_type_from_string(param.get_default_string());
+		real_type = get_type_from_string(anno.get_default_string());
 	}
 
 	switch (real_type) {
@@ -206,6 +214,12 @@ std::shared_ptr<streamfx::gfx::shader::parameter>
 		return std::make_shared<streamfx::gfx::shader::float_parameter>(parent, param, prefix);
 	case parameter_type::Texture:
 		return std::make_shared<streamfx::gfx::shader::texture_parameter>(parent, param, prefix);
+	case parameter_type::Audio:
+		return std::make_shared<streamfx::gfx::shader::audio_parameter>(parent, param, prefix);
+	case parameter_type::Matrix:
+		if (param.get_type() != eptype::Matrix)
+			return nullptr;
+		return std::make_shared<streamfx::gfx::shader::matrix_parameter>(parent, param, prefix);
 	default:
 		return nullptr;
 	}
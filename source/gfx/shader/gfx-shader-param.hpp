@@ -38,7 +38,11 @@ namespace streamfx::gfx {
 			// Texture with dimensions stored in size (1 = Texture1D, 2 = Texture2D, 3 = Texture3D, 6 = TextureCube).
 			Texture,
 			// Sampler for Textures.
-			Sampler
+			Sampler,
+			// Spectrum, RMS or peak of an audio source, as floats or a texture.
+			Audio,
+			// 4x4 Matrix, edited as position, rotation and scale.
+			Matrix
 		};
 
 		parameter_type get_type_from_effect_type(streamfx::obs::gs::effect_parameter::type type);
@@ -46,13 +46,14 @@
 streamfx::gfx::shader::shader::shader(obs_source_t* self, shader_mode mode)
 	: _self(self), _mode(mode), _base_width(1), _base_height(1), _active(true),
 
-	  _shader(), _shader_file(), _shader_tech("Draw"), _shader_file_mt(), _shader_file_sz(), _shader_file_tick(0),
+	  _shader(), _shader_file(), _shader_tech("Draw"), _shader_file_mt(), _shader_file_sz(), _shader_file_watch(),
+	  _shader_job(),
 
 	  _width_type(size_type::Percent), _width_value(1.0), _height_type(size_type::Percent), _height_value(1.0),
 
 	  _have_current_params(false), _time(0), _time_loop(0), _loops(0), _random(), _random_seed(0),
 
-	  _rt_up_to_date(false), _rt(std::make_shared<streamfx::obs::gs::rendertarget>(GS_RGBA_UNORM, GS_ZS_NONE))
+	  _rt_up_to_date(false), _rt_pool(streamfx::obs::gs::rendertarget_pool::get()), _rt()
 {
 	// Initialize random values.
 	_random.seed(static_cast<unsigned long long>(_random_seed));
@@ -108,66 +109,18 @@ try {
 
 	// Update Shader
 	if (shader_dirty) {
-		_shader           = streamfx::obs::gs::effect(file);
-		_shader_file_mt   = std::filesystem::last_write_time(file);
-		_shader_file_sz   = std::filesystem::file_size(file);
-		_shader_file      = file;
-		_shader_file_tick = 0;
+		_shader         = streamfx::obs::gs::effect(file, false);
+		_shader_file_mt = std::filesystem::last_write_time(file);
+		_shader_file_sz = std::filesystem::file_size(file);
+		if (!_shader_file_watch || (file != _shader_file)) {
+			_shader_file_watch = streamfx::util::file_watcher::get()->subscribe(file);
+		}
+		_shader_file = file;
 	}
 
 	// Update Params
 	if (param_dirty) {
-		auto settings =
-			std::shared_ptr<obs_data_t>(obs_source_get_settings(_self), [](obs_data_t* p) { obs_data_release(p); });
-
-		bool have_valid_tech = false;
-		for (std::size_t idx = 0; idx < _shader.count_techniques(); idx++) {
-			if (_shader.get_technique(idx).name() == tech) {
-				have_valid_tech = true;
-				break;
-			}
-		}
-		if (have_valid_tech) {
-			_shader_tech = tech;
-		} else {
-			_shader_tech = _shader.get_technique(0).name();
-
-			// Update source data.
-			obs_data_set_string(settings.get(), ST_KEY_SHADER_TECHNIQUE, _shader_tech.c_str());
-		}
-
-		// Clear the shader parameters map and rebuild.
-		_shader_params.clear();
-		auto etech = _shader.get_technique(_shader_tech);
-		for (std::size_t idx = 0; idx < etech.count_passes(); idx++) {
-			auto pass         = etech.get_pass(idx);
-			auto fetch_params = [&](std::size_t                                                     count,
-									std::function<streamfx::obs::gs::effect_parameter(std::size_t)> get_func) {
-				for (std::size_t vidx = 0; vidx < count; vidx++) {
-					auto el = get_func(vidx);
-					if (!el)
-						continue;
-
-					auto el_name = el.get_name();
-					auto fnd     = _shader_params.find(el_name);
-					if (fnd != _shader_params.end())
-						continue;
-
-					auto param = streamfx::gfx::shader::parameter::make_parameter(this, el, ST_KEY_PARAMETERS);
-
-					if (param) {
-						_shader_params.insert_or_assign(el_name, param);
-						param->defaults(settings.get());
-						param->update(settings.get());
-					}
-				}
-			};
-
-			auto gvp = [&](std::size_t idx) { return pass.get_vertex_parameter(idx); };
-			fetch_params(pass.count_vertex_parameters(), gvp);
-			auto gpp = [&](std::size_t idx) { return pass.get_pixel_parameter(idx); };
-			fetch_params(pass.count_pixel_parameters(), gpp);
-		}
+		update_parameters(tech);
 	}
 
 	return true;
@@ -178,6 +131,107 @@ try {
 	return false;
 }
 
+void streamfx::gfx::shader::shader::update_parameters(const std::string& tech)
+{
+	auto settings =
+		std::shared_ptr<obs_data_t>(obs_source_get_settings(_self), [](obs_data_t* p) { obs_data_release(p); });
+
+	bool have_valid_tech = false;
+	for (std::size_t idx = 0; idx < _shader.count_techniques(); idx++) {
+		if (_shader.get_technique(idx).name() == tech) {
+			have_valid_tech = true;
+			break;
+		}
+	}
+	if (have_valid_tech) {
+		_shader_tech = tech;
+	} else {
+		_shader_tech = _shader.get_technique(0).name();
+
+		// Update source data.
+		obs_data_set_string(settings.get(), ST_KEY_SHADER_TECHNIQUE, _shader_tech.c_str());
+	}
+
+	// Clear the shader parameters map and rebuild.
+	_shader_params.clear();
+	auto etech = _shader.get_technique(_shader_tech);
+	for (std::size_t idx = 0; idx < etech.count_passes(); idx++) {
+		auto pass         = etech.get_pass(idx);
+		auto fetch_params = [&](std::size_t                                                     count,
+								std::function<streamfx::obs::gs::effect_parameter(std::size_t)> get_func) {
+			for (std::size_t vidx = 0; vidx < count; vidx++) {
+				auto el = get_func(vidx);
+				if (!el)
+					continue;
+
+				auto el_name = el.get_name();
+				auto fnd     = _shader_params.find(el_name);
+				if (fnd != _shader_params.end())
+					continue;
+
+				auto param = streamfx::gfx::shader::parameter::make_parameter(this, el, ST_KEY_PARAMETERS);
+
+				if (param) {
+					_shader_params.insert_or_assign(el_name, param);
+					param->defaults(settings.get());
+					param->update(settings.get());
+				}
+			}
+		};
+
+		auto gvp = [&](std::size_t idx) { return pass.get_vertex_parameter(idx); };
+		fetch_params(pass.count_vertex_parameters(), gvp);
+		auto gpp = [&](std::size_t idx) { return pass.get_pixel_parameter(idx); };
+		fetch_params(pass.count_pixel_parameters(), gpp);
+	}
+}
+
+void streamfx::gfx::shader::shader::task_compile(streamfx::util::threadpool_data_t data)
+{
+	auto job = std::static_pointer_cast<compile_job>(data);
+
+	try {
+		job->file_mt = std::filesystem::last_write_time(job->file);
+		job->file_sz = std::filesystem::file_size(job->file);
+
+		// Never take the graphics context here, a worker would otherwise sit idle for as long as a frame renders.
+		job->code = streamfx::obs::gs::effect::load_code(job->file, job->device_type);
+	} catch (const std::exception& ex) {
+		job->error = ex.what();
+	} catch (...) {
+		job->error = "Unknown error.";
+	}
+
+	job->done = true;
+}
+
+void streamfx::gfx::shader::shader::finish_compile()
+{
+	auto job = _shader_job;
+	_shader_job.reset();
+
+	// A different file was loaded in the meantime, so this result is no longer wanted.
+	if (job->file != _shader_file)
+		return;
+
+	_shader_file_mt = job->file_mt;
+	_shader_file_sz = job->file_sz;
+
+	if (!job->error.empty()) {
+		DLOG_ERROR("Loading shader '%s' failed with error: %s", job->file.c_str(), job->error.c_str());
+		return;
+	}
+
+	// libobs parses and compiles in one call that needs the graphics context, so this still blocks rendering.
+	try {
+		auto gctx = streamfx::obs::gs::context();
+		_shader   = streamfx::obs::gs::effect(job->code, job->file.u8string());
+		update_parameters(_shader_tech);
+	} catch (const std::exception& ex) {
+		DLOG_ERROR("Loading shader '%s' failed with error: %s", job->file.c_str(), ex.what());
+	}
+}
+
 void streamfx::gfx::shader::shader::defaults(obs_data_t* data)
 {
 	obs_data_set_default_string(data, ST_KEY_SHADER_FILE, "");
@@ -420,11 +474,19 @@ uint32_t streamfx::gfx::shader::shader::base_height()
 
 bool streamfx::gfx::shader::shader::tick(float_t time)
 {
-	_shader_file_tick = static_cast<float_t>(static_cast<double_t>(_shader_file_tick) + static_cast<double_t>(time));
-	if (_shader_file_tick >= 1.0f / 3.0f) {
-		_shader_file_tick -= 1.0f / 3.0f;
-		bool v1, v2;
-		load_shader(_shader_file, _shader_tech, v1, v2);
+	// Only touch the file system once the watcher has seen the file change. Reading and pre-processing the new shader
+	// happen in the background, but compiling it still blocks rendering. The current shader is kept if it fails.
+	if (_shader_file_watch && _shader_file_watch->changed()) {
+		_shader_job       = std::make_shared<compile_job>();
+		_shader_job->file = _shader_file;
+		{
+			auto gctx                = streamfx::obs::gs::context();
+			_shader_job->device_type = gs_get_device_type();
+		}
+		streamfx::threadpool()->push(&shader::task_compile, _shader_job, streamfx::util::threadpool_priority::LOW);
+	}
+	if (_shader_job && _shader_job->done) {
+		finish_compile();
 	}
 
 	// Update State
@@ -445,8 +507,9 @@ bool streamfx::gfx::shader::shader::tick(float_t time)
 			static_cast<float_t>(static_cast<double_t>(_random()) / static_cast<double_t>(_random.max()));
 	}
 
-	// Flag Render Target as outdated.
+	// Flag Render Target as outdated, and return it to the pool until it is rendered again.
 	_rt_up_to_date = false;
+	_rt.reset();
 
 	return false;
 }
@@ -504,10 +567,9 @@ void streamfx::gfx::shader::shader::render(gs_effect* effect)
 		effect = obs_get_base_effect(OBS_EFFECT_DEFAULT);
 
 	if (!_rt_up_to_date) {
-#ifdef ENABLE_PROFILING
 		::streamfx::obs::gs::debug_marker profiler1{::streamfx::obs::gs::debug_color_cache, "Render Cache"};
-#endif
 
+		_rt     = _rt_pool->acquire(GS_RGBA_UNORM, GS_ZS_NONE, width(), height());
 		auto op = _rt->render(width(), height());
 
 		vec4 zero = {0, 0, 0, 0};
@@ -539,10 +601,8 @@ void streamfx::gfx::shader::shader::render(gs_effect* effect)
 		_rt_up_to_date = true;
 	}
 
-	if (auto tex = _rt->get_texture(); tex) {
-#ifdef ENABLE_PROFILING
+	if (auto tex = _rt ? _rt->get_texture() : nullptr; tex) {
 		::streamfx::obs::gs::debug_marker profiler1{::streamfx::obs::gs::debug_color_render, "Draw Cache"};
-#endif
 
 		gs_effect_set_texture(gs_effect_get_param_by_name(effect, "image"), tex->get_object());
 		while (gs_effect_loop(effect, "Draw")) {
@@ -653,3 +713,8 @@ std::filesystem::path streamfx::gfx::shader::shader::get_shader_file()
 {
 	return _shader_file;
 }
+
+float_t streamfx::gfx::shader::shader::get_time()
+{
+	return _time;
+}
@@ -17,13 +17,16 @@
 
 #pragma once
 #include "common.hpp"
+#include <atomic>
 #include <filesystem>
 #include <list>
 #include <map>
 #include <random>
 #include "gfx/shader/gfx-shader-param.hpp"
 #include "obs/gs/gs-effect.hpp"
+#include "obs/gs/gs-rendertarget-pool.hpp"
 #include "obs/gs/gs-rendertarget.hpp"
+#include "util/util-file-watcher.hpp"
 
 namespace streamfx::gfx {
 	namespace shader {
@@ -41,6 +44,17 @@ namespace streamfx::gfx {
 		typedef std::map<std::string_view, std::shared_ptr<parameter>> shader_param_map_t;
 
 		class shader {
+			// Changed shader file, read and pre-processed on the thread pool and compiled by tick().
+			struct compile_job {
+				std::filesystem::path           file;
+				int                             device_type = 0;
+				std::filesystem::file_time_type file_mt;
+				uintmax_t                       file_sz = 0;
+				std::string                     code;
+				std::string                     error;
+				std::atomic<bool>               done{false};
+			};
+
 			obs_source_t* _self;
 
 			// Inputs
@@ -51,13 +65,14 @@ namespace streamfx::gfx {
 			bool        _visible;
 
 			// Shader
-			streamfx::obs::gs::effect       _shader;
-			std::filesystem::path           _shader_file;
-			std::string                     _shader_tech;
-			std::filesystem::file_time_type _shader_file_mt;
-			uintmax_t                       _shader_file_sz;
-			float_t                         _shader_file_tick;
-			shader_param_map_t              _shader_params;
+			streamfx::obs::gs::effect                                   _shader;
+			std::filesystem::path                                       _shader_file;
+			std::string                                                 _shader_tech;
+			std::filesystem::file_time_type                             _shader_file_mt;
+			uintmax_t                                                   _shader_file_sz;
+			std::shared_ptr<streamfx::util::file_watcher::subscription> _shader_file_watch;
+			std::shared_ptr<compile_job>                                _shader_job;
+			shader_param_map_t                                          _shader_params;
 
 			// Options
 			size_type _width_type;
@@ -74,9 +89,10 @@ namespace streamfx::gfx {
 			int32_t         _random_seed;
 			float_t _random_values[16]; // 0..4 Per-Instance-Random, 4..8 Per-Activation-Random 9..15 Per-Frame-Random
 
-			// Rendering
-			bool                                             _rt_up_to_date;
-			std::shared_ptr<streamfx::obs::gs::rendertarget> _rt;
+			// Rendering, leased from the pool for the current frame.
+			bool                                                  _rt_up_to_date;
+			std::shared_ptr<streamfx::obs::gs::rendertarget_pool> _rt_pool;
+			std::shared_ptr<streamfx::obs::gs::rendertarget>      _rt;
 
 			public:
 			shader(obs_source_t* self, shader_mode mode);
@@ -89,6 +105,14 @@ namespace streamfx::gfx {
 			bool load_shader(const std::filesystem::path& file, const std::string& tech, bool& shader_dirty,
 							 bool& param_dirty);
 
+			private:
+			void update_parameters(const std::string& tech);
+
+			static void task_compile(streamfx::util::threadpool_data_t data);
+
+			void finish_compile();
+
+			public:
 			static void defaults(obs_data_t* data);
 
 			void properties(obs_properties_t* props);
@@ -119,6 +143,8 @@ namespace streamfx::gfx {
 
 			std::filesystem::path get_shader_file();
 
+			float_t get_time();
+
 			public:
 			void set_size(uint32_t w, uint32_t h);
 
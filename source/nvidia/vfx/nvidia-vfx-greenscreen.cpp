@@ -105,9 +105,7 @@ std::shared_ptr<streamfx::obs::gs::texture>
 	auto gctx = ::streamfx::obs::gs::context();
 	auto cctx = _nvcuda->get_context()->enter();
 
-#ifdef ENABLE_PROFILING
 	::streamfx::obs::gs::debug_marker profiler1{::streamfx::obs::gs::debug_color_magenta, "NvVFX Background Removal"};
-#endif
 
 	// Resize if the size or scale was changed.
 	resize(in->get_width(), in->get_height());
@@ -118,9 +116,7 @@ std::shared_ptr<streamfx::obs::gs::texture>
 	}
 
 	{ // Copy parameter to input.
-#ifdef ENABLE_PROFILING
 		::streamfx::obs::gs::debug_marker profiler1{::streamfx::obs::gs::debug_color_copy, "Copy In -> Input"};
-#endif
 		gs_copy_texture(_input->get_texture()->get_object(), in->get_object());
 	}
 
@@ -132,9 +128,7 @@ std::shared_ptr<streamfx::obs::gs::texture>
 	}
 
 	{ // Copy input to source.
-#ifdef ENABLE_PROFILING
 		::streamfx::obs::gs::debug_marker profiler1{::streamfx::obs::gs::debug_color_copy, "Copy Input -> Source"};
-#endif
 		if (auto res = _nvcvi->NvCVImage_Transfer(_input->get_image(), _source->get_image(), 1.f,
 												  _nvcuda->get_stream()->get(), _tmp->get_image());
 			res != ::streamfx::nvidia::cv::result::SUCCESS) {
@@ -145,9 +139,7 @@ std::shared_ptr<streamfx::obs::gs::texture>
 	}
 
 	{ // Process source to destination.
-#ifdef ENABLE_PROFILING
 		::streamfx::obs::gs::debug_marker profiler1{::streamfx::obs::gs::debug_color_cache, "Process"};
-#endif
 		if (auto res = run(); res != ::streamfx::nvidia::cv::result::SUCCESS) {
 			D_LOG_ERROR("Failed to process due to error: %s", _nvcvi->NvCV_GetErrorStringFromCode(res));
 			throw std::runtime_error("Run failed.");
@@ -155,10 +147,8 @@ std::shared_ptr<streamfx::obs::gs::texture>
 	}
 
 	{ // Copy destination to output.
-#ifdef ENABLE_PROFILING
 		::streamfx::obs::gs::debug_marker profiler1{::streamfx::obs::gs::debug_color_copy,
 													"Copy Destination -> Output"};
-#endif
 		if (auto res = _nvcvi->NvCVImage_Transfer(_destination->get_image(), _output->get_image(), 1.,
 												  _nvcuda->get_stream()->get(), _tmp->get_image());
 			res != ::streamfx::nvidia::cv::result::SUCCESS) {
@@ -46,9 +46,9 @@ streamfx::obs::gs::effect_parameter::effect_parameter(gs_eparam_t* param)
 }
 
 streamfx::obs::gs::effect_parameter::effect_parameter(gs_eparam_t* param, std::shared_ptr<gs_effect_t> parent)
-	: effect_parameter(param)
+	: std::shared_ptr<gs_eparam_t>(parent, param), _effect_parent(parent), _pass_parent(nullptr), _param_parent(nullptr)
 {
-	_effect_parent = parent;
+	// Share ownership with the effect instead of allocating a new control block for every lookup.
 }
 
 streamfx::obs::gs::effect_parameter::effect_parameter(gs_eparam_t* param, std::shared_ptr<gs_epass_t> parent)
@@ -65,17 +65,15 @@ streamfx::obs::gs::effect_parameter::effect_parameter(gs_eparam_t* param, std::s
 
 streamfx::obs::gs::effect_parameter::~effect_parameter() {}
 
+// Copies and moves share the handle instead of wrapping it again, so passing parameters around doesn't allocate.
 streamfx::obs::gs::effect_parameter::effect_parameter(const effect_parameter& rhs)
-{
-	reset(rhs.get(), [](void*) {});
-	_effect_parent = rhs._effect_parent;
-	_pass_parent   = rhs._pass_parent;
-	_param_parent  = rhs._param_parent;
-}
+	: std::shared_ptr<gs_eparam_t>(rhs), _effect_parent(rhs._effect_parent), _pass_parent(rhs._pass_parent),
+	  _param_parent(rhs._param_parent)
+{}
 
 streamfx::obs::gs::effect_parameter& streamfx::obs::gs::effect_parameter::operator=(const effect_parameter& rhs)
 {
-	reset(rhs.get(), [](void*) {});
+	std::shared_ptr<gs_eparam_t>::operator=(rhs);
 	_effect_parent = rhs._effect_parent;
 	_pass_parent   = rhs._pass_parent;
 	_param_parent  = rhs._param_parent;
@@ -83,33 +81,16 @@ streamfx::obs::gs::effect_parameter& streamfx::obs::gs::effect_parameter::operat
 }
 
 streamfx::obs::gs::effect_parameter::effect_parameter(effect_parameter&& rhs) noexcept
-try {
-	reset(rhs.get(), [](gs_eparam_t*) {});
-	_effect_parent = rhs._effect_parent;
-	_pass_parent   = rhs._pass_parent;
-	_param_parent  = rhs._param_parent;
-
-	rhs.reset();
-	rhs._effect_parent = nullptr;
-	rhs._pass_parent   = nullptr;
-	rhs._param_parent  = nullptr;
-} catch (...) {
-}
+	: std::shared_ptr<gs_eparam_t>(std::move(rhs)), _effect_parent(std::move(rhs._effect_parent)),
+	  _pass_parent(std::move(rhs._pass_parent)), _param_parent(std::move(rhs._param_parent))
+{}
 
 streamfx::obs::gs::effect_parameter& streamfx::obs::gs::effect_parameter::operator=(effect_parameter&& rhs) noexcept
-try {
-	reset(rhs.get(), [](gs_eparam_t*) {});
-	_effect_parent = rhs._effect_parent;
-	_pass_parent   = rhs._pass_parent;
-	_param_parent  = rhs._param_parent;
-
-	rhs.reset();
-	rhs._effect_parent = nullptr;
-	rhs._pass_parent   = nullptr;
-	rhs._param_parent  = nullptr;
-
-	return *this;
-} catch (...) {
+{
+	std::shared_ptr<gs_eparam_t>::operator=(std::move(rhs));
+	_effect_parent = std::move(rhs._effect_parent);
+	_pass_parent   = std::move(rhs._pass_parent);
+	_param_parent  = std::move(rhs._param_parent);
 	return *this;
 }
 
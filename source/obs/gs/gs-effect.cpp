@@ -18,7 +18,9 @@
  */
 
 #include "gs-effect.hpp"
+#include <algorithm>
 #include <fstream>
+#include <functional>
 #include <sstream>
 #include <stdexcept>
 #include <vector>
@@ -27,7 +29,10 @@
 
 #define MAX_EFFECT_SIZE 32 * 1024 * 1024 // 32 MiB, big enough for everything.
 
-static std::string load_file_as_code(std::filesystem::path shader_file, bool is_top_level = true)
+std::mutex                                                              streamfx::obs::gs::effect::_cache_lock;
+std::map<std::filesystem::path, streamfx::obs::gs::effect::cache_entry> streamfx::obs::gs::effect::_cache;
+
+static std::string load_file_as_code(std::filesystem::path shader_file, int device_type, bool is_top_level = true)
 {
 	std::stringstream     shader_stream;
 	std::filesystem::path shader_path = std::filesystem::absolute(shader_file);
@@ -47,8 +52,7 @@ static std::string load_file_as_code(std::filesystem::path shader_file, bool is_
 
 	// Push Graphics API to shader.
 	if (is_top_level) {
-		auto gctx = streamfx::obs::gs::context();
-		switch (gs_get_device_type()) {
+		switch (device_type) {
 		case GS_DEVICE_DIRECT3D_11:
 			shader_stream << "#define GS_DEVICE_DIRECT3D_11" << std::endl;
 			shader_stream << "#define GS_DEVICE_DIRECT3D" << std::endl;
@@ -87,7 +91,7 @@ static std::string load_file_as_code(std::filesystem::path shader_file, bool is_
 				include_path = shader_root / include_str;
 			}
 
-			line = load_file_as_code(include_path, false);
+			line = load_file_as_code(include_path, device_type, false);
 		}
 
 		shader_stream << line << std::endl;
@@ -109,12 +113,84 @@ streamfx::obs::gs::effect::effect(const std::string& code, const std::string& na
 	}
 
 	reset(effect, [](gs_effect_t* ptr) { gs_effect_destroy(ptr); });
+
+	// Index the parameters by name, so that looking them up doesn't have to compare against every one of them.
+	_parameter_index = std::make_shared<parameter_index_t>();
+	_parameter_index->reserve(effect->params.num);
+	for (std::size_t idx = 0; idx < effect->params.num; idx++) {
+		auto ptr = effect->params.array + idx;
+		_parameter_index->emplace_back(std::string_view{ptr->name}, ptr);
+	}
+	std::sort(_parameter_index->begin(), _parameter_index->end(),
+			  [](auto const& lhs, auto const& rhs) { return lhs.first < rhs.first; });
 }
 
-streamfx::obs::gs::effect::effect(std::filesystem::path file)
-	: effect(load_file_as_code(file),
-			 streamfx::util::platform::utf8_to_native(std::filesystem::absolute(file)).generic_u8string())
-{}
+streamfx::obs::gs::effect::effect(std::filesystem::path file, bool shared)
+{
+	int device_type;
+	{
+		auto gctx   = streamfx::obs::gs::context();
+		device_type = gs_get_device_type();
+	}
+
+	std::filesystem::path path = std::filesystem::weakly_canonical(std::filesystem::absolute(file));
+	std::string           code = load_file_as_code(path, device_type);
+
+	if (!shared) {
+		streamfx::obs::gs::effect compiled(code, streamfx::util::platform::utf8_to_native(path).generic_u8string());
+		std::shared_ptr<gs_effect_t>::operator=(compiled);
+		_parameter_index = compiled._parameter_index;
+		return;
+	}
+	std::size_t hash = std::hash<std::string>{}(code);
+
+	// Reuse the effect if it is still alive and the pre-processed code hasn't changed since.
+	auto find_cached = [this, &path, hash]() {
+		auto kv = _cache.find(path);
+		if ((kv == _cache.end()) || (kv->second.hash != hash))
+			return false;
+
+		auto cached = kv->second.effect.lock();
+		auto index  = kv->second.index.lock();
+		if (!cached || !index)
+			return false;
+
+		std::shared_ptr<gs_effect_t>::operator=(cached);
+		_parameter_index = index;
+		return true;
+	};
+
+	{
+		std::unique_lock<std::mutex> lock(_cache_lock);
+		if (find_cached())
+			return;
+	}
+
+	// Compile without holding the cache lock, as the graphics context may be held by a thread waiting on it.
+	streamfx::obs::gs::effect compiled(code, streamfx::util::platform::utf8_to_native(path).generic_u8string());
+
+	std::unique_lock<std::mutex> lock(_cache_lock);
+	if (find_cached()) // Another thread compiled the same code in the meantime.
+		return;
+
+	std::shared_ptr<gs_effect_t>::operator=(compiled);
+	_parameter_index = compiled._parameter_index;
+	_cache.insert_or_assign(path, cache_entry{hash, compiled, compiled._parameter_index});
+
+	// Forget about effects that are no longer in use.
+	for (auto kv = _cache.begin(); kv != _cache.end();) {
+		if (kv->second.effect.expired()) {
+			kv = _cache.erase(kv);
+		} else {
+			++kv;
+		}
+	}
+}
+
+std::string streamfx::obs::gs::effect::load_code(std::filesystem::path file, int device_type)
+{
+	return load_file_as_code(std::filesystem::weakly_canonical(std::filesystem::absolute(file)), device_type);
+}
 
 streamfx::obs::gs::effect::~effect()
 {
@@ -169,11 +245,20 @@ streamfx::obs::gs::effect_parameter streamfx::obs::gs::effect::get_parameter(std
 	return streamfx::obs::gs::effect_parameter(get()->params.array + idx, *this);
 }
 
-streamfx::obs::gs::effect_parameter streamfx::obs::gs::effect::get_parameter(const std::string& name)
+streamfx::obs::gs::effect_parameter streamfx::obs::gs::effect::get_parameter(std::string_view name)
 {
+	if (_parameter_index) {
+		auto iter = std::lower_bound(_parameter_index->begin(), _parameter_index->end(), name,
+									 [](auto const& lhs, std::string_view rhs) { return lhs.first < rhs; });
+		if ((iter != _parameter_index->end()) && (iter->first == name)) {
+			return streamfx::obs::gs::effect_parameter(iter->second, *this);
+		}
+		return nullptr;
+	}
+
 	for (std::size_t idx = 0; idx < count_parameters(); idx++) {
 		auto ptr = get()->params.array + idx;
-		if (strcmp(ptr->name, name.c_str()) == 0) {
+		if (name == ptr->name) {
 			return streamfx::obs::gs::effect_parameter(ptr, *this);
 		}
 	}
@@ -181,17 +266,39 @@ streamfx::obs::gs::effect_parameter streamfx::obs::gs::effect::get_parameter(con
 	return nullptr;
 }
 
-bool streamfx::obs::gs::effect::has_parameter(const std::string& name)
+bool streamfx::obs::gs::effect::has_parameter(std::string_view name)
 {
 	if (get_parameter(name))
 		return true;
 	return false;
 }
 
-bool streamfx::obs::gs::effect::has_parameter(const std::string& name, effect_parameter::type type)
+bool streamfx::obs::gs::effect::has_parameter(std::string_view name, effect_parameter::type type)
 {
 	auto eprm = get_parameter(name);
 	if (eprm)
 		return eprm.get_type() == type;
 	return false;
 }
+
+streamfx::obs::gs::effect_bindings::effect_bindings(std::initializer_list<std::string_view> names)
+	: _names(names), _effect(), _parameters(names.size())
+{}
+
+streamfx::obs::gs::effect_bindings& streamfx::obs::gs::effect_bindings::bind(streamfx::obs::gs::effect& effect)
+{
+	if (!_effect.expired() && !_effect.owner_before(effect) && !effect.owner_before(_effect)) {
+		return *this;
+	}
+
+	// The handles don't hold on to the effect, the caller already does.
+	_effect = effect;
+	for (std::size_t idx = 0; idx < _names.size(); idx++) {
+		if (effect) {
+			_parameters[idx] = streamfx::obs::gs::effect_parameter(effect.get_parameter(_names[idx]).get());
+		} else {
+			_parameters[idx] = streamfx::obs::gs::effect_parameter();
+		}
+	}
+	return *this;
+}
@@ -20,18 +20,53 @@
 #pragma once
 #include "common.hpp"
 #include <filesystem>
+#include <initializer_list>
 #include <list>
+#include <map>
+#include <mutex>
+#include <string_view>
+#include <utility>
+#include <vector>
 #include "gs-effect-parameter.hpp"
 #include "gs-effect-technique.hpp"
 
 namespace streamfx::obs::gs {
 	class effect : public std::shared_ptr<gs_effect_t> {
+		typedef std::vector<std::pair<std::string_view, gs_eparam_t*>> parameter_index_t;
+
+		// Parameters sorted by name, built once when the effect is loaded.
+		std::shared_ptr<parameter_index_t> _parameter_index;
+
+		// Effects loaded from files, shared for as long as someone is still using them.
+		struct cache_entry {
+			std::size_t                      hash;
+			std::weak_ptr<gs_effect_t>       effect;
+			std::weak_ptr<parameter_index_t> index;
+		};
+		static std::mutex                                   _cache_lock;
+		static std::map<std::filesystem::path, cache_entry> _cache;
+
 		public:
 		effect(){};
 		effect(const std::string& code, const std::string& name);
-		effect(std::filesystem::path file);
+
+		/** Load an effect from a file.
+		 *
+		 * If `shared`, loading the same file again returns the already compiled effect for as long as it is alive,
+		 * unless the file or anything it includes has changed since. Parameters of a shared effect must be set right
+		 * before every use of it, without rendering anything else in between that might use the same file. Effects
+		 * which can't guarantee that, like user shaders that render other sources while assigning parameters, must
+		 * not be shared.
+		 */
+		effect(std::filesystem::path file, bool shared = true);
 		~effect();
 
+		/** Read and pre-process an effect file for the given device type, without compiling it.
+		 *
+		 * Does not need the graphics context, so it can run on any thread. Compile the result with effect(code, name).
+		 */
+		static std::string load_code(std::filesystem::path file, int device_type);
+
 		std::size_t                         count_techniques();
 		streamfx::obs::gs::effect_technique get_technique(std::size_t idx);
 		streamfx::obs::gs::effect_technique get_technique(const std::string& name);
@@ -39,9 +74,9 @@ namespace streamfx::obs::gs {
 
 		std::size_t                         count_parameters();
 		streamfx::obs::gs::effect_parameter get_parameter(std::size_t idx);
-		streamfx::obs::gs::effect_parameter get_parameter(const std::string& name);
-		bool                                has_parameter(const std::string& name);
-		bool                                has_parameter(const std::string& name, effect_parameter::type type);
+		streamfx::obs::gs::effect_parameter get_parameter(std::string_view name);
+		bool                                has_parameter(std::string_view name);
+		bool                                has_parameter(std::string_view name, effect_parameter::type type);
 
 		public /* Legacy Support */:
 		inline gs_effect_t* get_object()
@@ -64,4 +99,26 @@ namespace streamfx::obs::gs {
 			return streamfx::obs::gs::effect(file);
 		};
 	};
+
+	/** Parameter handles that are resolved once per effect, so that setting them is just an indexed access.
+	 *
+	 * Construct with the parameter names in the order they are indexed by, and call bind() before using it. Binding
+	 * again with the same effect does nothing; a different or reloaded effect resolves the names again. Parameters that
+	 * don't exist in the effect are empty handles.
+	 */
+	class effect_bindings {
+		std::vector<std::string_view>                    _names;
+		std::weak_ptr<gs_effect_t>                       _effect;
+		std::vector<streamfx::obs::gs::effect_parameter> _parameters;
+
+		public:
+		effect_bindings(std::initializer_list<std::string_view> names);
+
+		effect_bindings& bind(streamfx::obs::gs::effect& effect);
+
+		inline streamfx::obs::gs::effect_parameter& operator[](std::size_t idx)
+		{
+			return _parameters[idx];
+		}
+	};
 } // namespace streamfx::obs::gs
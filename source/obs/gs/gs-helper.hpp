@@ -19,8 +19,11 @@
 
 #pragma once
 #include "common.hpp"
+#include <cstdarg>
+#include <optional>
 #include <vector>
 #include "plugin.hpp"
+#include "util/util-tracing.hpp"
 
 namespace streamfx::obs::gs {
 	class context {
@@ -37,7 +40,6 @@ namespace streamfx::obs::gs {
 		}
 	};
 
-#ifdef ENABLE_PROFILING
 	static constexpr float_t debug_color_white[4]           = {1.f, 1.f, 1.f, 1.f};
 	static constexpr float_t debug_color_gray[4]            = {.5f, .5f, .5f, 1.f};
 	static constexpr float_t debug_color_black[4]           = {0.f, 0.f, 0.f, 1.f};
@@ -63,28 +65,51 @@ namespace streamfx::obs::gs {
 	static const float_t* debug_color_allocate     = debug_color_red;
 	static const float_t* debug_color_render       = debug_color_teal;
 
+	/** Marks a region of rendering as a GPU debug marker and as a tracing span.
+	 *
+	 * Markers are only emitted while tracing is enabled, or always in builds with ENABLE_PROFILING, so that they cost
+	 * next to nothing otherwise.
+	 */
 	class debug_marker {
-		std::string _name;
+		bool                                         _active;
+		std::optional<streamfx::util::tracing::span> _span;
 
 		public:
-		inline debug_marker(const float_t color[4], const char* format, ...)
+		inline debug_marker(const float_t color[4], const char* format, ...) : _active(false), _span()
 		{
-			std::size_t       size;
+#ifndef ENABLE_PROFILING
+			if (!streamfx::util::tracing::enabled())
+				return;
+#endif
+
 			std::vector<char> buffer(64);
 
 			va_list vargs;
 			va_start(vargs, format);
-			size = static_cast<size_t>(vsnprintf(buffer.data(), buffer.size(), format, vargs));
+			va_list vargs2;
+			va_copy(vargs2, vargs);
+			int size = vsnprintf(buffer.data(), buffer.size(), format, vargs);
+			if (size >= static_cast<int>(buffer.size())) {
+				buffer.resize(static_cast<size_t>(size) + 1);
+				vsnprintf(buffer.data(), buffer.size(), format, vargs2);
+			}
+			va_end(vargs2);
 			va_end(vargs);
 
-			_name = std::string(buffer.data(), buffer.data() + size);
-			gs_debug_marker_begin(color, _name.c_str());
+			// Spans keep a pointer to their name until they are written out, so it has to outlive this marker.
+			const char* name = streamfx::util::tracing::intern(buffer.data());
+			gs_debug_marker_begin(color, name);
+			_span.emplace(name, "render");
+			_active = true;
 		}
 
 		inline ~debug_marker()
 		{
+			if (!_active)
+				return;
+
+			_span.reset();
 			gs_debug_marker_end();
 		}
 	};
-#endif
 } // namespace streamfx::obs::gs
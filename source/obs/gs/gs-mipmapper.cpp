@@ -268,10 +268,8 @@ void streamfx::obs::gs::mipmapper::rebuild(std::shared_ptr<streamfx::obs::gs::te
 		size_t   max_mip_level = calculate_max_mip_level(width, height);
 
 		{
-#ifdef ENABLE_PROFILING
 			auto cctr = streamfx::obs::gs::debug_marker(streamfx::obs::gs::debug_color_azure_radiance,
 														"Mip Level %" PRId64 "", 0);
-#endif
 
 			// Retrieve maximum mip map level.
 #ifdef _WIN32
@@ -301,10 +299,8 @@ void streamfx::obs::gs::mipmapper::rebuild(std::shared_ptr<streamfx::obs::gs::te
 
 		// Render each mip map level.
 		for (size_t mip = 1; mip < max_mip_level; mip++) {
-#ifdef ENABLE_PROFILING
 			auto cctr = streamfx::obs::gs::debug_marker(streamfx::obs::gs::debug_color_azure_radiance,
 														"Mip Level %" PRIuMAX, mip);
-#endif
 
 			uint32_t cwidth  = std::max<uint32_t>(width >> mip, 1);
 			uint32_t cheight = std::max<uint32_t>(height >> mip, 1);
@@ -0,0 +1,215 @@
+// Copyright (c) 2021 Michael Fabian Dirks <info@xaymar.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "gs-rendertarget-pool.hpp"
+#include "obs/gs/gs-helper.hpp"
+
+// Unused targets are released after this many frames without being leased again.
+#define ST_MAX_UNUSED_FRAMES 120
+
+// Default amount of memory that unused targets may hold on to.
+#define ST_DEFAULT_BUDGET (256ull * 1024ull * 1024ull)
+
+static uint64_t calculate_size(gs_color_format color_format, gs_zstencil_format zstencil_format, uint32_t width,
+							   uint32_t height)
+{
+	uint64_t bpp = 4;
+	switch (color_format) {
+	case GS_A8:
+	case GS_R8:
+	case GS_DXT3:
+	case GS_DXT5:
+		bpp = 1;
+		break;
+	case GS_R16:
+	case GS_R16F:
+	case GS_R8G8:
+		bpp = 2;
+		break;
+	case GS_RGBA16:
+	case GS_RGBA16F:
+	case GS_RG32F:
+		bpp = 8;
+		break;
+	case GS_RGBA32F:
+		bpp = 16;
+		break;
+	default:
+		break;
+	}
+
+	switch (zstencil_format) {
+	case GS_Z16:
+		bpp += 2;
+		break;
+	case GS_Z24_S8:
+	case GS_Z32F:
+		bpp += 4;
+		break;
+	case GS_Z32F_S8X24:
+		bpp += 8;
+		break;
+	default:
+		break;
+	}
+
+	return bpp * width * height;
+}
+
+streamfx::obs::gs::rendertarget_pool::~rendertarget_pool()
+{
+	obs_remove_tick_callback(tick, this);
+
+	auto gctx = streamfx::obs::gs::context();
+	_unused.clear();
+}
+
+streamfx::obs::gs::rendertarget_pool::rendertarget_pool()
+	: _lock(), _unused(), _unused_size(0), _leased_size(0), _budget(ST_DEFAULT_BUDGET), _frame(0)
+{
+	obs_add_tick_callback(tick, this);
+}
+
+std::shared_ptr<streamfx::obs::gs::rendertarget> streamfx::obs::gs::rendertarget_pool::acquire(
+	gs_color_format color_format, gs_zstencil_format zstencil_format, uint32_t width, uint32_t height)
+{
+	entry item;
+	{
+		std::unique_lock<std::mutex> lock(_lock);
+		for (auto iter = _unused.begin(); iter != _unused.end(); iter++) {
+			if ((iter->color_format == color_format) && (iter->zstencil_format == zstencil_format)
+				&& (iter->width == width) && (iter->height == height)) {
+				item = std::move(*iter);
+				_unused.erase(iter);
+				_unused_size -= item.size;
+				break;
+			}
+		}
+		if (item.target) {
+			_leased_size += item.size;
+		}
+	}
+
+	if (!item.target) {
+		// Nothing suitable is available, so create a new one.
+		item.target          = std::make_unique<streamfx::obs::gs::rendertarget>(color_format, zstencil_format);
+		item.color_format    = color_format;
+		item.zstencil_format = zstencil_format;
+		item.width           = width;
+		item.height          = height;
+		item.size            = calculate_size(color_format, zstencil_format, width, height);
+
+		std::unique_lock<std::mutex> lock(_lock);
+		_leased_size += item.size;
+	}
+
+	// Hand out a pointer which puts the target back into the pool once it is no longer used.
+	auto* target = item.target.release();
+	return std::shared_ptr<streamfx::obs::gs::rendertarget>(
+		target, [pool = weak_from_this(), item = std::make_shared<entry>(std::move(item))](
+					streamfx::obs::gs::rendertarget* ptr) {
+			item->target.reset(ptr);
+			if (auto self = pool.lock(); self) {
+				self->release(std::move(*item));
+			}
+		});
+}
+
+void streamfx::obs::gs::rendertarget_pool::set_budget(uint64_t budget)
+{
+	std::list<entry> evicted;
+	{
+		std::unique_lock<std::mutex> lock(_lock);
+		_budget = budget;
+		evict(evicted);
+	}
+}
+
+uint64_t streamfx::obs::gs::rendertarget_pool::get_budget()
+{
+	std::unique_lock<std::mutex> lock(_lock);
+	return _budget;
+}
+
+uint64_t streamfx::obs::gs::rendertarget_pool::get_leased_size()
+{
+	std::unique_lock<std::mutex> lock(_lock);
+	return _leased_size;
+}
+
+uint64_t streamfx::obs::gs::rendertarget_pool::get_unused_size()
+{
+	std::unique_lock<std::mutex> lock(_lock);
+	return _unused_size;
+}
+
+void streamfx::obs::gs::rendertarget_pool::release(entry&& item)
+{
+	std::list<entry> evicted;
+	{
+		std::unique_lock<std::mutex> lock(_lock);
+		item.last_used = _frame;
+		_leased_size -= item.size;
+		_unused_size += item.size;
+		_unused.push_front(std::move(item));
+		evict(evicted);
+	}
+}
+
+void streamfx::obs::gs::rendertarget_pool::evict(std::list<entry>& evicted)
+{
+	// Drop whatever is over budget, starting with the least recently used.
+	while (!_unused.empty() && (_unused_size > _budget)) {
+		_unused_size -= _unused.back().size;
+		evicted.splice(evicted.end(), _unused, std::prev(_unused.end()));
+	}
+
+	// Drop whatever hasn't been used in a while.
+	while (!_unused.empty() && ((_frame - _unused.back().last_used) > ST_MAX_UNUSED_FRAMES)) {
+		_unused_size -= _unused.back().size;
+		evicted.splice(evicted.end(), _unused, std::prev(_unused.end()));
+	}
+}
+
+void streamfx::obs::gs::rendertarget_pool::tick(void* data, float_t)
+{
+	auto self = reinterpret_cast<streamfx::obs::gs::rendertarget_pool*>(data);
+
+	std::list<entry> evicted;
+	{
+		std::unique_lock<std::mutex> lock(self->_lock);
+		self->_frame++;
+		self->evict(evicted);
+	}
+}
+
+std::shared_ptr<streamfx::obs::gs::rendertarget_pool> streamfx::obs::gs::rendertarget_pool::get()
+{
+	static std::weak_ptr<streamfx::obs::gs::rendertarget_pool> instance;
+	static std::mutex                                          lock;
+
+	std::unique_lock<std::mutex> ul(lock);
+	if (instance.expired()) {
+		auto hard_instance = std::shared_ptr<streamfx::obs::gs::rendertarget_pool>(new rendertarget_pool());
+		instance           = hard_instance;
+		return hard_instance;
+	}
+	return instance.lock();
+}
@@ -0,0 +1,84 @@
+// Copyright (c) 2021 Michael Fabian Dirks <info@xaymar.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+#include "common.hpp"
+#include <list>
+#include <memory>
+#include <mutex>
+#include "gs-rendertarget.hpp"
+
+namespace streamfx::obs::gs {
+	/** Shares render targets between everything that only needs them while rendering.
+	 *
+	 * Targets are leased by format and size, and return to the pool once the last reference to the lease is gone.
+	 * Returned targets are kept around for reuse until they haven't been used for a while, or until the memory held by
+	 * unused targets exceeds the budget, at which point the least recently used ones are released first.
+	 *
+	 * Render to a leased target only at the size it was leased with, as that is what it is tracked and reused as.
+	 */
+	class rendertarget_pool : public std::enable_shared_from_this<rendertarget_pool> {
+		struct entry {
+			std::unique_ptr<streamfx::obs::gs::rendertarget> target;
+			gs_color_format                                  color_format;
+			gs_zstencil_format                               zstencil_format;
+			uint32_t                                         width;
+			uint32_t                                         height;
+			uint64_t                                         size;
+			uint64_t                                         last_used;
+		};
+
+		std::mutex       _lock;
+		std::list<entry> _unused; // Most recently used first.
+		uint64_t         _unused_size;
+		uint64_t         _leased_size;
+		uint64_t         _budget;
+		uint64_t         _frame;
+
+		public:
+		~rendertarget_pool();
+
+		/** Lease a render target, which is returned to the pool when the last copy of the pointer goes away. */
+		std::shared_ptr<streamfx::obs::gs::rendertarget> acquire(gs_color_format color_format,
+																 gs_zstencil_format zstencil_format, uint32_t width,
+																 uint32_t height);
+
+		/** Maximum amount of memory, in bytes, that unused targets may hold on to. */
+		void     set_budget(uint64_t budget);
+		uint64_t get_budget();
+
+		/** Memory, in bytes, currently held by leased and unused targets. */
+		uint64_t get_leased_size();
+		uint64_t get_unused_size();
+
+		private:
+		rendertarget_pool();
+
+		void release(entry&& item);
+
+		// Moves everything that should be freed into 'evicted', so it can be destroyed outside of the lock.
+		void evict(std::list<entry>& evicted);
+
+		static void tick(void* data, float_t seconds);
+
+		public /* Singleton */:
+		static std::shared_ptr<streamfx::obs::gs::rendertarget_pool> get();
+	};
+} // namespace streamfx::obs::gs
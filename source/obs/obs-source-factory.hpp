@@ -319,8 +319,11 @@ namespace streamfx::obs {
 
 		static void _video_render(void* data, gs_effect_t* effect) noexcept
 		try {
-			if (data)
+			if (data) {
+				::streamfx::util::tracing::span trace(obs_source_get_id(reinterpret_cast<_instance*>(data)->get()),
+													  "render");
 				reinterpret_cast<_instance*>(data)->video_render(effect);
+			}
 		} catch (const std::exception& ex) {
 			DLOG_ERROR("Unexpected exception in function '%s': %s.", __FUNCTION_NAME__, ex.what());
 		} catch (...) {
@@ -329,8 +332,11 @@ namespace streamfx::obs {
 
 		static void _video_render_filter(void* data, gs_effect_t* effect) noexcept
 		try {
-			if (data)
+			if (data) {
+				::streamfx::util::tracing::span trace(obs_source_get_id(reinterpret_cast<_instance*>(data)->get()),
+													  "render");
 				reinterpret_cast<_instance*>(data)->video_render(effect);
+			}
 		} catch (const std::exception& ex) {
 			DLOG_ERROR("Unexpected exception in function '%s': %s.", __FUNCTION_NAME__, ex.what());
 			obs_source_skip_video_filter(reinterpret_cast<_instance*>(data)->get());
@@ -23,8 +23,10 @@
 #include "configuration.hpp"
 #include "gfx/gfx-opengl.hpp"
 #include "obs/gs/gs-helper.hpp"
+#include "obs/gs/gs-rendertarget-pool.hpp"
 #include "obs/gs/gs-vertexbuffer.hpp"
 #include "obs/obs-source-tracker.hpp"
+#include "util/util-profiler.hpp"
 
 #ifdef ENABLE_NVIDIA_CUDA
 #include "nvidia/cuda/nvidia-cuda-obs.hpp"
@@ -91,9 +93,10 @@
 //static std::shared_ptr<streamfx::updater> _updater;
 #endif
 
-static std::shared_ptr<streamfx::util::threadpool>       _threadpool;
-static std::shared_ptr<streamfx::obs::gs::vertex_buffer> _gs_fstri_vb;
-static std::shared_ptr<streamfx::gfx::opengl>            _streamfx_gfx_opengl;
+static std::shared_ptr<streamfx::util::threadpool>            _threadpool;
+static std::shared_ptr<streamfx::obs::gs::vertex_buffer>      _gs_fstri_vb;
+static std::shared_ptr<streamfx::obs::gs::rendertarget_pool> _gs_rendertarget_pool;
+static std::shared_ptr<streamfx::gfx::opengl>                 _streamfx_gfx_opengl;
 
 MODULE_EXPORT bool obs_module_load(void)
 try {
@@ -143,6 +146,8 @@ try {
 			vec4_set(vtx.uv[0], 0, 2, 0, 0);
 		}
 		_gs_fstri_vb->update();
+
+		_gs_rendertarget_pool = streamfx::obs::gs::rendertarget_pool::get();
 	}
 
 	// Encoders
@@ -300,6 +305,7 @@ try {
 
 	// GS Stuff
 	{
+		_gs_rendertarget_pool.reset();
 		_gs_fstri_vb.reset();
 	}
 
@@ -330,6 +336,24 @@ try {
 	DLOG_ERROR("Unexpected exception in function '%s'.", __FUNCTION_NAME__);
 }
 
+#ifdef ENABLE_BENCHMARK
+typedef void (*streamfx_profiler_callback_t)(void* data, const char* name, uint64_t count, double_t average_us,
+											 double_t p50_us, double_t p95_us, double_t p99_us, double_t p999_us);
+
+// Lets the encoder benchmark read the per-stage timings which the encoders publish when they are destroyed.
+MODULE_EXPORT void streamfx_enumerate_profilers(streamfx_profiler_callback_t callback, void* data)
+try {
+	streamfx::util::profiler::enumerate(
+		[callback, data](std::string const& name, std::shared_ptr<streamfx::util::profiler> profiler) {
+			auto us = [&profiler](double_t p) { return double_t(profiler->percentile(p).count()) / 1000.; };
+			callback(data, name.c_str(), profiler->count(), profiler->average_duration() / 1000., us(0.5), us(0.95),
+					 us(0.99), us(0.999));
+		});
+} catch (...) {
+	DLOG_ERROR("Unexpected exception in function '%s'.", __FUNCTION_NAME__);
+}
+#endif
+
 std::shared_ptr<streamfx::util::threadpool> streamfx::threadpool()
 {
 	return _threadpool;
@@ -157,10 +157,8 @@ void mirror_instance::video_render(gs_effect_t* effect)
 	if ((obs_source_get_output_flags(_source.get()) & OBS_SOURCE_VIDEO) == 0)
 		return;
 
-#ifdef ENABLE_PROFILING
 	streamfx::obs::gs::debug_marker gdmp{streamfx::obs::gs::debug_color_source, "Source Mirror '%s' for '%s'",
 										 obs_source_get_name(_self), obs_source_get_name(_source.get())};
-#endif
 
 	_source_size.first  = obs_source_get_width(_source.get());
 	_source_size.second = obs_source_get_height(_source.get());
@@ -278,7 +276,8 @@ void mirror_instance::on_audio(std::shared_ptr<obs_source_t>, const audio_data*
 	}
 
 	// Create a clone of the audio data and push it to the thread pool.
-	streamfx::threadpool()->push(std::bind(&mirror_instance::audio_output, this, std::placeholders::_1), nullptr);
+	streamfx::threadpool()->push(std::bind(&mirror_instance::audio_output, this, std::placeholders::_1), nullptr,
+								 ::streamfx::util::threadpool_priority::HIGH);
 }
 
 void mirror_instance::audio_output(std::shared_ptr<void> data)
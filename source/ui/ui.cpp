@@ -20,6 +20,7 @@
 #include "ui.hpp"
 #include "common.hpp"
 #include "strings.hpp"
+#include <chrono>
 #include <string_view>
 #include "configuration.hpp"
 #include "obs/obs-tools.hpp"
@@ -38,6 +39,7 @@ constexpr std::string_view _i18n_menu_youtube = "UI.Menu.YouTube";
 constexpr std::string_view _i18n_menu_twitter = "UI.Menu.Twitter";
 constexpr std::string_view _i18n_menu_github  = "UI.Menu.Github";
 constexpr std::string_view _i18n_menu_about   = "UI.Menu.About";
+constexpr std::string_view _i18n_menu_trace   = "UI.Menu.Trace";
 
 // Configuration
 constexpr std::string_view _cfg_have_shown_about = "UI.HaveShownAboutStreamFX";
@@ -78,6 +80,7 @@ streamfx::ui::handler::handler()
 	: QObject(), _menu_action(), _menu(),
 
 	  _action_support(), _action_wiki(), _action_website(), _action_discord(), _action_twitter(), _action_youtube(),
+	  _action_trace(),
 
 	  _about_action(), _about_dialog(),
 
@@ -135,6 +138,7 @@ void streamfx::ui::handler::on_obs_loaded()
 		// <--->
 		// <Updater>
 		// ---
+		// Record Trace
 		// About StreamFX
 
 		{
@@ -175,6 +179,12 @@ void streamfx::ui::handler::on_obs_loaded()
 
 		_menu->addSeparator();
 
+		// Record Trace
+		_action_trace = _menu->addAction(QString::fromUtf8(D_TRANSLATE(_i18n_menu_trace.data())));
+		_action_trace->setMenuRole(QAction::NoRole);
+		_action_trace->setCheckable(true);
+		connect(_action_trace, &QAction::triggered, this, &streamfx::ui::handler::on_action_trace);
+
 		// About
 		_about_action = _menu->addAction(QString::fromUtf8(D_TRANSLATE(_i18n_menu_about.data())));
 		_about_action->setMenuRole(QAction::NoRole);
@@ -250,6 +260,29 @@ void streamfx::ui::handler::on_action_youtube(bool)
 	QDesktopServices::openUrl(QUrl(QString::fromUtf8(_url_youtube.data())));
 }
 
+void streamfx::ui::handler::on_action_trace(bool checked)
+{
+	if (checked) {
+		streamfx::util::tracing::enable(true);
+		return;
+	}
+
+	streamfx::util::tracing::enable(false);
+	try {
+		auto timestamp =
+			std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch());
+		auto path = streamfx::config_file_path("traces/trace-" + std::to_string(timestamp.count()) + ".json");
+		std::filesystem::create_directories(path.parent_path());
+		if (streamfx::util::tracing::dump(path)) {
+			DLOG_INFO("Trace written to '%s'.", path.u8string().c_str());
+		} else {
+			DLOG_WARNING("Failed to write trace to '%s'.", path.u8string().c_str());
+		}
+	} catch (const std::exception& ex) {
+		DLOG_WARNING("Failed to write trace: %s", ex.what());
+	}
+}
+
 void streamfx::ui::handler::on_action_about(bool checked)
 {
 	_about_dialog->show();
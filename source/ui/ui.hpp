@@ -40,6 +40,7 @@ namespace streamfx::ui {
 		QAction* _action_discord;
 		QAction* _action_twitter;
 		QAction* _action_youtube;
+		QAction* _action_trace;
 
 		// About Dialog
 		QAction*   _about_action;
@@ -73,6 +74,7 @@ namespace streamfx::ui {
 		void on_action_discord(bool);
 		void on_action_twitter(bool);
 		void on_action_youtube(bool);
+		void on_action_trace(bool);
 
 		// About
 		void on_action_about(bool);
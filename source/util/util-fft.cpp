@@ -0,0 +1,210 @@
+// Copyright (c) 2021 Michael Fabian Dirks <info@xaymar.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "util-fft.hpp"
+#include <cmath>
+#include <stdexcept>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define ST_ARCH_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#elif defined(_M_ARM64) || defined(__aarch64__) || defined(__ARM_NEON)
+#define ST_ARCH_NEON
+#include <arm_neon.h>
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define ST_TARGET(x) __attribute__((target(x)))
+#else
+#define ST_TARGET(x)
+#endif
+
+// Combines `count` pairs of elements (a, b) with their twiddle factors (w) into (a + b * w, a - b * w), with real and
+// imaginary parts stored in separate arrays.
+typedef void (*butterfly_t)(float* a_re, float* a_im, float* b_re, float* b_im, const float* w_re, const float* w_im,
+							std::size_t count);
+
+static void butterfly_generic(float* a_re, float* a_im, float* b_re, float* b_im, const float* w_re,
+							  const float* w_im, std::size_t count)
+{
+	for (std::size_t idx = 0; idx < count; idx++) {
+		float t_re = b_re[idx] * w_re[idx] - b_im[idx] * w_im[idx];
+		float t_im = b_re[idx] * w_im[idx] + b_im[idx] * w_re[idx];
+		b_re[idx]  = a_re[idx] - t_re;
+		b_im[idx]  = a_im[idx] - t_im;
+		a_re[idx] += t_re;
+		a_im[idx] += t_im;
+	}
+}
+
+#ifdef ST_ARCH_X86
+ST_TARGET("sse")
+static void butterfly_sse(float* a_re, float* a_im, float* b_re, float* b_im, const float* w_re, const float* w_im,
+						  std::size_t count)
+{
+	std::size_t idx = 0;
+	for (; (idx + 4) <= count; idx += 4) {
+		__m128 ar = _mm_loadu_ps(a_re + idx);
+		__m128 ai = _mm_loadu_ps(a_im + idx);
+		__m128 br = _mm_loadu_ps(b_re + idx);
+		__m128 bi = _mm_loadu_ps(b_im + idx);
+		__m128 wr = _mm_loadu_ps(w_re + idx);
+		__m128 wi = _mm_loadu_ps(w_im + idx);
+
+		__m128 tr = _mm_sub_ps(_mm_mul_ps(br, wr), _mm_mul_ps(bi, wi));
+		__m128 ti = _mm_add_ps(_mm_mul_ps(br, wi), _mm_mul_ps(bi, wr));
+
+		_mm_storeu_ps(b_re + idx, _mm_sub_ps(ar, tr));
+		_mm_storeu_ps(b_im + idx, _mm_sub_ps(ai, ti));
+		_mm_storeu_ps(a_re + idx, _mm_add_ps(ar, tr));
+		_mm_storeu_ps(a_im + idx, _mm_add_ps(ai, ti));
+	}
+
+	butterfly_generic(a_re + idx, a_im + idx, b_re + idx, b_im + idx, w_re + idx, w_im + idx, count - idx);
+}
+
+static bool has_sse()
+{
+#ifdef _MSC_VER
+	int info[4];
+	__cpuid(info, 1);
+	return (info[3] & (1 << 25)) != 0;
+#else
+	return __builtin_cpu_supports("sse");
+#endif
+}
+#endif
+
+#ifdef ST_ARCH_NEON
+static void butterfly_neon(float* a_re, float* a_im, float* b_re, float* b_im, const float* w_re, const float* w_im,
+						   std::size_t count)
+{
+	std::size_t idx = 0;
+	for (; (idx + 4) <= count; idx += 4) {
+		float32x4_t ar = vld1q_f32(a_re + idx);
+		float32x4_t ai = vld1q_f32(a_im + idx);
+		float32x4_t br = vld1q_f32(b_re + idx);
+		float32x4_t bi = vld1q_f32(b_im + idx);
+		float32x4_t wr = vld1q_f32(w_re + idx);
+		float32x4_t wi = vld1q_f32(w_im + idx);
+
+		float32x4_t tr = vmlsq_f32(vmulq_f32(br, wr), bi, wi);
+		float32x4_t ti = vmlaq_f32(vmulq_f32(br, wi), bi, wr);
+
+		vst1q_f32(b_re + idx, vsubq_f32(ar, tr));
+		vst1q_f32(b_im + idx, vsubq_f32(ai, ti));
+		vst1q_f32(a_re + idx, vaddq_f32(ar, tr));
+		vst1q_f32(a_im + idx, vaddq_f32(ai, ti));
+	}
+
+	butterfly_generic(a_re + idx, a_im + idx, b_re + idx, b_im + idx, w_re + idx, w_im + idx, count - idx);
+}
+#endif
+
+struct butterfly_implementation {
+	const char* name;
+	butterfly_t function;
+};
+
+static const butterfly_implementation& get_implementation()
+{
+	static const butterfly_implementation impl = []() {
+#ifdef ST_ARCH_X86
+		if (has_sse())
+			return butterfly_implementation{"SSE", butterfly_sse};
+#endif
+#ifdef ST_ARCH_NEON
+		return butterfly_implementation{"NEON", butterfly_neon};
+#endif
+		return butterfly_implementation{"Generic", butterfly_generic};
+	}();
+	return impl;
+}
+
+streamfx::util::fft::fft(std::size_t size)
+	: _size(size), _window(size), _reverse(size), _twiddle_re(size), _twiddle_im(size), _re(size), _im(size),
+	  _scale(0)
+{
+	if ((size < 4) || (size > 65536) || ((size & (size - 1)) != 0)) {
+		throw std::invalid_argument("FFT size must be a power of two between 4 and 65536.");
+	}
+
+	// Hann window, scaled so that a full scale sine wave peaks at 1.0.
+	double sum = 0;
+	for (std::size_t idx = 0; idx < _size; idx++) {
+		double w = 0.5 - 0.5 * cos(2. * 3.14159265358979323846 * static_cast<double>(idx) / static_cast<double>(_size));
+		_window[idx] = static_cast<float>(w);
+		sum += w;
+	}
+	_scale = static_cast<float>(2. / sum);
+
+	// Bit-reversed order of the input.
+	std::size_t bits = 0;
+	while ((std::size_t{1} << bits) < _size)
+		bits++;
+	for (std::size_t idx = 0; idx < _size; idx++) {
+		uint32_t rev = 0;
+		for (std::size_t bit = 0; bit < bits; bit++) {
+			rev |= static_cast<uint32_t>((idx >> bit) & 1) << (bits - 1 - bit);
+		}
+		_reverse[idx] = rev;
+	}
+
+	// Twiddle factors of the stage that combines halves of size `half` are stored at [half, half * 2).
+	for (std::size_t half = 1; half < _size; half <<= 1) {
+		for (std::size_t idx = 0; idx < half; idx++) {
+			double angle            = -3.14159265358979323846 * static_cast<double>(idx) / static_cast<double>(half);
+			_twiddle_re[half + idx] = static_cast<float>(cos(angle));
+			_twiddle_im[half + idx] = static_cast<float>(sin(angle));
+		}
+	}
+}
+
+void streamfx::util::fft::transform(const float* samples, float* magnitudes)
+{
+	butterfly_t butterfly = get_implementation().function;
+
+	for (std::size_t idx = 0; idx < _size; idx++) {
+		std::size_t rev = _reverse[idx];
+		_re[rev]        = samples[idx] * _window[idx];
+		_im[rev]        = 0;
+	}
+
+	for (std::size_t half = 1; half < _size; half <<= 1) {
+		// Narrow stages have too few butterflies per group to fill a vector.
+		butterfly_t fn = (half < 4) ? butterfly_generic : butterfly;
+		for (std::size_t group = 0; group < _size; group += half * 2) {
+			fn(&_re[group], &_im[group], &_re[group + half], &_im[group + half], &_twiddle_re[half],
+			   &_twiddle_im[half], half);
+		}
+	}
+
+	for (std::size_t idx = 0, edx = _size / 2; idx < edx; idx++) {
+		magnitudes[idx] = std::sqrt(_re[idx] * _re[idx] + _im[idx] * _im[idx]) * _scale;
+	}
+}
+
+const char* streamfx::util::fft::implementation()
+{
+	return get_implementation().name;
+}
@@ -0,0 +1,61 @@
+// Copyright (c) 2021 Michael Fabian Dirks <info@xaymar.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace streamfx::util {
+	/** Windowed FFT of real-valued samples, for spectrum analysis.
+	 *
+	 * All tables are built once on construction, so that transforming a block of samples doesn't allocate. Uses SSE or
+	 * NEON for the butterflies where the CPU has it. Not thread-safe, use one instance per thread.
+	 */
+	class fft {
+		std::size_t           _size;
+		std::vector<float>    _window;
+		std::vector<uint32_t> _reverse;
+		std::vector<float>    _twiddle_re;
+		std::vector<float>    _twiddle_im;
+		std::vector<float>    _re;
+		std::vector<float>    _im;
+		float                 _scale;
+
+		public:
+		/** @param size Number of samples per transform, must be a power of two between 4 and 65536. */
+		fft(std::size_t size);
+
+		inline std::size_t size() const
+		{
+			return _size;
+		}
+
+		/** Apply a Hann window to `size()` samples and transform them.
+		 *
+		 * @param samples Input samples.
+		 * @param magnitudes Receives `size() / 2` magnitudes, where a full scale sine wave results in about 1.0.
+		 */
+		void transform(const float* samples, float* magnitudes);
+
+		/** Name of the butterfly implementation selected for this CPU. */
+		static const char* implementation();
+	};
+} // namespace streamfx::util
@@ -0,0 +1,349 @@
+// Copyright (c) 2021 Michael Fabian Dirks <info@xaymar.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "util-file-watcher.hpp"
+#include "util/util-logging.hpp"
+
+#ifdef D_PLATFORM_LINUX
+#include <cerrno>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <sys/vfs.h>
+#include <unistd.h>
+#endif
+
+#ifdef _DEBUG
+#define ST_PREFIX "<%s> "
+#define D_LOG_ERROR(x, ...) P_LOG_ERROR(ST_PREFIX##x, __FUNCTION_SIG__, __VA_ARGS__)
+#define D_LOG_WARNING(x, ...) P_LOG_WARN(ST_PREFIX##x, __FUNCTION_SIG__, __VA_ARGS__)
+#define D_LOG_INFO(x, ...) P_LOG_INFO(ST_PREFIX##x, __FUNCTION_SIG__, __VA_ARGS__)
+#define D_LOG_DEBUG(x, ...) P_LOG_DEBUG(ST_PREFIX##x, __FUNCTION_SIG__, __VA_ARGS__)
+#else
+#define ST_PREFIX "<util::file_watcher> "
+#define D_LOG_ERROR(...) P_LOG_ERROR(ST_PREFIX __VA_ARGS__)
+#define D_LOG_WARNING(...) P_LOG_WARN(ST_PREFIX __VA_ARGS__)
+#define D_LOG_INFO(...) P_LOG_INFO(ST_PREFIX __VA_ARGS__)
+#define D_LOG_DEBUG(...) P_LOG_DEBUG(ST_PREFIX __VA_ARGS__)
+#endif
+
+// How long a file has to be quiet before a change is reported.
+#define ST_DEBOUNCE std::chrono::milliseconds(250)
+
+// How often files that can't be watched by the system are checked.
+#define ST_POLL_INTERVAL std::chrono::milliseconds(333)
+
+// How often the thread wakes up to report changes, even if nothing happened.
+#define ST_WAKE_INTERVAL std::chrono::milliseconds(50)
+
+#ifdef D_PLATFORM_LINUX
+#define ST_INOTIFY_MASK \
+	(IN_MODIFY | IN_ATTRIB | IN_CLOSE_WRITE | IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO)
+
+// inotify only sees changes made through this machine, which makes it useless for network file systems.
+static bool is_remote_file_system(std::filesystem::path const& path)
+{
+	struct statfs info;
+	if (statfs(path.c_str(), &info) != 0) {
+		return true;
+	}
+
+	switch (static_cast<uint32_t>(info.f_type)) {
+	case 0x6969:     // NFS
+	case 0x517B:     // SMB
+	case 0xFF534D42: // CIFS
+	case 0xFE534D42: // SMB2
+	case 0x65735546: // FUSE (sshfs, rclone, ...)
+	case 0x01021997: // 9P (Virtual Machine shares)
+	case 0x00C36400: // Ceph
+	case 0x47504653: // GPFS
+		return true;
+	default:
+		return false;
+	}
+}
+#endif
+
+streamfx::util::file_watcher::subscription::subscription(std::shared_ptr<streamfx::util::file_watcher> parent,
+														 std::shared_ptr<entry>                        entry)
+	: _parent(parent), _entry(entry), _generation(entry->generation.load())
+{}
+
+streamfx::util::file_watcher::subscription::~subscription()
+{
+	// Release the entry while the parent is guaranteed to still exist.
+	std::unique_lock<std::mutex> lock(_parent->_lock);
+	_entry.reset();
+}
+
+std::filesystem::path const& streamfx::util::file_watcher::subscription::path()
+{
+	return _entry->path;
+}
+
+bool streamfx::util::file_watcher::subscription::changed()
+{
+	uint64_t generation = _entry->generation.load(std::memory_order_acquire);
+	if (generation != _generation) {
+		_generation = generation;
+		return true;
+	}
+	return false;
+}
+
+streamfx::util::file_watcher::file_watcher() : _entries(), _last_poll(), _stop(false)
+{
+#ifdef D_PLATFORM_LINUX
+	_inotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if (_inotify < 0) {
+		D_LOG_WARNING("inotify is unavailable (error %d), falling back to polling.", errno);
+	}
+#endif
+
+	_thread = std::thread(std::bind(&streamfx::util::file_watcher::work, this));
+}
+
+streamfx::util::file_watcher::~file_watcher()
+{
+	{
+		std::unique_lock<std::mutex> lock(_lock);
+		_stop = true;
+	}
+	_cv.notify_all();
+	if (_thread.joinable()) {
+		_thread.join();
+	}
+
+#ifdef D_PLATFORM_LINUX
+	if (_inotify >= 0) {
+		close(_inotify);
+	}
+#endif
+}
+
+std::shared_ptr<streamfx::util::file_watcher::subscription>
+	streamfx::util::file_watcher::subscribe(std::filesystem::path const& file)
+{
+	std::error_code       ec;
+	std::filesystem::path path = std::filesystem::absolute(file, ec).lexically_normal();
+	if (ec) {
+		path = file.lexically_normal();
+	}
+
+	std::unique_lock<std::mutex> lock(_lock);
+
+	// Share the entry with everyone else watching the same file.
+	if (auto kv = _entries.find(path); kv != _entries.end()) {
+		if (auto ptr = kv->second.lock(); ptr) {
+			return std::make_shared<subscription>(shared_from_this(), ptr);
+		}
+	}
+
+	auto ptr        = std::make_shared<entry>();
+	ptr->path       = path;
+	ptr->polled     = true;
+	ptr->time       = std::filesystem::last_write_time(path, ec);
+	ptr->size       = std::filesystem::file_size(path, ec);
+	ptr->pending    = false;
+	ptr->generation = 0;
+
+#ifdef D_PLATFORM_LINUX
+	// Watch the directory instead of the file, as many editors save by replacing the file.
+	if (_inotify >= 0) {
+		auto directory = path.parent_path();
+		if (_directories.count(directory) != 0) {
+			ptr->polled = false;
+		} else if (!is_remote_file_system(directory)) {
+			int wd = inotify_add_watch(_inotify, directory.c_str(), ST_INOTIFY_MASK);
+			if (wd >= 0) {
+				_directories.emplace(directory, wd);
+				ptr->polled = false;
+			} else {
+				D_LOG_DEBUG("Failed to watch '%s' (error %d), falling back to polling.", directory.c_str(), errno);
+			}
+		}
+	}
+#endif
+
+	_entries.insert_or_assign(path, ptr);
+	return std::make_shared<subscription>(shared_from_this(), ptr);
+}
+
+void streamfx::util::file_watcher::work()
+{
+	while (true) {
+#ifdef D_PLATFORM_LINUX
+		if (_inotify >= 0) {
+			pollfd pfd = {_inotify, POLLIN, 0};
+			::poll(&pfd, 1, static_cast<int>(ST_WAKE_INTERVAL.count()));
+		}
+#endif
+
+		std::unique_lock<std::mutex> lock(_lock);
+#ifdef D_PLATFORM_LINUX
+		if (_inotify < 0)
+#endif
+		{
+			_cv.wait_for(lock, ST_WAKE_INTERVAL, [this]() { return _stop; });
+		}
+		if (_stop) {
+			break;
+		}
+
+		auto now = std::chrono::steady_clock::now();
+		read_events(now);
+		if ((now - _last_poll) >= ST_POLL_INTERVAL) {
+			_last_poll = now;
+			sweep();
+			poll(now);
+		}
+
+		// Report all changes that have settled.
+		for (auto& kv : _entries) {
+			if (auto ptr = kv.second.lock(); ptr && ptr->pending && (now >= ptr->deadline)) {
+				ptr->pending = false;
+				ptr->generation.fetch_add(1, std::memory_order_release);
+			}
+		}
+	}
+}
+
+void streamfx::util::file_watcher::read_events(std::chrono::steady_clock::time_point now)
+{
+#ifdef D_PLATFORM_LINUX
+	if (_inotify < 0) {
+		return;
+	}
+
+	alignas(inotify_event) char buffer[4096];
+	while (true) {
+		ssize_t length = read(_inotify, buffer, sizeof(buffer));
+		if (length <= 0) {
+			break;
+		}
+
+		for (char* ptr = buffer; ptr < buffer + length;) {
+			auto event = reinterpret_cast<inotify_event*>(ptr);
+			ptr += sizeof(inotify_event) + event->len;
+
+			if ((event->mask & IN_Q_OVERFLOW) != 0) {
+				// Events were lost, so treat every file as changed.
+				for (auto& kv : _entries) {
+					if (auto entry = kv.second.lock(); entry) {
+						entry->pending  = true;
+						entry->deadline = now + ST_DEBOUNCE;
+					}
+				}
+				continue;
+			}
+
+			auto directory = std::find_if(_directories.begin(), _directories.end(),
+										  [event](auto const& kv) { return kv.second == event->wd; });
+			if (directory == _directories.end()) {
+				continue;
+			}
+
+			if ((event->mask & IN_IGNORED) != 0) {
+				// The directory is gone, so everything in it has to be polled from now on.
+				for (auto& kv : _entries) {
+					if (auto entry = kv.second.lock(); entry && (entry->path.parent_path() == directory->first)) {
+						entry->polled = true;
+					}
+				}
+				_directories.erase(directory);
+				continue;
+			}
+
+			if (event->len == 0) {
+				continue;
+			}
+
+			auto kv = _entries.find(directory->first / event->name);
+			if (kv == _entries.end()) {
+				continue;
+			}
+			if (auto entry = kv->second.lock(); entry) {
+				entry->pending  = true;
+				entry->deadline = now + ST_DEBOUNCE;
+			}
+		}
+	}
+#else
+	(void)now;
+#endif
+}
+
+void streamfx::util::file_watcher::poll(std::chrono::steady_clock::time_point now)
+{
+	for (auto& kv : _entries) {
+		auto entry = kv.second.lock();
+		if (!entry || !entry->polled) {
+			continue;
+		}
+
+		std::error_code ec;
+		auto            time = std::filesystem::last_write_time(entry->path, ec);
+		auto            size = std::filesystem::file_size(entry->path, ec);
+		if ((time != entry->time) || (size != entry->size)) {
+			entry->time     = time;
+			entry->size     = size;
+			entry->pending  = true;
+			entry->deadline = now + ST_DEBOUNCE;
+		}
+	}
+}
+
+void streamfx::util::file_watcher::sweep()
+{
+	for (auto kv = _entries.begin(); kv != _entries.end();) {
+		if (kv->second.expired()) {
+			kv = _entries.erase(kv);
+		} else {
+			kv++;
+		}
+	}
+
+#ifdef D_PLATFORM_LINUX
+	// Stop watching directories that no longer contain any watched files.
+	for (auto directory = _directories.begin(); directory != _directories.end();) {
+		bool used = std::any_of(_entries.begin(), _entries.end(),
+								[&directory](auto const& kv) { return kv.first.parent_path() == directory->first; });
+		if (!used) {
+			inotify_rm_watch(_inotify, directory->second);
+			directory = _directories.erase(directory);
+		} else {
+			directory++;
+		}
+	}
+#endif
+}
+
+std::shared_ptr<streamfx::util::file_watcher> streamfx::util::file_watcher::get()
+{
+	static std::weak_ptr<streamfx::util::file_watcher> instance;
+	static std::mutex                                  lock;
+
+	std::unique_lock<std::mutex> ul(lock);
+	if (instance.expired()) {
+		auto hard_instance = std::shared_ptr<streamfx::util::file_watcher>(new file_watcher());
+		instance           = hard_instance;
+		return hard_instance;
+	}
+	return instance.lock();
+}
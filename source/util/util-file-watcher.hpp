@@ -0,0 +1,101 @@
+// Copyright (c) 2021 Michael Fabian Dirks <info@xaymar.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+#include "common.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace streamfx::util {
+	/** Watches files for changes on a single thread shared by the whole process.
+	 *
+	 * Uses inotify on Linux, and falls back to checking the modification time and size a few times per second on
+	 * other platforms, and on file systems where inotify does not see changes made by other machines. Every path is
+	 * watched only once, no matter how many subscriptions exist for it. A change is only reported after the file has
+	 * been quiet for a moment, so an editor saving in several steps results in a single change.
+	 */
+	class file_watcher : public std::enable_shared_from_this<streamfx::util::file_watcher> {
+		struct entry {
+			std::filesystem::path                 path;
+			bool                                  polled;
+			std::filesystem::file_time_type       time;
+			uintmax_t                             size;
+			bool                                  pending;
+			std::chrono::steady_clock::time_point deadline;
+			std::atomic<uint64_t>                 generation;
+		};
+
+		public:
+		class subscription {
+			std::shared_ptr<streamfx::util::file_watcher> _parent;
+			std::shared_ptr<entry>                        _entry;
+			uint64_t                                      _generation;
+
+			public:
+			subscription(std::shared_ptr<streamfx::util::file_watcher> parent, std::shared_ptr<entry> entry);
+			~subscription();
+
+			std::filesystem::path const& path();
+
+			/** Check if the file changed since the last call. Cheap enough to call every frame. */
+			bool changed();
+		};
+
+		private:
+		std::mutex                                              _lock;
+		std::condition_variable                                 _cv;
+		std::map<std::filesystem::path, std::weak_ptr<entry>> _entries;
+		std::chrono::steady_clock::time_point                   _last_poll;
+		bool                                                    _stop;
+		std::thread                                             _thread;
+
+#ifdef D_PLATFORM_LINUX
+		int                                  _inotify;
+		std::map<std::filesystem::path, int> _directories;
+#endif
+
+		private:
+		file_watcher();
+
+		public:
+		~file_watcher();
+
+		/** Start watching a file. The file does not need to exist yet. */
+		std::shared_ptr<streamfx::util::file_watcher::subscription> subscribe(std::filesystem::path const& file);
+
+		private:
+		void work();
+
+		void read_events(std::chrono::steady_clock::time_point now);
+
+		void poll(std::chrono::steady_clock::time_point now);
+
+		void sweep();
+
+		public:
+		static std::shared_ptr<streamfx::util::file_watcher> get();
+	};
+} // namespace streamfx::util
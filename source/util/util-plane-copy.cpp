@@ -0,0 +1,235 @@
+// Copyright (c) 2021 Michael Fabian Dirks <info@xaymar.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "util-plane-copy.hpp"
+#include <algorithm>
+#include <cstring>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define ST_ARCH_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#elif defined(_M_ARM64) || defined(__aarch64__) || defined(__ARM_NEON)
+#define ST_ARCH_NEON
+#include <arm_neon.h>
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define ST_TARGET(x) __attribute__((target(x)))
+#else
+#define ST_TARGET(x)
+#endif
+
+// Planes at least this large are written with non-temporal stores, as they would only evict everything else from the
+// cache without ever being read back from it.
+#define ST_NONTEMPORAL_THRESHOLD (4 * 1024 * 1024)
+
+typedef void (*copy_row_t)(uint8_t* dst, const uint8_t* src, std::size_t bytes, bool streaming);
+
+static void copy_row_generic(uint8_t* dst, const uint8_t* src, std::size_t bytes, bool)
+{
+	std::memcpy(dst, src, bytes);
+}
+
+#ifdef ST_ARCH_X86
+ST_TARGET("sse2")
+static void copy_row_sse2(uint8_t* dst, const uint8_t* src, std::size_t bytes, bool streaming)
+{
+	// Align the destination, aligned (and streaming) stores require it.
+	std::size_t head = std::min<std::size_t>((16 - (reinterpret_cast<uintptr_t>(dst) & 15)) & 15, bytes);
+	std::memcpy(dst, src, head);
+	dst += head;
+	src += head;
+	bytes -= head;
+
+	std::size_t blocks = bytes / 64;
+	if (streaming) {
+		for (; blocks > 0; blocks--, dst += 64, src += 64) {
+			__m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+			__m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 16));
+			__m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 32));
+			__m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 48));
+			_mm_stream_si128(reinterpret_cast<__m128i*>(dst), a);
+			_mm_stream_si128(reinterpret_cast<__m128i*>(dst + 16), b);
+			_mm_stream_si128(reinterpret_cast<__m128i*>(dst + 32), c);
+			_mm_stream_si128(reinterpret_cast<__m128i*>(dst + 48), d);
+		}
+	} else {
+		for (; blocks > 0; blocks--, dst += 64, src += 64) {
+			__m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+			__m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 16));
+			__m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 32));
+			__m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 48));
+			_mm_store_si128(reinterpret_cast<__m128i*>(dst), a);
+			_mm_store_si128(reinterpret_cast<__m128i*>(dst + 16), b);
+			_mm_store_si128(reinterpret_cast<__m128i*>(dst + 32), c);
+			_mm_store_si128(reinterpret_cast<__m128i*>(dst + 48), d);
+		}
+	}
+
+	std::memcpy(dst, src, bytes & 63);
+}
+
+ST_TARGET("avx2")
+static void copy_row_avx2(uint8_t* dst, const uint8_t* src, std::size_t bytes, bool streaming)
+{
+	// Align the destination, aligned (and streaming) stores require it.
+	std::size_t head = std::min<std::size_t>((32 - (reinterpret_cast<uintptr_t>(dst) & 31)) & 31, bytes);
+	std::memcpy(dst, src, head);
+	dst += head;
+	src += head;
+	bytes -= head;
+
+	std::size_t blocks = bytes / 128;
+	if (streaming) {
+		for (; blocks > 0; blocks--, dst += 128, src += 128) {
+			__m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src));
+			__m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + 32));
+			__m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + 64));
+			__m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + 96));
+			_mm256_stream_si256(reinterpret_cast<__m256i*>(dst), a);
+			_mm256_stream_si256(reinterpret_cast<__m256i*>(dst + 32), b);
+			_mm256_stream_si256(reinterpret_cast<__m256i*>(dst + 64), c);
+			_mm256_stream_si256(reinterpret_cast<__m256i*>(dst + 96), d);
+		}
+	} else {
+		for (; blocks > 0; blocks--, dst += 128, src += 128) {
+			__m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src));
+			__m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + 32));
+			__m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + 64));
+			__m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + 96));
+			_mm256_store_si256(reinterpret_cast<__m256i*>(dst), a);
+			_mm256_store_si256(reinterpret_cast<__m256i*>(dst + 32), b);
+			_mm256_store_si256(reinterpret_cast<__m256i*>(dst + 64), c);
+			_mm256_store_si256(reinterpret_cast<__m256i*>(dst + 96), d);
+		}
+	}
+
+	std::memcpy(dst, src, bytes & 127);
+}
+
+static bool has_sse2()
+{
+#ifdef _MSC_VER
+	int info[4];
+	__cpuid(info, 1);
+	return (info[3] & (1 << 26)) != 0;
+#else
+	return __builtin_cpu_supports("sse2");
+#endif
+}
+
+static bool has_avx2()
+{
+#ifdef _MSC_VER
+	int info[4];
+	__cpuid(info, 0);
+	if (info[0] < 7)
+		return false;
+
+	// The OS must save the YMM registers for us, otherwise AVX is unusable.
+	__cpuid(info, 1);
+	bool has_osxsave = (info[2] & (1 << 27)) != 0;
+	bool has_avx     = (info[2] & (1 << 28)) != 0;
+	if (!has_osxsave || !has_avx || ((_xgetbv(0) & 0x6) != 0x6))
+		return false;
+
+	__cpuidex(info, 7, 0);
+	return (info[1] & (1 << 5)) != 0;
+#else
+	return __builtin_cpu_supports("avx2");
+#endif
+}
+#endif
+
+#ifdef ST_ARCH_NEON
+static void copy_row_neon(uint8_t* dst, const uint8_t* src, std::size_t bytes, bool)
+{
+	// NEON has no non-temporal store intrinsics, so streaming is ignored here.
+	std::size_t blocks = bytes / 64;
+	for (; blocks > 0; blocks--, dst += 64, src += 64) {
+		uint8x16_t a = vld1q_u8(src);
+		uint8x16_t b = vld1q_u8(src + 16);
+		uint8x16_t c = vld1q_u8(src + 32);
+		uint8x16_t d = vld1q_u8(src + 48);
+		vst1q_u8(dst, a);
+		vst1q_u8(dst + 16, b);
+		vst1q_u8(dst + 32, c);
+		vst1q_u8(dst + 48, d);
+	}
+
+	std::memcpy(dst, src, bytes & 63);
+}
+#endif
+
+struct copy_implementation {
+	const char* name;
+	copy_row_t  function;
+};
+
+static const copy_implementation& get_implementation()
+{
+	static const copy_implementation impl = []() {
+#ifdef ST_ARCH_X86
+		if (has_avx2())
+			return copy_implementation{"AVX2", copy_row_avx2};
+		if (has_sse2())
+			return copy_implementation{"SSE2", copy_row_sse2};
+#endif
+#ifdef ST_ARCH_NEON
+		return copy_implementation{"NEON", copy_row_neon};
+#endif
+		return copy_implementation{"Generic", copy_row_generic};
+	}();
+	return impl;
+}
+
+void streamfx::util::copy_plane(uint8_t* dst, std::size_t dst_pitch, const uint8_t* src, std::size_t src_pitch,
+								std::size_t width, std::size_t height)
+{
+	if ((width == 0) || (height == 0))
+		return;
+
+	const copy_implementation& impl = get_implementation();
+
+	// Identical pitches mean the plane is one contiguous block, so copy it as a single row.
+	if (dst_pitch == src_pitch) {
+		width  = dst_pitch * (height - 1) + width;
+		height = 1;
+	}
+
+	bool streaming = (width * height) >= ST_NONTEMPORAL_THRESHOLD;
+	for (std::size_t y = 0; y < height; y++, dst += dst_pitch, src += src_pitch) {
+		impl.function(dst, src, width, streaming);
+	}
+
+#ifdef ST_ARCH_X86
+	// Non-temporal stores are weakly ordered, make them visible before anyone else reads the plane.
+	if (streaming && (impl.function != copy_row_generic))
+		_mm_sfence();
+#endif
+}
+
+const char* streamfx::util::copy_plane_implementation()
+{
+	return get_implementation().name;
+}
@@ -0,0 +1,43 @@
+// Copyright (c) 2021 Michael Fabian Dirks <info@xaymar.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+namespace streamfx::util {
+	/** Copy a two-dimensional plane between buffers with (possibly) different pitches.
+	 *
+	 * Uses the fastest row copy available on the current CPU (SSE2, AVX2 or NEON), and switches to non-temporal
+	 * stores for planes that are too large to benefit from staying in the cache.
+	 *
+	 * @param dst Destination plane.
+	 * @param dst_pitch Distance in bytes between the start of two rows in the destination.
+	 * @param src Source plane.
+	 * @param src_pitch Distance in bytes between the start of two rows in the source.
+	 * @param width Number of bytes to copy per row.
+	 * @param height Number of rows to copy.
+	 */
+	void copy_plane(uint8_t* dst, std::size_t dst_pitch, const uint8_t* src, std::size_t src_pitch,
+					std::size_t width, std::size_t height);
+
+	/** Name of the row copy implementation selected for this CPU. */
+	const char* copy_plane_implementation();
+} // namespace streamfx::util
@@ -18,136 +18,181 @@
  */
 
 #include "util-profiler.hpp"
-#include <iterator>
+#include <map>
+#include <mutex>
 
-streamfx::util::profiler::profiler() {}
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
 
-streamfx::util::profiler::~profiler() {}
+namespace {
+	struct registry {
+		std::mutex                                                        lock;
+		std::map<std::string, std::shared_ptr<streamfx::util::profiler>> profilers;
+	};
+
+	registry& get_registry()
+	{
+		static registry instance;
+		return instance;
+	}
+} // namespace
 
-std::shared_ptr<streamfx::util::profiler::instance> streamfx::util::profiler::track()
+// Index of the highest set bit, value must not be zero.
+static inline std::size_t highest_bit(uint64_t value)
 {
-	return std::make_shared<streamfx::util::profiler::instance>(shared_from_this());
+#ifdef _MSC_VER
+	unsigned long index;
+	_BitScanReverse64(&index, value);
+	return static_cast<size_t>(index);
+#else
+	return static_cast<size_t>(63 - __builtin_clzll(value));
+#endif
 }
 
-void streamfx::util::profiler::track(std::chrono::nanoseconds duration)
+streamfx::util::profiler::profiler()
+	: _buckets(), _count(0), _total(0), _minimum(std::numeric_limits<uint64_t>::max()), _maximum(0)
 {
-	std::unique_lock<std::mutex> ul(_timings_lock);
-	auto                         itr = _timings.find(duration);
-	if (itr == _timings.end()) {
-		_timings.emplace(duration, 1u);
-	} else {
-		itr->second++;
+	for (auto& bucket : _buckets) {
+		bucket.store(0, std::memory_order_relaxed);
 	}
 }
 
-uint64_t streamfx::util::profiler::count()
+streamfx::util::profiler::~profiler() {}
+
+streamfx::util::profiler::instance streamfx::util::profiler::track()
 {
-	uint64_t count = 0;
+	return streamfx::util::profiler::instance(shared_from_this());
+}
 
-	std::map<std::chrono::nanoseconds, size_t> copy_timings;
-	{
-		std::unique_lock<std::mutex> ul(_timings_lock);
-		copy(_timings.begin(), _timings.end(), std::inserter(copy_timings, copy_timings.end()));
-	}
+void streamfx::util::profiler::track(std::chrono::nanoseconds duration)
+{
+	uint64_t value = static_cast<uint64_t>(std::max<int64_t>(duration.count(), 0));
+
+	_buckets[value_to_bucket(value)].fetch_add(1, std::memory_order_relaxed);
+	_count.fetch_add(1, std::memory_order_relaxed);
+	_total.fetch_add(value, std::memory_order_relaxed);
 
-	for (auto kv : copy_timings) {
-		count += kv.second;
+	for (uint64_t minimum = _minimum.load(std::memory_order_relaxed);
+		 (value < minimum) && !_minimum.compare_exchange_weak(minimum, value, std::memory_order_relaxed);) {
+	}
+	for (uint64_t maximum = _maximum.load(std::memory_order_relaxed);
+		 (value > maximum) && !_maximum.compare_exchange_weak(maximum, value, std::memory_order_relaxed);) {
 	}
+}
 
-	return count;
+uint64_t streamfx::util::profiler::count()
+{
+	return _count.load(std::memory_order_relaxed);
 }
 
 std::chrono::nanoseconds streamfx::util::profiler::total_duration()
 {
-	std::chrono::nanoseconds duration{0};
+	return std::chrono::nanoseconds(static_cast<int64_t>(_total.load(std::memory_order_relaxed)));
+}
 
-	std::map<std::chrono::nanoseconds, size_t> copy_timings;
-	{
-		std::unique_lock<std::mutex> ul(_timings_lock);
-		copy(_timings.begin(), _timings.end(), std::inserter(copy_timings, copy_timings.end()));
+double_t streamfx::util::profiler::average_duration()
+{
+	return double_t(_total.load(std::memory_order_relaxed)) / double_t(_count.load(std::memory_order_relaxed));
+}
+
+std::chrono::nanoseconds streamfx::util::profiler::percentile(double_t percentile, bool by_time)
+{
+	uint64_t calls = count();
+	if (calls == 0) {
+		return std::chrono::nanoseconds(-1);
 	}
 
-	for (auto kv : copy_timings) {
-		duration += kv.first * kv.second;
+	if (by_time) { // Return by time percentile.
+		// Find the first recorded value at or above the given point between the smallest and largest time.
+		uint64_t smallest  = _minimum.load(std::memory_order_relaxed);
+		uint64_t largest   = _maximum.load(std::memory_order_relaxed);
+		uint64_t threshold = smallest + static_cast<uint64_t>(double_t(largest - smallest) * percentile);
+
+		for (std::size_t idx = value_to_bucket(threshold); idx < bucket_count; idx++) {
+			if (_buckets[idx].load(std::memory_order_relaxed) > 0) {
+				return std::chrono::nanoseconds(
+					static_cast<int64_t>(std::clamp(bucket_to_value(idx), smallest, largest)));
+			}
+		}
+	} else { // Return by call percentile.
+		// Find the bucket which contains the call at the given percentile.
+		uint64_t target = static_cast<uint64_t>(std::ceil(double_t(calls) * percentile));
+		uint64_t accu   = 0;
+		for (std::size_t idx = 0; idx < bucket_count; idx++) {
+			uint64_t calls_in_bucket = _buckets[idx].load(std::memory_order_relaxed);
+			if (calls_in_bucket == 0) {
+				continue;
+			}
+
+			accu += calls_in_bucket;
+			if (accu >= target) {
+				return std::chrono::nanoseconds(static_cast<int64_t>(
+					std::clamp(bucket_to_value(idx), _minimum.load(std::memory_order_relaxed),
+							   _maximum.load(std::memory_order_relaxed))));
+			}
+		}
 	}
 
-	return duration;
+	return std::chrono::nanoseconds(-1);
 }
 
-double_t streamfx::util::profiler::average_duration()
+std::size_t streamfx::util::profiler::value_to_bucket(uint64_t value)
 {
-	std::chrono::nanoseconds duration{0};
-	uint64_t                 count = 0;
-
-	std::map<std::chrono::nanoseconds, size_t> copy_timings;
-	{
-		std::unique_lock<std::mutex> ul(_timings_lock);
-		copy(_timings.begin(), _timings.end(), std::inserter(copy_timings, copy_timings.end()));
+	// The first two ranges are exact, every following range doubles in width but keeps the same number of buckets.
+	if (value < (sub_bucket_count << 1)) {
+		return static_cast<size_t>(value);
 	}
 
-	for (auto kv : copy_timings) {
-		duration += kv.first * kv.second;
-		count += kv.second;
+	std::size_t shift = highest_bit(value) - sub_bucket_bits;
+	std::size_t index = (shift * sub_bucket_count) + static_cast<size_t>(value >> shift);
+	return std::min(index, bucket_count - 1);
+}
+
+uint64_t streamfx::util::profiler::bucket_to_value(std::size_t bucket)
+{
+	if (bucket < (sub_bucket_count << 1)) {
+		return bucket;
 	}
 
-	return double_t(duration.count()) / double_t(count);
+	// Report the middle of the range covered by the bucket.
+	std::size_t shift = (bucket / sub_bucket_count) - 1;
+	uint64_t    top   = (bucket % sub_bucket_count) + sub_bucket_count;
+	return (top << shift) + ((uint64_t(1) << shift) >> 1);
 }
 
-template<typename T>
-inline bool is_equal(T a, T b, T c)
+void streamfx::util::profiler::publish(std::string const& name, std::shared_ptr<streamfx::util::profiler> profiler)
 {
-	return (a == b) || ((a >= (b - c)) && (a <= (b + c)));
+	auto&                        reg = get_registry();
+	std::unique_lock<std::mutex> lock(reg.lock);
+	reg.profilers.insert_or_assign(name, profiler);
 }
 
-std::chrono::nanoseconds streamfx::util::profiler::percentile(double_t percentile, bool by_time)
+void streamfx::util::profiler::enumerate(
+	std::function<void(std::string const&, std::shared_ptr<streamfx::util::profiler>)> callback)
 {
-	constexpr double_t edge  = 0.00005;
-	uint64_t           calls = count();
-
-	std::map<std::chrono::nanoseconds, size_t> copy_timings;
+	// Copy them out, so that the callback may take its time.
+	std::map<std::string, std::shared_ptr<streamfx::util::profiler>> profilers;
 	{
-		std::unique_lock<std::mutex> ul(_timings_lock);
-		copy(_timings.begin(), _timings.end(), inserter(copy_timings, copy_timings.end()));
+		auto&                        reg = get_registry();
+		std::unique_lock<std::mutex> lock(reg.lock);
+		profilers = reg.profilers;
 	}
-	if (by_time) { // Return by time percentile.
-		// Find largest and smallest time.
-		std::chrono::nanoseconds smallest = copy_timings.begin()->first;
-		std::chrono::nanoseconds largest  = copy_timings.rbegin()->first;
-		std::chrono::nanoseconds variance = largest - smallest;
-
-		for (auto kv : copy_timings) {
-			double_t kv_pct = double_t((kv.first - smallest).count()) / double_t(variance.count());
-			if (is_equal<double_t>(kv_pct, percentile, edge) || (kv_pct > percentile)) {
-				return std::chrono::nanoseconds(kv.first);
-			}
-		}
-	} else { // Return by call percentile.
-		if (percentile == 0.0) {
-			return copy_timings.begin()->first;
-		}
-
-		uint64_t accu_calls_now = 0;
-		for (auto kv : copy_timings) {
-			uint64_t accu_calls_last = accu_calls_now;
-			accu_calls_now += kv.second;
-
-			double_t percentile_last = double_t(accu_calls_last) / double_t(calls);
-			double_t percentile_now  = double_t(accu_calls_now) / double_t(calls);
-
-			if (is_equal<double_t>(percentile, percentile_now, edge)
-				|| ((percentile_last < percentile) && (percentile_now > percentile))) {
-				return std::chrono::nanoseconds(kv.first);
-			}
-		}
+	for (auto& kv : profilers) {
+		callback(kv.first, kv.second);
 	}
-
-	return std::chrono::nanoseconds(-1);
 }
 
 streamfx::util::profiler::instance::instance(std::shared_ptr<streamfx::util::profiler> parent)
 	: _parent(parent), _start(std::chrono::high_resolution_clock::now())
 {}
 
+streamfx::util::profiler::instance::instance(instance&& other) noexcept
+	: _parent(std::move(other._parent)), _start(other._start)
+{
+	other._parent.reset();
+}
+
 streamfx::util::profiler::instance::~instance()
 {
 	auto end = std::chrono::high_resolution_clock::now();
@@ -19,14 +19,32 @@
 
 #pragma once
 #include "common.hpp"
+#include <array>
+#include <atomic>
 #include <chrono>
-#include <map>
-#include <mutex>
+#include <functional>
+#include <string>
 
 namespace streamfx::util {
+	/** Tracks how long something takes.
+	 *
+	 * Durations are recorded into a fixed-size log-linear histogram with atomic buckets, so recording never allocates
+	 * or blocks, and queries take the same time no matter how many samples were recorded. Values are exact up to
+	 * 128ns and within ~1.6% above that.
+	 */
 	class profiler : public std::enable_shared_from_this<streamfx::util::profiler> {
-		std::map<std::chrono::nanoseconds, size_t> _timings;
-		std::mutex                                 _timings_lock;
+		public:
+		static constexpr std::size_t sub_bucket_bits  = 6;
+		static constexpr std::size_t sub_bucket_count = std::size_t(1) << sub_bucket_bits;
+		static constexpr std::size_t max_value_bits   = 36; // ~68 seconds
+		static constexpr std::size_t bucket_count     = (max_value_bits - sub_bucket_bits + 1) * sub_bucket_count;
+
+		private:
+		std::array<std::atomic<uint64_t>, bucket_count> _buckets;
+		std::atomic<uint64_t>                           _count;
+		std::atomic<uint64_t>                           _total;
+		std::atomic<uint64_t>                           _minimum;
+		std::atomic<uint64_t>                           _maximum;
 
 		public:
 		class instance {
@@ -35,6 +53,9 @@ namespace streamfx::util {
 
 			public:
 			instance(std::shared_ptr<profiler> parent);
+			instance(instance&& other) noexcept;
+			instance(const instance&) = delete;
+			instance& operator=(const instance&) = delete;
 
 			~instance();
 
@@ -49,7 +70,7 @@ namespace streamfx::util {
 		public:
 		~profiler();
 
-		std::shared_ptr<class streamfx::util::profiler::instance> track();
+		streamfx::util::profiler::instance track();
 
 		void track(std::chrono::nanoseconds duration);
 
@@ -61,10 +82,23 @@ namespace streamfx::util {
 
 		std::chrono::nanoseconds percentile(double_t percentile, bool by_time = false);
 
+		private:
+		static std::size_t value_to_bucket(uint64_t value);
+
+		static uint64_t bucket_to_value(std::size_t bucket);
+
 		public:
 		static std::shared_ptr<streamfx::util::profiler> create()
 		{
 			return std::shared_ptr<streamfx::util::profiler>{new profiler()};
 		}
+
+		public /* Registry */:
+		/** Keep `profiler` readable under `name` after its owner is gone, replacing whatever was published before. */
+		static void publish(std::string const& name, std::shared_ptr<streamfx::util::profiler> profiler);
+
+		/** Call `callback` for every published profiler, ordered by name. */
+		static void
+			enumerate(std::function<void(std::string const&, std::shared_ptr<streamfx::util::profiler>)> callback);
 	};
 } // namespace streamfx::util
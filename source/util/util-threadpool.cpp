@@ -39,116 +39,262 @@
 // Most Tasks likely wait for IO, so we can use that time for other tasks.
 #define ST_CONCURRENCY_MULTIPLIER 2
 
+// Each worker thread remembers which pool it belongs to, so that tasks pushed from it stay on the same thread.
+static thread_local streamfx::util::threadpool* _local_pool   = nullptr;
+static thread_local std::size_t                 _local_index  = 0;
+static thread_local uint32_t                    _local_number = 0;
+
 streamfx::util::threadpool::threadpool()
-	: _workers(), _worker_stop(false), _worker_idx(0), _tasks(), _tasks_lock(), _tasks_cv()
+	: _workers(), _worker_stop(false), _worker_idx(0), _worker_next(0), _tasks_pending(0), _workers_idle(0),
+	  _idle_lock(), _idle_cv()
 {
 	std::size_t concurrency = static_cast<size_t>(std::thread::hardware_concurrency() * ST_CONCURRENCY_MULTIPLIER);
 	for (std::size_t n = 0; n < concurrency; n++) {
-		_workers.emplace_back(std::bind(&streamfx::util::threadpool::work, this));
+		_workers.emplace_back(std::make_unique<worker>());
+	}
+
+	// Only start the threads once all workers exist, as they will immediately try to steal from each other.
+	for (std::size_t n = 0; n < _workers.size(); n++) {
+		_workers[n]->thread = std::thread(std::bind(&streamfx::util::threadpool::work, this, n));
 	}
 }
 
 streamfx::util::threadpool::~threadpool()
 {
-	_worker_stop = true;
-	_tasks_cv.notify_all();
-	for (auto& thread : _workers) {
-		_tasks_cv.notify_all();
-		if (thread.joinable()) {
-			thread.join();
+	{
+		std::unique_lock<std::mutex> lock(_idle_lock);
+		_worker_stop = true;
+	}
+	_idle_cv.notify_all();
+	for (auto& worker : _workers) {
+		if (worker->thread.joinable()) {
+			worker->thread.join();
 		}
 	}
 }
 
-std::shared_ptr<::streamfx::util::threadpool::task> streamfx::util::threadpool::push(threadpool_callback_t fn,
-																					 threadpool_data_t     data)
+std::shared_ptr<::streamfx::util::threadpool::task>
+	streamfx::util::threadpool::push(threadpool_callback_t fn, threadpool_data_t data, threadpool_priority priority)
 {
-	auto task = std::make_shared<streamfx::util::threadpool::task>(fn, data);
-
-	// Append the task to the queue.
-	std::unique_lock<std::mutex> lock(_tasks_lock);
-	_tasks.emplace_back(task);
-	_tasks_cv.notify_one();
-
+	auto task       = std::make_shared<streamfx::util::threadpool::task>(fn, data);
+	task->_priority = priority;
+	enqueue(task);
 	return task;
 }
 
 void streamfx::util::threadpool::pop(std::shared_ptr<::streamfx::util::threadpool::task> work)
 {
 	if (work) {
+		std::vector<std::shared_ptr<streamfx::util::threadpool::task>> continuations;
 		{
 			std::unique_lock<std::mutex> lock(work->_mutex);
+			if (!work->_is_dead) { // A task that already completed stays completed.
+				work->_is_cancelled = true;
+			}
 			work->_is_dead = true;
+			continuations.swap(work->_continuations);
 		}
 		work->_is_complete.notify_all();
+
+		// Nothing that depends on this task may run anymore.
+		for (auto& continuation : continuations) {
+			pop(continuation);
+		}
 	}
 }
 
-void streamfx::util::threadpool::work()
+std::shared_ptr<::streamfx::util::threadpool::task>
+	streamfx::util::threadpool::then(std::shared_ptr<::streamfx::util::threadpool::task> parent,
+									 threadpool_callback_t fn, threadpool_data_t data, threadpool_priority priority)
 {
-	std::shared_ptr<streamfx::util::threadpool::task> local_work{};
-	uint32_t                                          local_number = _worker_idx.fetch_add(1);
+	auto task       = std::make_shared<streamfx::util::threadpool::task>(fn, data);
+	task->_priority = priority;
 
-	while (!_worker_stop) {
-		// Wait for more work, or immediately continue if there is still work to do.
+	// Defer the task until the parent completes, unless it already has or was cancelled.
+	if (parent) {
+		std::unique_lock<std::mutex> lock(parent->_mutex);
+		if (!parent->_is_dead) {
+			parent->_continuations.push_back(task);
+			return task;
+		} else if (parent->_is_cancelled) {
+			lock.unlock();
+			pop(task);
+			return task;
+		}
+	}
+
+	enqueue(task);
+	return task;
+}
+
+void streamfx::util::threadpool::parallel_for(std::size_t begin, std::size_t end, std::size_t grain,
+											  std::function<void(std::size_t, std::size_t)> function,
+											  threadpool_priority                           priority)
+{
+	if (begin >= end) {
+		return;
+	}
+
+	grain                  = std::max<std::size_t>(grain, 1);
+	std::size_t chunks     = (end - begin + grain - 1) / grain;
+	std::size_t helpers    = std::min(chunks - 1, _workers.size());
+	std::atomic<size_t> next{0};
+
+	// Every participant keeps claiming ranges until none are left, so only one task per helper is needed.
+	auto body = [&]() {
+		for (std::size_t chunk = next.fetch_add(1); chunk < chunks; chunk = next.fetch_add(1)) {
+			std::size_t chunk_begin = begin + chunk * grain;
+			function(chunk_begin, std::min(end, chunk_begin + grain));
+		}
+	};
+
+	group work(*this, priority);
+	for (std::size_t idx = 0; idx < helpers; idx++) {
+		work.run(body);
+	}
+	try {
+		body();
+	} catch (...) {
+		// Stop handing out ranges, but the helpers still reference our stack, so they must finish first.
+		next = chunks;
+		work.cancel();
+		work.wait();
+		throw;
+	}
+
+	// All ranges are claimed, so helpers that haven't started by now have nothing left to do. Only wait for the ones
+	// that are still working on a range, instead of for busy workers to get around to the rest.
+	work.cancel();
+	work.wait_all();
+}
+
+void streamfx::util::threadpool::enqueue(std::shared_ptr<::streamfx::util::threadpool::task> task)
+{
+	// Tasks pushed from one of our workers stay with it, everything else is spread across all workers.
+	std::size_t index = (_local_pool == this) ? _local_index : (_worker_next.fetch_add(1) % _workers.size());
+	{
+		auto&                        target = _workers[index];
+		std::unique_lock<std::mutex> lock(target->lock);
+		target->tasks[static_cast<size_t>(task->_priority)].emplace_back(task);
+	}
+
+	// Only wake a worker if one is actually sleeping, so pushing doesn't touch any shared lock while all are busy.
+	_tasks_pending.fetch_add(1);
+	if (_workers_idle.load() > 0) {
 		{
-			// Lock the tasks mutex to check for work.
-			std::unique_lock<std::mutex> lock(_tasks_lock);
+			std::unique_lock<std::mutex> lock(_idle_lock);
+		}
+		_idle_cv.notify_one();
+	}
+}
 
-			// If there are currently no tasks queued, wait on the condition variable.
-			// This temporarily unlocks the mutex until it is woken up.
-			if (_tasks.size() == 0) {
-				_tasks_cv.wait(lock, [this]() { return _worker_stop || _tasks.size() > 0; });
-			}
+std::shared_ptr<::streamfx::util::threadpool::task> streamfx::util::threadpool::find_work(std::size_t index)
+{
+	// Higher priorities always go first, even if that means stealing them from another worker.
+	for (std::size_t priority = 0; priority < priorities; priority++) {
+		for (std::size_t offset = 0; offset < _workers.size(); offset++) {
+			auto&                        victim = _workers[(index + offset) % _workers.size()];
+			std::unique_lock<std::mutex> lock(victim->lock);
 
-			// If there is either no tasks or we were asked to stop, skip everything.
-			if (_worker_stop || (_tasks.size() == 0)) {
+			auto& tasks = victim->tasks[priority];
+			if (tasks.empty()) {
 				continue;
 			}
 
-			// Grab the latest task and immediately remove it from the queue.
-			local_work = _tasks.front();
-			_tasks.pop_front();
+			// Our own queue is worked on in order, while thieves take from the other end to avoid contention.
+			std::shared_ptr<streamfx::util::threadpool::task> task;
+			if (offset == 0) {
+				task = tasks.front();
+				tasks.pop_front();
+			} else {
+				task = tasks.back();
+				tasks.pop_back();
+			}
+			_tasks_pending.fetch_sub(1);
+			return task;
 		}
+	}
+	return nullptr;
+}
 
-		// If the task was killed, skip everything again.
-		if (local_work->_is_dead.load()) {
-			continue;
+void streamfx::util::threadpool::execute(std::shared_ptr<::streamfx::util::threadpool::task> local_work)
+{
+	// If the task was killed, skip everything again.
+	if (local_work->_is_dead.load()) {
+		return;
+	}
+
+	// Try to execute work, but don't crash on catchable exceptions.
+	if (local_work->_callback) {
+		::streamfx::util::tracing::span trace("Task", "threadpool");
+		try {
+			local_work->_callback(local_work->_data);
+		} catch (std::exception const& ex) {
+			D_LOG_WARNING("Worker %" PRIx32 " caught exception from task (%" PRIxPTR ", %" PRIxPTR
+						  ") with message: %s",
+						  _local_number, reinterpret_cast<ptrdiff_t>(local_work->_callback.target<void>()),
+						  reinterpret_cast<ptrdiff_t>(local_work->_data.get()), ex.what());
+		} catch (...) {
+			D_LOG_WARNING("Worker %" PRIx32 " caught exception of unknown type from task (%" PRIxPTR ", %" PRIxPTR
+						  ").",
+						  _local_number, reinterpret_cast<ptrdiff_t>(local_work->_callback.target<void>()),
+						  reinterpret_cast<ptrdiff_t>(local_work->_data.get()));
 		}
+	}
 
-		// Try to execute work, but don't crash on catchable exceptions.
-		if (local_work->_callback) {
-			try {
-				local_work->_callback(local_work->_data);
-			} catch (std::exception const& ex) {
-				D_LOG_WARNING("Worker %" PRIx32 " caught exception from task (%" PRIxPTR ", %" PRIxPTR
-							  ") with message: %s",
-							  local_number, reinterpret_cast<ptrdiff_t>(local_work->_callback.target<void>()),
-							  reinterpret_cast<ptrdiff_t>(local_work->_data.get()), ex.what());
-			} catch (...) {
-				D_LOG_WARNING("Worker %" PRIx32 " caught exception of unknown type from task (%" PRIxPTR ", %" PRIxPTR
-							  ").",
-							  local_number, reinterpret_cast<ptrdiff_t>(local_work->_callback.target<void>()),
-							  reinterpret_cast<ptrdiff_t>(local_work->_data.get()));
-			}
+	std::vector<std::shared_ptr<streamfx::util::threadpool::task>> continuations;
+	{
+		std::unique_lock<std::mutex> lock(local_work->_mutex);
+		local_work->_is_dead.store(true);
+		continuations.swap(local_work->_continuations);
+	}
+	local_work->_is_complete.notify_all();
+
+	// Anything waiting on this task may run now.
+	for (auto& continuation : continuations) {
+		enqueue(continuation);
+	}
+}
+
+void streamfx::util::threadpool::work(std::size_t index)
+{
+	std::shared_ptr<streamfx::util::threadpool::task> local_work{};
+
+	_local_pool   = this;
+	_local_index  = index;
+	_local_number = _worker_idx.fetch_add(1);
+
+	while (!_worker_stop) {
+		// Grab the next task, either from our own queue or from another worker.
+		local_work = find_work(index);
+		if (!local_work) {
+			// Nothing to do anywhere, so wait until something is pushed.
+			_workers_idle.fetch_add(1);
 			{
-				std::unique_lock<std::mutex> lock(local_work->_mutex);
-				local_work->_is_dead.store(true);
+				std::unique_lock<std::mutex> lock(_idle_lock);
+				_idle_cv.wait(lock, [this]() { return _worker_stop || (_tasks_pending.load() > 0); });
 			}
-			local_work->_is_complete.notify_all();
+			_workers_idle.fetch_sub(1);
+			continue;
 		}
 
+		execute(local_work);
+
 		// Remove our reference to the work unit.
 		local_work.reset();
 	}
 
+	_local_pool = nullptr;
 	_worker_idx.fetch_sub(1);
 }
 
-streamfx::util::threadpool::task::task() {}
+streamfx::util::threadpool::task::task()
+	: _is_dead(false), _is_cancelled(false), _priority(threadpool_priority::NORMAL)
+{}
 
 streamfx::util::threadpool::task::task(threadpool_callback_t fn, threadpool_data_t dt)
-	: _mutex(), _is_complete(), _is_dead(false), _callback(fn), _data(dt)
+	: _mutex(), _is_complete(), _is_dead(false), _is_cancelled(false), _callback(fn), _data(dt),
+	  _priority(threadpool_priority::NORMAL), _continuations()
 {}
 
 void streamfx::util::threadpool::task::await_completion()
@@ -158,3 +304,100 @@ void streamfx::util::threadpool::task::await_completion()
 		_is_complete.wait(lock, [this]() { return this->_is_dead.load(); });
 	}
 }
+
+streamfx::util::threadpool::group::group(::streamfx::util::threadpool& pool, threadpool_priority priority)
+	: _pool(pool), _priority(priority), _pending(0), _mutex(), _is_complete(), _exception(), _queued()
+{}
+
+streamfx::util::threadpool::group::~group()
+{
+	// Functions may reference the stack of whoever created us, so never leave before they are done.
+	wait();
+}
+
+void streamfx::util::threadpool::group::run(std::function<void()> function)
+{
+	auto started = std::make_shared<std::atomic<bool>>(false);
+
+	_pending.fetch_add(1);
+	auto task = _pool.push(
+		[this, function, started](threadpool_data_t) {
+			// Cancelled functions were already accounted for, and the group may be gone by now.
+			if (started->exchange(true)) {
+				return;
+			}
+
+			try {
+				function();
+			} catch (...) {
+				std::unique_lock<std::mutex> lock(_mutex);
+				if (!_exception) {
+					_exception = std::current_exception();
+				}
+			}
+
+			// Notify while holding the lock, as the group may be destroyed the moment the waiter sees zero.
+			std::unique_lock<std::mutex> lock(_mutex);
+			if (_pending.fetch_sub(1) == 1) {
+				_is_complete.notify_all();
+			}
+		},
+		nullptr, _priority);
+
+	std::unique_lock<std::mutex> lock(_mutex);
+	_queued.emplace_back(task, started);
+}
+
+void streamfx::util::threadpool::group::cancel()
+{
+	std::vector<std::pair<std::shared_ptr<task>, std::shared_ptr<std::atomic<bool>>>> queued;
+	{
+		std::unique_lock<std::mutex> lock(_mutex);
+		queued.swap(_queued);
+	}
+
+	for (auto& [task, started] : queued) {
+		// Whoever flips the flag first decides whether the function runs or is cancelled.
+		if (started->exchange(true)) {
+			continue;
+		}
+
+		_pool.pop(task);
+
+		std::unique_lock<std::mutex> lock(_mutex);
+		if (_pending.fetch_sub(1) == 1) {
+			_is_complete.notify_all();
+		}
+	}
+}
+
+void streamfx::util::threadpool::group::wait_all()
+{
+	wait();
+
+	std::exception_ptr exception;
+	{
+		std::unique_lock<std::mutex> lock(_mutex);
+		std::swap(exception, _exception);
+	}
+	if (exception) {
+		std::rethrow_exception(exception);
+	}
+}
+
+void streamfx::util::threadpool::group::wait()
+{
+	// Blocking a worker on work that sits in the queues of the pool could dead-lock it, so help out instead.
+	if (_local_pool == &_pool) {
+		while (_pending.load() > 0) {
+			auto task = _pool.find_work(_local_index);
+			if (!task) {
+				break;
+			}
+			_pool.execute(task);
+		}
+	}
+
+	std::unique_lock<std::mutex> lock(_mutex);
+	_is_complete.wait(lock, [this]() { return _pending.load() == 0; });
+}
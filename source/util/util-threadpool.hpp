@@ -18,19 +18,28 @@
  */
 
 #pragma once
+#include <array>
 #include <atomic>
 #include <condition_variable>
+#include <deque>
+#include <exception>
 #include <functional>
-#include <list>
 #include <memory>
 #include <mutex>
 #include <stdexcept>
 #include <thread>
+#include <vector>
 
 namespace streamfx::util {
 	typedef std::shared_ptr<void>                  threadpool_data_t;
 	typedef std::function<void(threadpool_data_t)> threadpool_callback_t;
 
+	enum class threadpool_priority {
+		HIGH,   // Work that a frame or audio packet is waiting on.
+		NORMAL, // Everything else.
+		LOW,    // Background work that nothing is immediately waiting on.
+	};
+
 	class threadpool {
 		public:
 		class task {
@@ -38,8 +47,12 @@ namespace streamfx::util {
 			std::mutex              _mutex;
 			std::condition_variable _is_complete;
 			std::atomic<bool>       _is_dead;
+			std::atomic<bool>       _is_cancelled;
 			threadpool_callback_t   _callback;
 			threadpool_data_t       _data;
+			threadpool_priority     _priority;
+
+			std::vector<std::shared_ptr<::streamfx::util::threadpool::task>> _continuations;
 
 			public:
 			task();
@@ -50,24 +63,88 @@ namespace streamfx::util {
 			friend class streamfx::util::threadpool;
 		};
 
+		/** Fork/join helper: Tracks any number of functions run on the pool with a single counter.
+		 *
+		 * Waiting from a worker thread helps with other queued work instead of blocking, so groups may be nested.
+		 */
+		class group {
+			::streamfx::util::threadpool& _pool;
+			threadpool_priority           _priority;
+			std::atomic<std::size_t>      _pending;
+			std::mutex                    _mutex;
+			std::condition_variable       _is_complete;
+			std::exception_ptr            _exception;
+
+			// Queued functions, and whether they were started or cancelled already.
+			std::vector<std::pair<std::shared_ptr<task>, std::shared_ptr<std::atomic<bool>>>> _queued;
+
+			public:
+			group(::streamfx::util::threadpool& pool, threadpool_priority priority = threadpool_priority::NORMAL);
+			~group();
+
+			void run(std::function<void()> function);
+
+			/** Cancel all functions that have not started yet. Functions that already run are still waited for. */
+			void cancel();
+
+			/** Wait for all functions to finish, rethrowing the first exception any of them threw. */
+			void wait_all();
+
+			private:
+			void wait();
+
+			friend class streamfx::util::threadpool;
+		};
+
 		private:
-		std::list<std::thread>                                         _workers;
-		std::atomic<bool>                                              _worker_stop;
-		std::atomic<uint32_t>                                          _worker_idx;
-		std::list<std::shared_ptr<::streamfx::util::threadpool::task>> _tasks;
-		std::mutex                                                     _tasks_lock;
-		std::condition_variable                                        _tasks_cv;
+		static constexpr std::size_t priorities = static_cast<size_t>(threadpool_priority::LOW) + 1;
+
+		struct worker {
+			std::thread thread;
+			std::mutex  lock;
+			std::array<std::deque<std::shared_ptr<::streamfx::util::threadpool::task>>, priorities> tasks;
+		};
+
+		std::vector<std::unique_ptr<worker>> _workers;
+		std::atomic<bool>                    _worker_stop;
+		std::atomic<uint32_t>                _worker_idx;
+		std::atomic<std::size_t>             _worker_next;
+		std::atomic<std::size_t>             _tasks_pending;
+		std::atomic<std::size_t>             _workers_idle;
+		std::mutex                           _idle_lock;
+		std::condition_variable              _idle_cv;
 
 		public:
 		threadpool();
 		~threadpool();
 
-		std::shared_ptr<::streamfx::util::threadpool::task> push(threadpool_callback_t callback_function,
-																 threadpool_data_t     data);
+		std::shared_ptr<::streamfx::util::threadpool::task>
+			push(threadpool_callback_t callback_function, threadpool_data_t data,
+				 threadpool_priority priority = threadpool_priority::NORMAL);
 
 		void pop(std::shared_ptr<::streamfx::util::threadpool::task> work);
 
+		/** Queue a task to run once `parent` has completed. Cancelling the parent also cancels the task. */
+		std::shared_ptr<::streamfx::util::threadpool::task>
+			then(std::shared_ptr<::streamfx::util::threadpool::task> parent, threadpool_callback_t callback_function,
+				 threadpool_data_t data, threadpool_priority priority = threadpool_priority::NORMAL);
+
+		/** Call `function` for consecutive [begin, end) ranges of at most `grain` indices, in parallel.
+		 *
+		 * The calling thread works on the range too, and at most one task per worker is queued no matter how many
+		 * ranges there are. Returns once all ranges are done.
+		 */
+		void parallel_for(std::size_t begin, std::size_t end, std::size_t grain,
+						  std::function<void(std::size_t, std::size_t)> function,
+						  threadpool_priority                           priority = threadpool_priority::HIGH);
+
 		private:
-		void work();
+		void enqueue(std::shared_ptr<::streamfx::util::threadpool::task> task);
+
+		std::shared_ptr<::streamfx::util::threadpool::task> find_work(std::size_t index);
+
+		void execute(std::shared_ptr<::streamfx::util::threadpool::task> task);
+
+		void work(std::size_t index);
 	};
 } // namespace streamfx::util
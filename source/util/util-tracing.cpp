@@ -0,0 +1,236 @@
+// Copyright (c) 2021 Michael Fabian Dirks <info@xaymar.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "util-tracing.hpp"
+#include "common.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+// Number of spans kept per thread, older ones are overwritten.
+#define ST_TRACE_BUFFER_SIZE 8192
+
+namespace {
+	struct event {
+		const char* name;
+		const char* category;
+		int64_t     start;
+		int64_t     duration;
+		uint32_t    frame;
+	};
+
+	struct thread_buffer {
+		std::mutex         lock;
+		std::vector<event> events;
+		std::size_t        head;
+		uint32_t           id;
+		std::atomic<bool>  exited{false};
+	};
+
+	// Flags the buffer once its thread exits, so that the global list may let go of it.
+	struct thread_owner {
+		std::shared_ptr<thread_buffer> buffer;
+
+		~thread_owner()
+		{
+			if (buffer) {
+				buffer->exited.store(true);
+			}
+		}
+	};
+
+	struct state {
+		std::atomic<bool>                           enabled{false};
+		std::atomic<uint32_t>                       next_id{1};
+		std::chrono::steady_clock::time_point       epoch = std::chrono::steady_clock::now();
+		std::mutex                                  buffers_lock;
+		std::vector<std::shared_ptr<thread_buffer>> buffers;
+		std::mutex                                  names_lock;
+		std::set<std::string, std::less<>>          names;
+	};
+
+	state& get_state()
+	{
+		static state instance;
+		return instance;
+	}
+
+	int64_t now()
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now()
+																	 - get_state().epoch)
+			.count();
+	}
+
+	uint32_t current_frame()
+	{
+		if (video_t* video = obs_get_video(); video) {
+			return video_output_get_total_frames(video);
+		}
+		return 0;
+	}
+
+	thread_buffer& local_buffer()
+	{
+		// The buffer is shared with the global list, so that it survives the thread until it was dumped or reset.
+		thread_local thread_owner owner;
+		if (!owner.buffer) {
+			auto& st = get_state();
+
+			auto buffer  = std::make_shared<thread_buffer>();
+			buffer->head = 0;
+			buffer->id   = st.next_id.fetch_add(1);
+			buffer->events.resize(ST_TRACE_BUFFER_SIZE);
+
+			std::unique_lock<std::mutex> lock(st.buffers_lock);
+			st.buffers.push_back(buffer);
+			owner.buffer = buffer;
+		}
+		return *owner.buffer;
+	}
+
+	// Releases the buffers of threads that have exited. Requires buffers_lock to be held.
+	void trim_buffers(state& st)
+	{
+		st.buffers.erase(std::remove_if(st.buffers.begin(), st.buffers.end(),
+										[](std::shared_ptr<thread_buffer> const& buffer) {
+											return buffer->exited.load();
+										}),
+						 st.buffers.end());
+	}
+
+	void write_escaped(std::ofstream& stream, const char* text)
+	{
+		for (; text && *text; text++) {
+			if ((*text == '"') || (*text == '\\')) {
+				stream << '\\';
+			}
+			stream << *text;
+		}
+	}
+} // namespace
+
+void streamfx::util::tracing::enable(bool enabled)
+{
+	auto& st = get_state();
+	if (enabled) {
+		// Forget everything recorded so far, including the buffers of threads that are gone.
+		std::unique_lock<std::mutex> lock(st.buffers_lock);
+		trim_buffers(st);
+		for (auto& buffer : st.buffers) {
+			std::unique_lock<std::mutex> buffer_lock(buffer->lock);
+			buffer->head = 0;
+		}
+	}
+	st.enabled.store(enabled);
+}
+
+bool streamfx::util::tracing::enabled()
+{
+	return get_state().enabled.load(std::memory_order_relaxed);
+}
+
+const char* streamfx::util::tracing::intern(std::string_view text)
+{
+	auto& st = get_state();
+
+	// Nodes of a set never move, so the returned pointer stays valid as more names are added.
+	std::unique_lock<std::mutex> lock(st.names_lock);
+	auto                         kv = st.names.find(text);
+	if (kv == st.names.end()) {
+		kv = st.names.emplace(text).first;
+	}
+	return kv->c_str();
+}
+
+bool streamfx::util::tracing::dump(std::filesystem::path const& path)
+{
+	std::ofstream stream(path, std::ios::out | std::ios::trunc);
+	if (!stream.good()) {
+		return false;
+	}
+
+	auto& st = get_state();
+	stream << std::fixed << std::setprecision(3);
+	stream << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+
+	bool                         first = true;
+	std::vector<event>           events;
+	std::unique_lock<std::mutex> lock(st.buffers_lock);
+	for (auto& buffer : st.buffers) {
+		uint32_t id;
+		{ // Copy the buffer out, so the thread owning it isn't blocked while we write the file.
+			std::unique_lock<std::mutex> buffer_lock(buffer->lock);
+			std::size_t                  count = std::min<std::size_t>(buffer->head, buffer->events.size());
+			events.clear();
+			for (std::size_t idx = buffer->head - count; idx < buffer->head; idx++) {
+				events.push_back(buffer->events[idx % buffer->events.size()]);
+			}
+			id = buffer->id;
+		}
+
+		for (auto& ev : events) {
+			stream << (first ? "" : ",") << "\n{\"name\":\"";
+			write_escaped(stream, ev.name);
+			stream << "\",\"cat\":\"";
+			write_escaped(stream, ev.category);
+			stream << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << id << ",\"ts\":" << (double_t(ev.start) / 1000.)
+				   << ",\"dur\":" << (double_t(ev.duration) / 1000.) << ",\"args\":{\"frame\":" << ev.frame << "}}";
+			first = false;
+		}
+	}
+
+	// Threads that have exited won't record anything new, so their spans only had to be kept until now.
+	trim_buffers(st);
+	lock.unlock();
+
+	stream << "\n]}\n";
+	return stream.good();
+}
+
+streamfx::util::tracing::span::span(const char* name, const char* category)
+	: _name(name), _category(category), _start(-1), _frame(0)
+{
+	if (enabled()) {
+		_frame = current_frame();
+		_start = now();
+	}
+}
+
+streamfx::util::tracing::span::~span()
+{
+	if ((_start < 0) || !enabled()) {
+		return;
+	}
+
+	int64_t end    = now();
+	auto&   buffer = local_buffer();
+
+	std::unique_lock<std::mutex> lock(buffer.lock);
+	buffer.events[buffer.head % buffer.events.size()] = {_name, _category, _start, end - _start, _frame};
+	buffer.head++;
+}
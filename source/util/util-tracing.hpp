@@ -0,0 +1,62 @@
+// Copyright (c) 2021 Michael Fabian Dirks <info@xaymar.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+#include <cstdint>
+#include <filesystem>
+#include <string_view>
+
+namespace streamfx::util::tracing {
+	/** Start or stop recording spans. Starting discards anything recorded before. */
+	void enable(bool enabled);
+
+	bool enabled();
+
+	/** Return a copy of `text` that stays valid until the plugin is unloaded, for names built at runtime.
+	 *
+	 * Every distinct string is only stored once, so this must not be used with unbounded sets of names.
+	 */
+	const char* intern(std::string_view text);
+
+	/** Write all recorded spans as Chrome trace JSON, which chrome://tracing and Perfetto can open.
+	 *
+	 * Spans recorded by threads that have exited since are only written once, and released afterwards.
+	 */
+	bool dump(std::filesystem::path const& path);
+
+	/** Records the time between construction and destruction as a span on the current thread.
+	 *
+	 * `name` and `category` must outlive the recording, so use string literals or similarly long-lived strings. Spans
+	 * are stored in a fixed-size ring buffer per thread, so only the most recent ones are kept.
+	 */
+	class span {
+		const char* _name;
+		const char* _category;
+		int64_t     _start;
+		uint32_t    _frame;
+
+		public:
+		span(const char* name, const char* category = "streamfx");
+		~span();
+
+		span(const span&) = delete;
+		span& operator=(const span&) = delete;
+	};
+} // namespace streamfx::util::tracing
@@ -268,4 +268,45 @@ namespace streamfx::util {
 	}
 	void* malloc_aligned(std::size_t align, std::size_t size);
 	void  free_aligned(void* mem);
+
+	// Non-owning view of a contiguous range of elements, stand-in for std::span until C++20.
+	template<typename T>
+	class span {
+		T*          _data;
+		std::size_t _size;
+
+		public:
+		constexpr span() : _data(nullptr), _size(0) {}
+		constexpr span(T* data, std::size_t size) : _data(data), _size(size) {}
+
+		constexpr T* data() const
+		{
+			return _data;
+		}
+
+		constexpr std::size_t size() const
+		{
+			return _size;
+		}
+
+		constexpr bool empty() const
+		{
+			return _size == 0;
+		}
+
+		constexpr T& operator[](std::size_t idx) const
+		{
+			return _data[idx];
+		}
+
+		constexpr T* begin() const
+		{
+			return _data;
+		}
+
+		constexpr T* end() const
+		{
+			return _data + _size;
+		}
+	};
 } // namespace streamfx::util